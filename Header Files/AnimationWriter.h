@@ -0,0 +1,62 @@
+#ifndef COSIMULATION_ANIMATIONWRITER_H
+#define COSIMULATION_ANIMATIONWRITER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include <cstdint>
+#include <unordered_map>
+#include <ns3/node.h>
+#include <ns3/address.h>
+#include "Vehicle.h"
+
+/**
+ * Options of an animation trace.
+ * Start_Time: Simulation time in seconds the trace begins at.
+ * Stop_Time: Simulation time in seconds the trace ends at, zero for the end of the run.
+ * Interval: Simulated seconds between each position update.
+ * Radius: Only vehicles within this many metres of a vehicle negotiating a lane change are shown, zero for all.
+ * Record_Packets: Whether packets received by the applications are recorded.
+ * Record_Metadata: Whether the content of each packet is recorded along with it.
+ */
+struct AnimationOptions
+{
+    double Start_Time = 0;
+    double Stop_Time = 0;
+    double Interval = 1;
+    double Radius = 0;
+    bool Record_Packets = true;
+    bool Record_Metadata = false;
+};
+
+/**
+ * This class is responsible for writing an animation trace, in NetAnim's format, that remains usable for large runs.
+ * Unlike NS-3's AnimationInterface, which records every node upon every mobility update and every packet at the
+ * physical layer, positions are only written within a window of time at a fixed interval and optionally only for the
+ * vehicles near an active negotiation. Packets are recorded by the applications as they are received. Output is
+ * buffered and compressed with gzip if the file name ends with '.gz'.
+ */
+class AnimationWriter
+{
+    enum State {Hidden, Shown, Negotiating};
+    gzFile file = nullptr;
+    AnimationOptions options;
+    double next_update = 0;
+    std::vector<std::shared_ptr<Vehicle>> vehicles;
+    std::vector<State> states;
+    std::unordered_map<uint32_t, uint32_t> address_nodes;
+    bool IsRecording(double Time);
+public:
+    AnimationWriter() = default;
+    AnimationWriter(const AnimationWriter&) = delete;
+    AnimationWriter& operator=(const AnimationWriter&) = delete;
+    ~AnimationWriter();
+    bool Open(std::string URL, const AnimationOptions& Options, const std::vector<std::shared_ptr<Vehicle>>& Vehicles);
+    void Step(double Time);
+    void RecordPacket(const ns3::Address& From, ns3::Ptr<ns3::Node> Recipient, const std::string& Action,
+                      const std::string& Content);
+    void Close();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef COSIMULATION_CACHEDPROPAGATIONLOSSMODEL_H
+#define COSIMULATION_CACHEDPROPAGATIONLOSSMODEL_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <ns3/mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+
+/**
+ * This class is responsible for evaluating the log-distance propagation loss of the 802.11p channel in batches. The
+ * channel asks for the loss between the sender and each receiver in turn, so the first such request computes the loss
+ * to every known node in one pass over contiguous arrays of positions and the remainder are answered from that row.
+ * Positions are only read from a node's mobility model when it reports a change of course, which a vehicle's does at
+ * each step boundary as it is moved to its new waypoint, and the row is discarded whenever any position changes.
+ *
+ * The arithmetic is that of ns3::LogDistancePropagationLossModel, performed in the same order, and so the power
+ * received is identical to the stock model with the same exponent, reference distance and reference loss. This holds
+ * only while both are compiled with the same floating-point contraction: should one of them but not the other fuse
+ * dx * dx + dy * dy into a multiply-add, as GCC does by default when targeting FMA, the powers may differ in their last
+ * bits. CosimulationPropagationCheck compares the two directly, and the stock model may be selected within a run with
+ * the legacy-propagation option.
+ */
+class CachedLogDistancePropagationLossModel : public ns3::PropagationLossModel
+{
+    double exponent = 3.0;
+    double reference_distance = 1.0;
+    double reference_loss = 46.6777;
+    mutable std::unordered_map<const ns3::MobilityModel*, uint32_t> indices;
+    mutable std::vector<double> x;
+    mutable std::vector<double> y;
+    mutable std::vector<double> z;
+    mutable std::vector<double> losses;
+    mutable std::vector<const ns3::MobilityModel*> mobilities;
+    mutable std::vector<uint32_t> stale;
+    mutable int64_t row_sender = -1;
+    uint32_t GetIndex(ns3::Ptr<ns3::MobilityModel> Mobility) const;
+    void Refresh() const;
+    void ComputeRow(uint32_t Sender) const;
+    void CourseChanged(ns3::Ptr<const ns3::MobilityModel> Mobility);
+    double DoCalcRxPower(double Tx_Power_Dbm, ns3::Ptr<ns3::MobilityModel> A,
+                         ns3::Ptr<ns3::MobilityModel> B) const override;
+    int64_t DoAssignStreams(int64_t Stream) override;
+public:
+    static ns3::TypeId GetTypeId();
+    CachedLogDistancePropagationLossModel() = default;
+    ~CachedLogDistancePropagationLossModel() = default;
+    void SetPathLossExponent(double Exponent);
+    void SetReference(double Reference_Distance, double Reference_Loss);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef COSIMULATION_CHECKPOINT_H
+#define COSIMULATION_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Layout of a checkpoint file. The header is followed by the random state of the governor, the name of the SUMO
+ * state file and then one CheckpointVehicle per vehicle in the order their nodes were created. The identifiers of the
+ * vehicles rarely change during a run and so are written once to vehicles.txt within the checkpoint directory rather
+ * than to every checkpoint.
+ */
+struct CheckpointHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t Vehicle_Count;
+    double Time;
+    double Selection_Delay;
+    uint32_t Random_State_Length;
+    uint32_t SUMO_State_Length;
+};
+
+struct CheckpointVehicle
+{
+    float X;
+    float Y;
+    float Z;
+    int8_t Target_Lane;
+    int8_t Previous_Lane;
+    uint16_t Reserved;
+};
+
+/**
+ * This class is responsible for representing the state of the co-simulation at a step boundary so that a run may be
+ * resumed, or branched, from it later. The state of SUMO itself is saved by SUMO to the file named within. Events that
+ * are scheduled within NS-3, such as in flight negotiations, cannot be saved and so negotiations that are under way are
+ * issued again upon restoration.
+ */
+struct Checkpoint
+{
+    double Time = 0;
+    double Selection_Delay = 0;
+    std::string Random_State;
+    std::string SUMO_State_URL;
+    std::vector<std::string> Vehicle_IDs;
+    std::vector<CheckpointVehicle> Vehicles;
+    bool Write(std::string Directory, bool Write_Vehicle_IDs);
+    bool Read(std::string URL);
+    static std::string GetURL(std::string Directory, double Time, std::string Extension);
+};
+
+#endif
@@ -1,7 +1,6 @@
 #ifndef COSIMULATION_CONFIGURATION_H
 #define COSIMULATION_CONFIGURATION_H
 
-#include <bitset>
 #include <string>
 #include <vector>
 #include <ns3/core-module.h>
@@ -19,15 +18,61 @@ struct Configuration
     std::string Remote_Address = "";
     int Remote_Port = 1337;
     std::string Animation_URL = "";
-    std::bitset<5> Selection_Lanes;
+    std::vector<bool> Selection_Lanes;
     double Selection_Probability = 0.01;
     int Selection_Interval = 2;
     int Seed = 38203494;
-    std::vector<double> Lane_Speed_Limits = {26.82, 26.82, 26.82, 26.82, 26.82};
+    std::vector<double> Lane_Speed_Limits;
     std::string Lane_Change_Output;
     std::string Trip_Info_Output;
     bool Use_Enhanced = false;
+    std::string Profile_URL;
+    std::string Telemetry_Name;
+    std::string Trajectory_URL;
+    std::string Replay_URL;
+    std::string TraCI_Capture_URL;
+    std::string Variants_URL;
+    double Warmup_Time = 0;
+    std::string SUMO_Binary = "sumo";
+    std::string Checkpoint_Directory;
+    double Checkpoint_Interval = 300;
+    std::string Restore_URL;
+    double Road_Length = 2000;
+    double Halo_Width = 250;
+    bool Abstract_Network = false;
+    double Abstract_Range = 300;
+    double Abstract_Fade = 20;
+    double Abstract_Latency = 1;
+    double Abstract_Latency_Per_Metre = 0;
+    std::string Calibration_Output;
+    std::string Metrics_URL;
+    std::string Digest_URL;
+    double Animation_Start = 0;
+    double Animation_Stop = 0;
+    double Animation_Interval = 1;
+    double Animation_Radius = 0;
+    bool Animation_Packets = true;
+    bool Animation_Metadata = false;
+    bool Animation_Legacy = false;
+    bool Legacy_Selection = false;
+    unsigned int Step_Threads = 1;
+    std::string Memory_URL;
+    double Memory_Budget = 0;
+    bool Count_Allocations = false;
+    bool Legacy_Propagation = false;
+    std::string Packet_Trace_URL;
+    size_t Packet_Trace_Capacity = 1 << 20;
+    unsigned int Packet_Trace_Nodes = 1;
+    double Packet_Trace_Start = 0;
+    double Packet_Trace_Stop = 0;
+    bool Launch_SUMO = false;
+    std::vector<int> SUMO_CPUs;
+    bool Realtime = false;
+    std::string Deadline_URL;
+    unsigned int Degrade_Mobility = 0;
+    int Lane_Count = 0;
     Configuration(int argc, char** argv);
+    void Parse(const std::vector<std::string>& Arguments);
     ~Configuration() = default;
 private:
     ns3::CommandLine command_line;
@@ -44,6 +89,51 @@ private:
     bool SetLaneChangeOutput(std::string);
     bool SetTripInfoOutput(std::string);
     bool SetUseEnhanced(std::string);
+    bool SetProfile(std::string);
+    bool SetTelemetry(std::string);
+    bool SetRecordTrajectory(std::string);
+    bool SetReplayTrajectory(std::string);
+    bool SetTraCICapture(std::string);
+    bool SetVariants(std::string);
+    bool SetWarmup(std::string);
+    bool SetSUMOBinary(std::string);
+    bool SetCheckpoint(std::string);
+    bool SetCheckpointInterval(std::string);
+    bool SetRestore(std::string);
+    bool SetRoadLength(std::string);
+    bool SetHaloWidth(std::string);
+    bool SetAbstractNetwork(std::string);
+    bool SetAbstractRange(std::string);
+    bool SetAbstractFade(std::string);
+    bool SetAbstractLatency(std::string);
+    bool SetAbstractLatencyPerMetre(std::string);
+    bool SetCalibrationOutput(std::string);
+    bool SetMetrics(std::string);
+    bool SetDigest(std::string);
+    bool SetAnimationStart(std::string);
+    bool SetAnimationStop(std::string);
+    bool SetAnimationInterval(std::string);
+    bool SetAnimationRadius(std::string);
+    bool SetAnimationPackets(std::string);
+    bool SetAnimationMetadata(std::string);
+    bool SetAnimationLegacy(std::string);
+    bool SetLegacySelection(std::string);
+    bool SetStepThreads(std::string);
+    bool SetMemoryReport(std::string);
+    bool SetMemoryBudget(std::string);
+    bool SetCountAllocations(std::string);
+    bool SetLegacyPropagation(std::string);
+    bool SetPacketTrace(std::string);
+    bool SetPacketTraceCapacity(std::string);
+    bool SetPacketTraceNodes(std::string);
+    bool SetPacketTraceStart(std::string);
+    bool SetPacketTraceStop(std::string);
+    bool SetLaunchSUMO(std::string);
+    bool SetSUMOCPUs(std::string);
+    bool SetRealtime(std::string);
+    bool SetDeadlineReport(std::string);
+    bool SetDegradeMobility(std::string);
+    bool SetLaneCount(std::string);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef COSIMULATION_DEADLINEMONITOR_H
+#define COSIMULATION_DEADLINEMONITOR_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Profiler.h"
+
+/**
+ * This class is responsible for accounting for the deadline of each step when the co-simulation is driven against wall
+ * time. Each step is due at the wall time its simulation time falls upon, counted from the first step, and must finish
+ * before the next is due. The slack of a step is the time remaining before that deadline once the step has finished,
+ * which is negative should the deadline have been missed. Phases timed with a Profiler::Scope are attributed to the
+ * step that ends after them, so that the packets processed between two steps count against the later, and the phases
+ * of the step with the least slack are kept. A step is behind when it began more than a tenth of a step late or the
+ * step before it missed its deadline, see the degrade-mobility option. Deadlines are accounted for under the realtime
+ * option or whenever deadline-report names the CSV report, so that a run with the default simulator may be checked to
+ * keep up with wall time.
+ */
+class DeadlineMonitor
+{
+public:
+    typedef Profiler::Clock Clock;
+    static DeadlineMonitor& Instance();
+    void Enable(bool Enabled, double Step_Length);
+    bool IsEnabled() const { return this->enabled; }
+    void AddPhase(Profiler::Phase Phase_Type, Clock::duration Elapsed)
+    {
+        if(this->enabled)
+            this->step_phases[Phase_Type] += Elapsed;
+    }
+    void BeginStep(double Time);
+    void EndStep(bool Degraded);
+    bool IsBehind() const { return this->behind; }
+    bool Write(std::string URL);
+private:
+    bool enabled = false;
+    bool started = false;
+    bool behind = false;
+    Clock::duration step_length{};
+    Clock::time_point origin;
+    Clock::time_point deadline;
+    Clock::duration lateness{};
+    Clock::duration last_slack{};
+    std::vector<double> slacks_ms;
+    uint64_t misses = 0;
+    uint64_t degraded_steps = 0;
+    double worst_lateness_ms = 0;
+    double worst_time = 0;
+    double worst_slack_ms = 0;
+    double step_time = 0;
+    std::array<Clock::duration, Profiler::Phase_Count> step_phases{};
+    std::array<Clock::duration, Profiler::Phase_Count> worst_phases{};
+    DeadlineMonitor() = default;
+};
+
+#endif
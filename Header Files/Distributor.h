@@ -0,0 +1,65 @@
+#ifndef COSIMULATION_DISTRIBUTOR_H
+#define COSIMULATION_DISTRIBUTOR_H
+
+#ifdef COSIMULATION_MPI
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "Vehicle.h"
+#include "Governor.h"
+#include "TraCIClient.h"
+
+/**
+ * Layout of the attributes of a single vehicle as exchanged between processes at each step.
+ */
+struct DistributedAttributes
+{
+    uint32_t Index;
+    int32_t Lane_Index;
+    int32_t Lane_Count;
+    double X;
+    double Y;
+    double Speed;
+    double Length;
+    double Max_Speed;
+    double Acceleration;
+    double Deceleration;
+    double Max_Legal_Speed;
+};
+
+/**
+ * This class is responsible for keeping the processes of a distributed simulation in step with one another using MPI.
+ * Every process runs its own NS-3 simulation holding every vehicle, although each only simulates the vehicles within
+ * its own Partition of the road. The first process alone is connected to SUMO. At each step it executes the commands
+ * forwarded by the other processes and then scatters the attributes of every vehicle to them. As the processes only
+ * interact at step boundaries the length of a step is their lookahead.
+ *
+ * NS-3's own distributed simulator was not used as it requires the processes to be joined by point-to-point links and
+ * cannot carry a wireless channel, nor move a node, between them.
+ */
+class Distributor
+{
+    int rank = 0;
+    int size = 1;
+    std::vector<std::shared_ptr<Vehicle>> vehicle_table;
+    std::unordered_map<std::string, uint32_t> vehicle_indices;
+    std::vector<char> buffer;
+public:
+    Distributor();
+    ~Distributor() = default;
+    int GetRank();
+    int GetSize();
+    std::vector<std::string> BroadcastVehicleIDs(const std::vector<std::string>& Vehicle_IDs);
+    void SetVehicles(const std::vector<std::shared_ptr<Vehicle>>& Vehicles);
+    void ExchangeCommands(std::shared_ptr<TraCIClient> Client);
+    bool ExchangeAttributes(std::shared_ptr<TraCIClient> Client, bool Running, const std::vector<std::string>& ID_List,
+                            const Governor& Lanes);
+    static bool IsDistributed();
+};
+
+#endif
+
+#endif
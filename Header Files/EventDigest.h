@@ -0,0 +1,59 @@
+#ifndef COSIMULATION_EVENTDIGEST_H
+#define COSIMULATION_EVENTDIGEST_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+/**
+ * This class is responsible for recording a canonical digest of the events of a run, so that a build may be checked to
+ * produce the same experiment as the one before it. Each event is written as a line holding its time in microseconds,
+ * its name, the vehicle it concerns and two values whose meaning depends upon the event:
+ * selection: Lane the governor selected the vehicle to change to and zero.
+ * lane_change_mode: Mode set upon the vehicle as it entered the road and zero.
+ * request: Lane the vehicle requested information for and zero.
+ * packet_sent, packet_received: Context of the packet and zero.
+ * recommendation: One if the lane change was recommended otherwise zero, and the lane.
+ * lane_change: Lane the vehicle left and the lane it entered.
+ * arrival: Travel time of the vehicle in milliseconds and zero.
+ * The digest begins with the number of events and a hash of every line, so that identical digests may be recognised
+ * from their first lines alone. Events are only recorded when the digest option names the file to write.
+ */
+class EventDigest
+{
+public:
+    enum Event {Selection, Lane_Change_Mode, Request, Packet_Sent, Packet_Received, Recommendation, Lane_Change,
+                Arrival, Event_Count};
+    /**
+     * Totals of a digest used to compare digests that are not expected to be identical.
+     */
+    struct Summary
+    {
+        uint64_t Event_Total = 0;
+        uint64_t Hash = 0;
+        std::array<uint64_t, Event_Count> Counts{};
+        uint64_t Recommendations_Accepted = 0;
+        double Travel_Time_Sum_S = 0;
+    };
+    static EventDigest& Instance();
+    void Enable(bool Enabled);
+    bool IsEnabled() const { return this->enabled; }
+    void Record(Event Event_Type, int64_t Time_US, const std::string& Vehicle_ID, int64_t First = 0,
+                int64_t Second = 0)
+    {
+        if(this->enabled)
+            this->Append(Event_Type, Time_US, Vehicle_ID, First, Second);
+    }
+    bool Write(std::string URL);
+    static bool Summarise(std::string URL, Summary& Digest_Summary);
+    static const char* EventName(Event Event_Type);
+private:
+    bool enabled = false;
+    std::string events;
+    uint64_t event_total = 0;
+    uint64_t hash = 14695981039346656037ULL;
+    EventDigest() = default;
+    void Append(Event Event_Type, int64_t Time_US, const std::string& Vehicle_ID, int64_t First, int64_t Second);
+};
+
+#endif
@@ -6,9 +6,18 @@
 #include <string>
 #include "Vehicle.h"
 #include "Governor.h"
+#include "Telemetry.h"
+#include "Trajectory.h"
+#include "Checkpoint.h"
 #include "TraCIClient.h"
 #include "VehicleFactory.h"
 #include "Configuration.h"
+#include "SUMOProcess.h"
+#include "Distributor.h"
+#include "NetworkAbstraction.h"
+#include "AnimationWriter.h"
+#include "RoadNetwork.h"
+#include "VehicleApplication.h"
 
 /**
  * Experiment class will act as the entry point into the simulation. It will facilitate the initialisation,
@@ -19,14 +28,54 @@ class Experiment
     Governor governor;
     VehicleFactory factory;
     Configuration configuration;
+    Telemetry telemetry;
     std::shared_ptr<TraCIClient> client = std::make_shared<TraCIClient>();
     std::map<std::string, std::shared_ptr<Vehicle>> vehicles;
+    std::shared_ptr<TrajectoryRecorder> trajectory_recorder;
+    TrajectoryReader trajectory_reader;
+    std::vector<std::shared_ptr<Vehicle>> trajectory_vehicles;
+    SUMOProcess sumo;
+    RoadNetwork road_network;
+    std::string state_url;
+    std::vector<pid_t> replications;
+    double next_checkpoint = 0;
+    int exit_status = 0;
+    std::vector<std::shared_ptr<Vehicle>> checkpoint_vehicles;
+    std::shared_ptr<NetworkAbstraction> network_abstraction;
+    std::shared_ptr<AnimationWriter> animation_writer;
+    ns3::Ptr<VehicleApplication> (*create_protocol)() = nullptr;
+#ifdef COSIMULATION_MPI
+    std::shared_ptr<Distributor> distributor;
+    void InitialiseDistributed();
+    void DistributedStep();
+#endif
+    std::shared_ptr<Vehicle> AddVehicle(std::string ID);
+    ns3::Ptr<VehicleApplication> CreateApplication();
+    uint32_t GetSubscribedFields();
     void Initialise();
+    void InitialiseInstrumentation();
+    void PreRun(bool Install_Applications);
+    void ConnectSUMO(std::string Capture_URL);
+    std::vector<std::string> GetReloadArguments(bool Include_Outputs);
+    std::vector<std::string> GetSUMOArguments(bool Include_Outputs);
+    void SetLaneSpeedLimits();
+    int GetLaneCount();
+    void InitialiseGovernor();
+    void InitialiseReplications();
+    void InitialiseReplication(size_t Index, const std::vector<std::string>& Variant);
+    void WaitForReplications();
+    std::vector<std::shared_ptr<Vehicle>> GetVehiclesInCreationOrder();
+    void InitialiseRestore();
+    void WriteCheckpoint();
+    void InitialiseReplay();
+    void ReplayStep();
     void Step();
     void Run();
+    void SampleMemory();
 public:
     Experiment(int argc, char** argv);
     ~Experiment() = default;
+    int GetExitStatus() const;
 };
 
 #endif
\ No newline at end of file
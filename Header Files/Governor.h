@@ -5,31 +5,90 @@
 #include <memory>
 #include <string>
 #include <random>
-#include <bitset>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <ns3/nstime.h>
 #include "Vehicle.h"
+#include "Partition.h"
+#include "Trajectory.h"
+#include "WorkerPool.h"
 
 /**
  * This class will govern all vehicles within the simulation. This class will instruct vehicles at what time they are
  * to desire to change lane and which lane to change to. It is upon the vehicle and their application to actual
  * implement this change. Also each vehicle will step within this class.
+ *
+ * The vehicles that may be selected, those on the road within a selection lane without a target, are kept in a set per
+ * lane that is updated as each vehicle steps. Selection then skips directly from one selected candidate to the next so
+ * that its cost is proportional to the number selected rather than to the number of vehicles.
+ *
+ * Each step collects the results of SUMO serially, decodes them and plans the action of every vehicle in parallel upon
+ * a WorkerPool, and then applies those actions to NS-3 and SUMO serially in the order SUMO listed the vehicles.
  */
 class Governor
 {
     std::map<std::string, std::shared_ptr<Vehicle>> vehicles;
+    std::vector<std::shared_ptr<Vehicle>> vehicle_table;
+    std::unordered_map<std::string, uint32_t> vehicle_indices;
+    std::vector<uint64_t> present_steps;
+    std::vector<int> candidate_lanes;
+    std::vector<uint32_t> candidate_slots;
+    std::vector<std::vector<uint32_t>> lane_candidates;
+    uint64_t step_count = 0;
+    bool legacy_selection = false;
     std::shared_ptr<TraCIClient> client;
-    std::bitset<5> selection_lanes;
+    std::vector<bool> selection_lanes;
+    int lane_count;
+    std::unordered_map<std::string, int> edge_lane_counts;
     std::mt19937 random_generator;
     std::uniform_real_distribution<double> distribution = std::uniform_real_distribution<double>(0, 1);
     double selection_probability;
     int selection_interval;
+    uint64_t active_vehicles = 0;
+    uint64_t pending_negotiations = 0;
+    std::shared_ptr<TrajectoryRecorder> recorder;
+    ns3::Time next_selection;
+    std::shared_ptr<Partition> partition;
+    std::vector<std::string> step_id_list;
+    std::vector<uint32_t> step_indices;
+    std::vector<TraCIAPI::TraCIValues> step_results;
+    std::vector<Vehicle::StepAction> step_actions;
+    unsigned int step_threads = 1;
+    unsigned int mobility_stride = 1;
+    uint32_t subscribed_fields = VehicleAttributes::All_Fields;
+    std::vector<int> step_variables;
+    std::vector<int> departure_variables;
+    std::shared_ptr<WorkerPool> worker_pool;
     void SelectVehicles();
+    void SelectVehiclesLegacy();
+    void UpdateCandidate(uint32_t Index, bool Present);
+    void SetTarget(uint32_t Index);
+    void UpdateVariables();
+    bool IsSelectionLane(int Lane_Index);
 public:
     Governor(std::map<std::string, std::shared_ptr<Vehicle>> Vehicles, std::shared_ptr<TraCIClient> Client,
-             std::bitset<5> Selection_Lanes, double Selection_Probability, int Selection_Interval, int Seed);
+             std::vector<bool> Selection_Lanes, int Lane_Count, double Selection_Probability, int Selection_Interval,
+             int Seed);
     Governor() = default;
     ~Governor() = default;
     void Step();
     void ScheduleSelection();
+    void ScheduleSelection(ns3::Time Delay);
+    ns3::Time GetTimeUntilSelection();
+    std::string GetRandomState();
+    void SetRandomState(std::string State);
+    uint64_t GetActiveVehicles();
+    uint64_t GetPendingNegotiations();
+    void SetTrajectoryRecorder(std::shared_ptr<TrajectoryRecorder> Recorder);
+    void SetPartition(std::shared_ptr<Partition> Road_Partition);
+    void SetLegacySelection(bool Legacy_Selection);
+    void SetStepThreads(unsigned int Step_Threads);
+    void SetMobilityStride(unsigned int Stride);
+    void SetSubscribedFields(uint32_t Fields);
+    void SetEdgeLaneCounts(const std::unordered_map<std::string, int>& Edge_Lane_Counts);
+    const std::vector<std::string>& GetStepVehicleIDList();
+    int GetLaneCount(Vehicle& Subject) const;
 };
 
 #endif
\ No newline at end of file
@@ -1,19 +1,35 @@
 #ifndef COSIMULATION_ILACHAPPLICATION_H
 #define COSIMULATION_ILACHAPPLICATION_H
 
-#include "VehicleApplication.h"
+#include <string>
+#include "ProtocolApplication.h"
 
 /**
- * This class is responsible for implementing the ILACH protocol within this simulation. It shall utilise the
- * VehicleApplication as foundation.
+ * This struct is responsible for specialising the ProtocolApplication to the ILACH protocol. Vehicles request
+ * information from the target lane alone and, lacking the gap, either accelerate or wait for the partner to pass.
  */
-class ILACHApplication : public VehicleApplication
+struct ILACHPolicy
 {
-protected:
-    virtual void RunAlgorithm(int Lane_Index);
-    virtual void Receive(ns3::Ptr<ns3::Socket> Socket);
-public:
-    virtual void ChangeLane(int Lane_Index);
+    static const uint32_t Fields = VehicleAttributes::Field_Lane_Index;
+    static std::string Encode(int Lane_Index, int Current_Lane)
+    {
+        return std::to_string(Lane_Index);
+    }
+    static void Decode(const std::string& Content, int& Lane_Index, int& Current_Lane)
+    {
+        Lane_Index = std::stoi(Content);
+        Current_Lane = -1;
+    }
+    static bool IsRespondent(int Lane_Index, int Current_Lane, int Respondent_Lane)
+    {
+        return Respondent_Lane == Lane_Index;
+    }
+    static bool RequiresYield(const ResponseList& Responses, const VehicleAttributes& Attributes)
+    {
+        return false;
+    }
 };
 
-#endif
\ No newline at end of file
+typedef ProtocolApplication<ILACHPolicy> ILACHApplication;
+
+#endif
@@ -1,22 +1,39 @@
 #ifndef COSIMULATION_ILACHPLUSAPPLICATION_H
 #define COSIMULATION_ILACHPLUSAPPLICATION_H
 
-#include "VehicleApplication.h"
+#include <string>
+#include "ProtocolApplication.h"
 
 /**
- * This class is responsible for implementing the ILACHPlus protocol within this simulation. It shall utilise the
- * VehicleApplication as foundation.
+ * This struct is responsible for specialising the ProtocolApplication to the ILACHPlus protocol. Vehicles request
+ * information from both the target and current lane so that, when boxed in by their leader and follower, they may ask
+ * the partner to slow down for them.
  */
-class ILACHPlusApplication : public VehicleApplication
+struct ILACHPlusPolicy
 {
-private:
-    bool GetLeader(std::pair<ns3::Address, VehicleAttributes>& Leader);
-    bool GetFollower(std::pair<ns3::Address, VehicleAttributes>& Follower);
-protected:
-    virtual void RunAlgorithm(int Lane_Index);
-    virtual void Receive(ns3::Ptr<ns3::Socket> Socket);
-public:
-    virtual void ChangeLane(int Lane_Index);
+    static const uint32_t Fields = VehicleAttributes::Field_Position | VehicleAttributes::Field_Lane_Index |
+                                   VehicleAttributes::Field_Length;
+    static std::string Encode(int Lane_Index, int Current_Lane)
+    {
+        return std::to_string(Lane_Index) + "/" + std::to_string(Current_Lane);
+    }
+    static void Decode(const std::string& Content, int& Lane_Index, int& Current_Lane)
+    {
+        size_t separator = Content.find('/');
+        Lane_Index = std::stoi(Content.substr(0, separator));
+        Current_Lane = std::stoi(Content.substr(separator + 1));
+    }
+    static bool IsRespondent(int Lane_Index, int Current_Lane, int Respondent_Lane)
+    {
+        return Respondent_Lane == Lane_Index || Respondent_Lane == Current_Lane;
+    }
+    static bool RequiresYield(const ResponseList& Responses, const VehicleAttributes& Attributes);
+    static bool GetLeader(const ResponseList& Responses, const VehicleAttributes& Attributes,
+                          std::pair<ns3::Address, VehicleAttributes>& Leader);
+    static bool GetFollower(const ResponseList& Responses, const VehicleAttributes& Attributes,
+                            std::pair<ns3::Address, VehicleAttributes>& Follower);
 };
 
-#endif
\ No newline at end of file
+typedef ProtocolApplication<ILACHPlusPolicy> ILACHPlusApplication;
+
+#endif
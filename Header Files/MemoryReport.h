@@ -0,0 +1,68 @@
+#ifndef COSIMULATION_MEMORYREPORT_H
+#define COSIMULATION_MEMORYREPORT_H
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Profiler.h"
+
+/**
+ * This class is responsible for accounting for the memory used by the simulation. The resident set size is sampled at
+ * the boundaries of the run and its peak is taken from the kernel. The heap consumed by each component of a vehicle is
+ * measured as it is constructed, from the difference in bytes allocated from the heap before and after, so that the
+ * cost of a vehicle may be broken down. The waypoints queued upon each node and the responses held by each application
+ * change during the run and so are estimated from their number when the report is written. Optionally every allocation
+ * made through operator new is counted against the innermost Profiler phase it was made within, to show where the step
+ * loop churns the heap, which the count-allocations option turns on. Both require the memory-report option to name the
+ * CSV report written once the run has finished, without which the heap is never measured and operator new only checks
+ * a flag. Should memory-budget be set, the growth in resident memory per vehicle is checked against it.
+ */
+class MemoryReport
+{
+public:
+    enum Component {Node, Mobility, Devices, Internet_Stack, Addresses, Attributes, Vehicle_Object, Application,
+                    Component_Count};
+    enum Estimate {Waypoints, Responses, Estimate_Count};
+    /**
+     * Resident set size and heap in use at a named point of the run.
+     */
+    struct Sample
+    {
+        std::string Name;
+        double Time;
+        uint64_t Resident_Bytes;
+        uint64_t Heap_Bytes;
+        uint64_t Vehicles;
+    };
+    static MemoryReport& Instance();
+    void Enable(bool Enabled, bool Count_Allocations);
+    bool IsEnabled() const { return this->enabled; }
+    uint64_t Mark();
+    uint64_t Attribute(Component Component_Type, uint64_t Since);
+    void AddVehicle();
+    void TakeSample(std::string Name, double Time);
+    void SetEstimate(Estimate Estimate_Type, uint64_t Count, uint64_t Bytes_Each);
+    bool Report(std::string URL, double Budget);
+    static uint64_t GetResidentBytes();
+    static uint64_t GetPeakResidentBytes();
+    static uint64_t GetHeapBytes();
+    static void CountAllocation(size_t Size);
+    static uint64_t GetAllocationCount();
+private:
+    bool enabled = false;
+    uint64_t vehicles = 0;
+    std::vector<Sample> samples;
+    std::array<uint64_t, Component_Count> components{};
+    std::array<uint64_t, Estimate_Count> estimate_counts{};
+    std::array<uint64_t, Estimate_Count> estimate_bytes{};
+    static std::atomic<bool> counting;
+    static std::array<std::atomic<uint64_t>, Profiler::Phase_Count + 1> allocation_counts;
+    static std::array<std::atomic<uint64_t>, Profiler::Phase_Count + 1> allocation_bytes;
+    MemoryReport() = default;
+    static const char* ComponentName(Component Component_Type);
+    static const char* EstimateName(Estimate Estimate_Type);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef COSIMULATION_METRICS_H
+#define COSIMULATION_METRICS_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+/**
+ * Streaming histogram of non-negative values with a fixed number of log-linear buckets, each octave between 2^-10 and
+ * 2^30 being divided into thirty two. Percentiles are therefore accurate to within roughly 3% while the histogram
+ * occupies the same memory however many values are added to it, and histograms may be merged.
+ */
+struct Histogram
+{
+    static const int Octave_Minimum = -10;
+    static const int Octave_Count = 40;
+    static const int Sub_Buckets = 32;
+    static const int Bucket_Count = Octave_Count * Sub_Buckets + 2;
+    uint64_t Count = 0;
+    double Sum = 0;
+    double Minimum = 0;
+    double Maximum = 0;
+    std::array<uint64_t, Bucket_Count> Buckets{};
+    void Add(double Value);
+    void Merge(const Histogram& Other);
+    double GetPercentile(double Fraction) const;
+    static int GetBucket(double Value);
+    static double GetBucketValue(int Bucket);
+};
+
+/**
+ * Layout of the binary metrics file. The header is followed by Tally_Count tallies as uint64_t and then, for each of
+ * the Distribution_Count distributions, its MetricsDistribution immediately followed by Bucket_Count buckets as
+ * uint64_t. Tallies and distributions appear in the order of their enumerations within Metrics. The version changes
+ * whenever this layout or the meaning of the buckets does.
+ */
+struct MetricsHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t Tally_Count;
+    uint32_t Distribution_Count;
+    uint32_t Bucket_Count;
+};
+
+struct MetricsDistribution
+{
+    uint64_t Count;
+    double Sum;
+    double Minimum;
+    double Maximum;
+};
+
+/**
+ * This class is responsible for collecting the outcome of lane change negotiations and the travel time of each vehicle
+ * within the co-simulation itself, so that SUMO's lane change and trip info outputs may be switched off in performance
+ * runs. Values are aggregated into streaming histograms as they occur, should the metrics option name the summary
+ * written once the run has finished.
+ */
+class Metrics
+{
+public:
+    enum Tally {Negotiations_Started, Negotiations_Completed, Negotiations_Abandoned, Recommendations_Accepted,
+                Recommendations_Deferred, Retries, Trips_Completed, Tally_Count};
+    enum Distribution {Recommendation_Latency_MS, Completion_Time_S, Negotiation_Retries, Travel_Time_S,
+                       Distribution_Count};
+    static Metrics& Instance();
+    void Enable(bool Enabled);
+    bool IsEnabled() const { return this->enabled; }
+    void Increment(Tally Tally_Type)
+    {
+        if(this->enabled)
+            this->tallies[Tally_Type]++;
+    }
+    void Add(Distribution Distribution_Type, double Value)
+    {
+        if(this->enabled)
+            this->distributions[Distribution_Type].Add(Value);
+    }
+    void Write(std::string URL);
+    bool Read(std::string URL);
+    uint64_t GetTally(Tally Tally_Type) const { return this->tallies[Tally_Type]; }
+    const Histogram& GetDistribution(Distribution Distribution_Type) const
+    {
+        return this->distributions[Distribution_Type];
+    }
+    static const char* TallyName(Tally Tally_Type);
+    static const char* DistributionName(Distribution Distribution_Type);
+private:
+    bool enabled = false;
+    std::array<uint64_t, Tally_Count> tallies{};
+    std::array<Histogram, Distribution_Count> distributions;
+    Metrics() = default;
+};
+
+#endif
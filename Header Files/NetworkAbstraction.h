@@ -0,0 +1,65 @@
+#ifndef COSIMULATION_NETWORKABSTRACTION_H
+#define COSIMULATION_NETWORKABSTRACTION_H
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ns3/ptr.h>
+#include <ns3/node.h>
+#include <ns3/nstime.h>
+#include <ns3/address.h>
+
+class VehicleApplication;
+
+/**
+ * A vehicle that may be reached by another through the network abstraction.
+ */
+struct AbstractNeighbour
+{
+    ns3::Ptr<VehicleApplication> Application;
+    ns3::Address Neighbour_Address;
+    double Distance;
+};
+
+/**
+ * This class is responsible for standing in for the 802.11p network when exploring a scenario quickly. Rather than
+ * exchanging packets a vehicle requesting information gathers the attributes of its neighbours directly, each of which
+ * is heard with a probability that falls away with distance following a logistic curve and after a latency that grows
+ * linearly with distance. The probability and latency describe a complete Get/Response exchange and are also applied to
+ * single commands.
+ *
+ * When observing, the abstraction instead records the outcome of every exchange carried out over the full network so
+ * that its parameters may be fitted against it by the calibration tool.
+ */
+class NetworkAbstraction
+{
+    bool enabled;
+    double range;
+    double fade_width;
+    double latency_ms;
+    double latency_per_metre_ms;
+    std::mt19937 random_generator;
+    std::uniform_real_distribution<double> distribution = std::uniform_real_distribution<double>(0.0, 1.0);
+    std::vector<ns3::Ptr<VehicleApplication>> applications;
+    std::vector<ns3::Address> addresses;
+    std::map<ns3::Address, size_t> address_indices;
+    std::ofstream observations;
+public:
+    NetworkAbstraction(bool Enabled, double Range, double Fade_Width, double Latency, double Latency_Per_Metre,
+                       int Seed, std::string Calibration_URL);
+    ~NetworkAbstraction() = default;
+    bool IsEnabled();
+    bool IsObserving();
+    ns3::Address Register(ns3::Ptr<VehicleApplication> Application);
+    std::vector<AbstractNeighbour> GetNeighbours(ns3::Ptr<ns3::Node> Sender);
+    ns3::Ptr<VehicleApplication> GetApplication(const ns3::Address& Recipient);
+    double GetDistance(ns3::Ptr<ns3::Node> Sender, ns3::Ptr<ns3::Node> Recipient);
+    double GetDeliveryProbability(double Distance);
+    bool IsDelivered(double Distance);
+    ns3::Time GetLatency(double Distance);
+    void Observe(double Distance, bool Delivered, ns3::Time Latency);
+};
+
+#endif
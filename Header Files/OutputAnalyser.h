@@ -0,0 +1,53 @@
+#ifndef COSIMULATION_OUTPUTANALYSER_H
+#define COSIMULATION_OUTPUTANALYSER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Metrics.h"
+
+/**
+ * Set of names, such as lanes or lane change reasons, each given the index of its first appearance. Names are only
+ * copied upon their first appearance so that looking up a known name never allocates.
+ */
+struct NameTable
+{
+    std::vector<std::string> Names;
+    int Intern(const char* Name, size_t Length);
+};
+
+/**
+ * Aggregate statistics of one or more of SUMO's trip info and lane change outputs.
+ */
+struct OutputSummary
+{
+    uint64_t Files = 0;
+    uint64_t Trips = 0;
+    uint64_t Lane_Changes = 0;
+    Histogram Travel_Time;
+    Histogram Time_Loss;
+    Histogram Depart_Delay;
+    NameTable Lanes;
+    NameTable Reasons;
+    std::map<std::pair<int, int>, uint64_t> Lane_Pairs;
+    std::vector<uint64_t> Reason_Counts;
+    void Merge(const OutputSummary& Other);
+};
+
+/**
+ * This class is responsible for analysing the trip info and lane change outputs written by SUMO. Each file is memory
+ * mapped and scanned in a single pass for the elements and attributes of interest without building a document or
+ * allocating per element, which is considerably faster than parsing the files as XML. Any other file is recognised by
+ * its root element and ignored.
+ */
+class OutputAnalyser
+{
+public:
+    enum Output {Trip_Info, Lane_Change, Unknown};
+    static Output Analyse(std::string URL, OutputSummary& Summary);
+    static Output Scan(const char* Begin, const char* End, OutputSummary& Summary);
+    static double ParseDecimal(const char* Begin, const char* End);
+};
+
+#endif
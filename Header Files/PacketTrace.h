@@ -0,0 +1,87 @@
+#ifndef COSIMULATION_PACKETTRACE_H
+#define COSIMULATION_PACKETTRACE_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ns3/node.h>
+#include <ns3/net-device-container.h>
+
+/**
+ * A single packet seen at one of the points traced. Context is that of VehicleApplication for packets seen by the
+ * application and Unknown_Context for those seen beneath it, where the content of the packet is not read.
+ */
+struct PacketRecord
+{
+    int64_t Time_NS;
+    uint32_t Node;
+    uint16_t Size;
+    uint8_t Context;
+    uint8_t Outcome;
+};
+
+/**
+ * Layout of a packet trace file. The header is followed by Record_Count PacketRecords, oldest first. Overwritten holds
+ * the number of records that were lost to the ring buffer wrapping before the trace was written.
+ */
+struct PacketTraceHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t Record_Size;
+    uint64_t Record_Count;
+    uint64_t Overwritten;
+};
+
+/**
+ * This class is responsible for recording the packets sent and received by the vehicles, at the application and at the
+ * MAC and PHY of their WAVE devices, into a fixed size ring buffer of compact records. Once full the oldest records are
+ * overwritten, so the memory used is fixed however long the run. Only one in every Node_Stride nodes is traced, and
+ * only between the start and stop times, so that tracing is cheap enough to leave enabled within sweeps: the devices of
+ * nodes that are not sampled are never connected to. The buffer is written at the end of the run and, on demand, upon
+ * SIGUSR1 in which case the record being written at the moment of the signal may be incomplete.
+ */
+class PacketTrace
+{
+public:
+    enum Outcome : uint8_t {Application_Sent, Application_Received, MAC_Sent, MAC_Received, MAC_Dropped, PHY_Sent,
+                            PHY_Received, PHY_Dropped, Outcome_Count};
+    static const uint8_t Unknown_Context = 0xFF;
+    static PacketTrace& Instance();
+    void Enable(std::string URL, size_t Capacity, uint32_t Node_Stride, double Start, double Stop);
+    bool IsEnabled() const { return this->enabled; }
+    bool IsSampled(uint32_t Node) const { return this->enabled && Node % this->node_stride == 0; }
+    void Record(Outcome Point, int64_t Time_NS, uint32_t Node, uint8_t Context, size_t Size)
+    {
+        if(this->IsSampled(Node) && Time_NS >= this->start_ns && Time_NS < this->stop_ns)
+            this->Append(Point, Time_NS, Node, Context, Size);
+    }
+    void Attach(ns3::Ptr<ns3::Node> Node, const ns3::NetDeviceContainer& Devices);
+    bool Write();
+    static bool Read(std::string URL, std::vector<PacketRecord>& Records, uint64_t& Overwritten);
+    static const char* OutcomeName(Outcome Point);
+private:
+    bool enabled = false;
+    uint32_t node_stride = 1;
+    int64_t start_ns = 0;
+    int64_t stop_ns = INT64_MAX;
+    std::vector<PacketRecord> records;
+    uint64_t mask = 0;
+    std::atomic<uint64_t> next{0};
+    char url[4096] = {};
+    PacketTrace() = default;
+    void Append(Outcome Point, int64_t Time_NS, uint32_t Node, uint8_t Context, size_t Size)
+    {
+        uint64_t index = this->next.fetch_add(1, std::memory_order_relaxed);
+        PacketRecord& record = this->records[index & this->mask];
+        record.Time_NS = Time_NS;
+        record.Node = Node;
+        record.Size = (uint16_t)(Size < UINT16_MAX ? Size : UINT16_MAX);
+        record.Context = Context;
+        record.Outcome = Point;
+    }
+    static void Dump(int Signal);
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef COSIMULATION_PARTITION_H
+#define COSIMULATION_PARTITION_H
+
+/**
+ * This class is responsible for dividing the road into longitudinal segments, one per process taking part in a
+ * distributed simulation. Each process owns the vehicles within its segment, meaning that only it may begin
+ * negotiations on their behalf, while vehicles within radio range of the segment (its halo) are also simulated so that
+ * they may respond to those negotiations. The halo should be wider than the radio range plus the distance a vehicle can
+ * travel within a single step, as processes only exchange state at step boundaries.
+ */
+class Partition
+{
+    int rank;
+    int size;
+    double segment_length;
+    double halo_width;
+public:
+    Partition(int Rank, int Size, double Road_Length, double Halo_Width);
+    ~Partition() = default;
+    int GetOwner(double X);
+    bool Owns(double X);
+    bool IsVisible(double X);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef COSIMULATION_PROFILER_H
+#define COSIMULATION_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * This class is responsible for instrumenting the simulation so that it can be determined where a run spends its time.
+ * Phases of the step loop are timed with a Profiler::Scope and events of interest are tallied with Increment. The
+ * instrumentation is always compiled in however nothing is recorded unless the profile option names the report of
+ * per-phase totals, step time percentiles and counters written once the run has finished. Phases are still timed for
+ * the DeadlineMonitor when it is enabled.
+ * Phases may nest within one another (SUMO stepping happens inside Governor::Step) therefore totals are inclusive.
+ */
+class Profiler
+{
+public:
+    enum Phase {SUMO_Step, Subscription_Decode, Governor_Step, Mobility_Update, Select_Vehicles, Packet_Processing,
+                Run_Algorithm, Phase_Count};
+    enum Counter {TraCI_Simulation_Step, TraCI_Get_ID_List, TraCI_Get_Min_Expected_Number, TraCI_Get_Current_Time,
+                  TraCI_Subscribe, TraCI_Slow_Down, TraCI_Change_Lane, TraCI_Set_Lane_Change_Mode,
+                  TraCI_Set_Lane_Speed_Limit, TraCI_Load, Get_Sent, Get_Received, Response_Sent, Response_Received,
+                  Command_Sent, Command_Received, Recommendation_Issued, Recommendation_Deferred,
+                  Negotiation_Timers_Removed, Counter_Count};
+    typedef std::chrono::steady_clock Clock;
+    /**
+     * Time the enclosing block and attribute the elapsed time to the given phase once the block has been left. The
+     * innermost phase of each thread is tracked whether or not the profiler is enabled, see MemoryReport.
+     */
+    class Scope
+    {
+        Phase phase;
+        Phase previous;
+        bool active;
+        Clock::time_point start;
+    public:
+        explicit Scope(Phase Phase_Type);
+        ~Scope();
+    };
+    static Profiler& Instance();
+    void Enable(bool Enabled);
+    bool IsEnabled() const { return this->enabled; }
+    void Increment(Counter Counter_Type, uint64_t Amount = 1)
+    {
+        if(this->enabled)
+            this->counters[Counter_Type] += Amount;
+    }
+    void Record(Phase Phase_Type, Clock::duration Elapsed);
+    void MarkStep();
+    void Report(std::string URL);
+    static Phase GetCurrentPhase();
+    static const char* PhaseName(Phase Phase_Type);
+private:
+    bool enabled = false;
+    std::array<uint64_t, Counter_Count> counters{};
+    std::array<uint64_t, Phase_Count> phase_calls{};
+    std::array<Clock::duration, Phase_Count> phase_totals{};
+    std::vector<double> step_times;
+    Clock::time_point run_start;
+    Clock::time_point last_step;
+    Profiler() = default;
+    static const char* CounterName(Counter Counter_Type);
+};
+
+#endif
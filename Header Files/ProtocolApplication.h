@@ -0,0 +1,202 @@
+#ifndef COSIMULATION_PROTOCOLAPPLICATION_H
+#define COSIMULATION_PROTOCOLAPPLICATION_H
+
+#include <cmath>
+#include <ns3/simulator.h>
+#include "Profiler.h"
+#include "VehicleApplication.h"
+
+/**
+ * This class is responsible for implementing a lane change protocol upon the VehicleApplication, with the parts in
+ * which the protocols differ supplied at compile time by a policy. The request, gap computation and recommendation are
+ * shared by every protocol. As each override is final, calls made between them within the application are bound
+ * statically and the policy, being a set of static functions, is inlined into them. A policy must provide:
+ * Encode(Lane_Index, Current_Lane): Content of the request for information sent by a vehicle within Current_Lane.
+ * Decode(Content, Lane_Index, Current_Lane): Recover the lanes from the content of a request.
+ * IsRespondent(Lane_Index, Current_Lane, Respondent_Lane): Whether a vehicle within Respondent_Lane responds.
+ * RequiresYield(Responses, Attributes): Whether, lacking the gap, the partner should be asked to slow down instead.
+ * Fields: The fields of VehicleAttributes read by the functions of the policy.
+ */
+template<typename Policy>
+class ProtocolApplication : public VehicleApplication
+{
+    void AccelerateOrWait(int Lane_Index, double D_Switch, double D_Gap, const VehicleAttributes& Partner_Attributes);
+protected:
+    void RunAlgorithm(int Lane_Index) final;
+    void Receive(ns3::Ptr<ns3::Socket> Socket) final;
+    void Handle(Context Action, const std::string& Content, ns3::Address From) final;
+    bool IsRespondent(int Lane_Index, const VehicleAttributes& Attributes) final;
+public:
+    void ChangeLane(int Lane_Index) final;
+    // The fields of VehicleAttributes read by the protocol, of this vehicle and of those responding to it.
+    static const uint32_t Fields = VehicleAttributes::Field_Speed | VehicleAttributes::Field_Position |
+                                   VehicleAttributes::Field_Lane_Index | VehicleAttributes::Field_Length |
+                                   VehicleAttributes::Field_Acceleration | Policy::Fields;
+};
+
+/**
+ * Coordinate the lane change with the partner in the desired lane, if one responded to the request for information.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ */
+template<typename Policy>
+void ProtocolApplication<Policy>::RunAlgorithm(int Lane_Index)
+{
+    Profiler::Scope scope(Profiler::Run_Algorithm);
+    std::pair<ns3::Address, VehicleAttributes> partner;
+    bool has_partner = this->GetPartner(partner);
+    if(has_partner)
+    {
+        VehicleAttributes vi_attributes = *this->GetVehicleAttributes();
+        VehicleAttributes vj_attributes = partner.second;
+        libsumo::TraCIPosition position = vi_attributes.Position;
+        libsumo::TraCIPosition partner_position = vj_attributes.Position;
+        double n_loc = position.x + 50.0;
+        double d_switch = n_loc - position.x;
+        double t_switch = d_switch / vi_attributes.Speed;
+        double d_gab = fabs(n_loc - partner_position.x);
+        // Does the vehicle have the speed required to reach it intended location in the target lane at current speed.
+        if((d_gab / t_switch) < vj_attributes.Speed)
+        {
+            // Vehicle can be recommended to change lane.
+            if(this->IsPresent())
+                this->GetVehicle()->RecommendLaneChange(true, Lane_Index, this->GetClient());
+        }
+        else if(Policy::RequiresYield(this->GetResponses(), vi_attributes))
+        {
+            // The vehicle has no room to move, therefore lets ask our partner to move for us.
+            size_t slot;
+            this->BeginMessage(slot).assign("Slow_Down");
+            this->ScheduleMessage(this->GetTransmissionDelay(), Command, slot, partner.first);
+            this->GetVehicle()->DeferLaneChange(ns3::Seconds(4), Lane_Index, this->GetClient());
+        }
+        else
+        {
+            this->AccelerateOrWait(Lane_Index, d_switch, d_gab, vj_attributes);
+        }
+    }
+    else
+    {
+        // Since there is no partner in the target lane the vehicle may change when ready.
+        if(this->IsPresent())
+            this->GetVehicle()->RecommendLaneChange(true, Lane_Index, this->GetClient());
+    }
+}
+
+/**
+ * Recommend the lane change if the vehicle is capable of accelerating to create an adequate gap ahead of its partner,
+ * otherwise slow the vehicle so that it may retry once the partner has passed.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ * @param D_Switch Distance the vehicle travels while switching lane.
+ * @param D_Gap Distance between the partner and the intended location of the vehicle within the target lane.
+ * @param Partner_Attributes Attributes of the partner.
+ */
+template<typename Policy>
+void ProtocolApplication<Policy>::AccelerateOrWait(int Lane_Index, double D_Switch, double D_Gap,
+                                                   const VehicleAttributes& Partner_Attributes)
+{
+    double t_gab = D_Gap / Partner_Attributes.Speed;
+    double t_switch_2 = sqrt(D_Switch / this->GetVehicleAttributes()->Acceleration);
+    if(t_switch_2 < t_gab)
+    {
+        // Vehicle may change lane as it is capable of accelerating to create gap.
+        if(this->IsPresent())
+        {
+            this->GetClient()->SlowDown(this->GetVehicleID(), this->GetVehicleAttributes()->Speed + 6.00, 8000);
+            this->GetVehicle()->RecommendLaneChange(true, Lane_Index, this->GetClient());
+        }
+    }
+    else
+    {
+        // Vehicle should wait until the partner has passed and retry. No recommendation can be given.
+        if(this->IsPresent())
+        {
+            this->GetClient()->SlowDown(this->GetVehicleID(),
+                                        this->GetVehicleAttributes()->Speed / (2.0 / 3.0), 8000);
+            this->GetVehicle()->RecommendLaneChange(false, Lane_Index, this->GetClient());
+        }
+    }
+}
+
+/**
+ * Handle every packet waiting upon the socket, binding each to this protocol's Handle directly. The content of each is
+ * read into the buffer kept by the application.
+ * @param Socket The socket which was targeted by the sender.
+ */
+template<typename Policy>
+void ProtocolApplication<Policy>::Receive(ns3::Ptr<ns3::Socket> Socket)
+{
+    Profiler::Scope scope(Profiler::Packet_Processing);
+    Context action;
+    std::string& content = this->GetReceiveContent();
+    ns3::Address from;
+    while(this->ReadNext(Socket, action, content, from))
+        this->Handle(action, content, from);
+}
+
+/**
+ * Respond to requests for information the vehicle can assist with, collect responses to its own requests and slow down
+ * when commanded to.
+ * @param Action The action this vehicle must carryout.
+ * @param Content Content of the packet.
+ * @param From Address of the sender.
+ */
+template<typename Policy>
+void ProtocolApplication<Policy>::Handle(Context Action, const std::string& Content, ns3::Address From)
+{
+    if(Action == Get)
+    {
+        int lane_index;
+        int current_lane;
+        Policy::Decode(Content, lane_index, current_lane);
+        if(Policy::IsRespondent(lane_index, current_lane, this->GetVehicleAttributes()->Lane_Index))
+        {
+            // The attributes are serialised as the request is received, into a buffer kept by the application.
+            size_t slot;
+            VehicleAttributes::Serialise(*this->GetVehicleAttributes(), this->BeginMessage(slot));
+            this->ScheduleMessage(this->GetTransmissionDelay(), Response, slot, From);
+        }
+    }
+    else if(Action == Response)
+    {
+        this->AddResponse(From, VehicleAttributes::Deserialise(Content));
+    }
+    else if(Action == Command)
+    {
+        if(Content.compare(0, 9, "Slow_Down") == 0)
+        {
+            if(this->IsPresent())
+            {
+                this->GetClient()->SlowDown(this->GetVehicleID(),
+                                            this->GetVehicleAttributes()->Speed / (2.0 / 3.0), 8000);
+            }
+        }
+    }
+}
+
+/**
+ * Determine if a vehicle would respond to a request for information made by this vehicle.
+ * @param Lane_Index Index of the lane this vehicle desires to change to.
+ * @param Attributes Attributes of the vehicle receiving the request.
+ * @return True if the vehicle would respond.
+ */
+template<typename Policy>
+bool ProtocolApplication<Policy>::IsRespondent(int Lane_Index, const VehicleAttributes& Attributes)
+{
+    return Policy::IsRespondent(Lane_Index, this->GetVehicleAttributes()->Lane_Index, Attributes.Lane_Index);
+}
+
+/**
+ * Request information from the vehicles that may be of assistance in changing to the desired lane.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ */
+template<typename Policy>
+void ProtocolApplication<Policy>::ChangeLane(int Lane_Index)
+{
+    this->GetResponses().clear();
+    if(this->IsPresent())
+    {
+        this->Request(Policy::Encode(Lane_Index, this->GetVehicleAttributes()->Lane_Index), Lane_Index);
+    }
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef COSIMULATION_QUEUEDEPTHSCHEDULER_H
+#define COSIMULATION_QUEUEDEPTHSCHEDULER_H
+
+#include <cstdint>
+#include <ns3/map-scheduler.h>
+
+/**
+ * This class is responsible for keeping count of the number of events pending within the NS-3 event queue. It behaves
+ * exactly as the default MapScheduler however each insertion and removal is tallied so that the depth of the queue can
+ * be published by the Telemetry without walking the queue.
+ */
+class QueueDepthScheduler : public ns3::MapScheduler
+{
+    static uint64_t depth;
+public:
+    static ns3::TypeId GetTypeId();
+    QueueDepthScheduler() = default;
+    ~QueueDepthScheduler() = default;
+    virtual void Insert(const ns3::Scheduler::Event& Event);
+    virtual ns3::Scheduler::Event RemoveNext();
+    virtual void Remove(const ns3::Scheduler::Event& Event);
+    static uint64_t GetDepth();
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef COSIMULATION_ROADNETWORK_H
+#define COSIMULATION_ROADNETWORK_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * A lane of the road network as described by the SUMO network file.
+ */
+struct RoadLane
+{
+    std::string ID;
+    std::string Edge_ID;
+    int Index;
+    double Speed;
+    double Length;
+};
+
+/**
+ * This class is responsible for describing the lanes of the road network the simulation is run upon, read once from the
+ * SUMO network file at startup. Only the edges vehicles drive upon are kept, the internal edges within junctions are
+ * skipped, so that any number of edges each with any number of lanes may be simulated.
+ */
+class RoadNetwork
+{
+    std::vector<RoadLane> lanes;
+    int lane_count = 0;
+    std::unordered_map<std::string, int> edge_lane_counts;
+public:
+    RoadNetwork() = default;
+    ~RoadNetwork() = default;
+    bool Read(std::string URL);
+    const std::vector<RoadLane>& GetLanes() const;
+    int GetLaneCount() const;
+    const std::unordered_map<std::string, int>& GetEdgeLaneCounts() const;
+    static std::string FindNetwork(std::string SUMO_URL);
+};
+
+#endif
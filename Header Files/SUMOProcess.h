@@ -0,0 +1,40 @@
+#ifndef COSIMULATION_SUMOPROCESS_H
+#define COSIMULATION_SUMOPROCESS_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+/**
+ * This class is responsible for launching a SUMO instance as a child process, listening upon a free port, and waiting
+ * for it to become ready to accept a TraCI connection. The instance may be pinned to a set of CPUs so that it does not
+ * compete with NS-3 for them. Should SUMO exit unexpectedly, the manner in which it did so can be described in place of
+ * the bare socket error seen by the client. The static functions are shared with the sweep driver which manages many
+ * such instances at once.
+ */
+class SUMOProcess
+{
+    pid_t process_id = -1;
+    int port = 0;
+    int exit_status = -1;
+    std::string log_url;
+public:
+    SUMOProcess() = default;
+    SUMOProcess(const SUMOProcess&) = delete;
+    SUMOProcess& operator=(const SUMOProcess&) = delete;
+    ~SUMOProcess();
+    bool Start(std::string Binary, const std::vector<std::string>& Arguments, std::string Log_URL,
+               const std::vector<int>& CPUs = std::vector<int>());
+    int GetPort();
+    bool IsRunning();
+    std::string DescribeExit();
+    int Wait();
+    void Terminate();
+    static pid_t Spawn(const std::vector<std::string>& Arguments, std::string Log_URL,
+                       const std::vector<int>& CPUs = std::vector<int>());
+    static bool SetAffinity(const std::vector<int>& CPUs, bool Exclude);
+    static int AllocatePort();
+    static bool IsListening(int Port);
+};
+
+#endif
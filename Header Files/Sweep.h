@@ -0,0 +1,64 @@
+#ifndef COSIMULATION_SWEEP_H
+#define COSIMULATION_SWEEP_H
+
+#include <set>
+#include <string>
+#include <vector>
+#include <utility>
+#include <sys/types.h>
+
+/**
+ * A single point within the grid of a sweep along with the processes currently executing it.
+ */
+struct SweepRun
+{
+    enum State {Pending, Running, Done, Failed};
+    size_t Index = 0;
+    std::vector<std::pair<std::string, std::string>> Parameters;
+    std::string Directory;
+    State Status = Pending;
+    int Port = 0;
+    pid_t SUMO_PID = -1;
+    pid_t Cosimulation_PID = -1;
+    int Cosimulation_Status = -1;
+};
+
+/**
+ * This class is responsible for executing every combination of a grid of configuration values. Each combination is run
+ * as a pair of processes, a SUMO instance listening upon a free port and a Cosimulation connected to it, with up to the
+ * given number of pairs running at once. As TraCI is strictly request and response each pair keeps roughly one core
+ * busy. The outputs of every run are written to its own directory within the results directory alongside an index of
+ * all runs. A run is marked as done once it completes so that an interrupted sweep may be resumed by running it again.
+ *
+ * The grid is specified as one parameter per line in the form "name = value | value | ...", where each name is an
+ * option of Cosimulation (such as seed or speed-limits) and every value is tried in combination with every other.
+ * Blank lines and lines beginning with '#' are ignored. The sumo-url and step-length parameters are also passed on to
+ * SUMO. Each run may also record an event digest, see CosimulationDigest.
+ */
+class Sweep
+{
+    std::vector<std::pair<std::string, std::vector<std::string>>> grid;
+    std::vector<SweepRun> runs;
+    std::set<int> ports;
+    std::string results_url;
+    std::string sumo_binary;
+    std::string cosimulation_binary;
+    unsigned int jobs;
+    bool digest = false;
+    void Expand();
+    void Start(SweepRun& Run);
+    void Reap(pid_t Process_ID, int Status);
+    void Complete(SweepRun& Run);
+    void Terminate();
+    void WriteIndex();
+    std::string GetParameter(const SweepRun& Run, std::string Name);
+    int AllocatePort();
+    bool WaitForListener(pid_t Process_ID, int Port);
+public:
+    Sweep(std::string Results_URL, std::string SUMO_Binary, std::string Cosimulation_Binary, unsigned int Jobs);
+    bool Load(std::string Grid_URL);
+    void SetDigest(bool Digest);
+    int Run();
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef COSIMULATION_TELEMETRY_H
+#define COSIMULATION_TELEMETRY_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+/**
+ * This struct represents the block of live statistics published by a running simulation. The block lives within a POSIX
+ * shared memory segment so that a monitor may attach to it at any time. Writes are guarded by a sequence counter
+ * (odd while the block is being written) so that a reader can take a consistent snapshot without any locking.
+ */
+struct TelemetryBlock
+{
+    static const uint32_t Magic_Number = 0x434f5349;
+    std::atomic<uint32_t> Magic;
+    std::atomic<uint32_t> Finished;
+    std::atomic<uint64_t> Sequence;
+    std::atomic<int64_t> Process_ID;
+    std::atomic<uint64_t> Steps;
+    std::atomic<double> Simulated_Time;
+    std::atomic<double> Steps_Per_Second;
+    std::atomic<uint64_t> Active_Vehicles;
+    std::atomic<uint64_t> Pending_Negotiations;
+    std::atomic<uint64_t> Queue_Depth;
+    std::atomic<uint64_t> Resident_Set_Bytes;
+};
+
+/**
+ * A consistent copy of a TelemetryBlock taken by a reader.
+ */
+struct TelemetrySnapshot
+{
+    bool Finished = false;
+    int64_t Process_ID = 0;
+    uint64_t Steps = 0;
+    double Simulated_Time = 0;
+    double Steps_Per_Second = 0;
+    uint64_t Active_Vehicles = 0;
+    uint64_t Pending_Negotiations = 0;
+    uint64_t Queue_Depth = 0;
+    uint64_t Resident_Set_Bytes = 0;
+};
+
+/**
+ * This class is responsible for creating, updating and attaching to the shared memory segment holding a TelemetryBlock.
+ * Publishing only performs relaxed atomic stores, the resident set size and step rate are refreshed at most once per
+ * wall second, therefore it may be called every step without slowing the simulation.
+ */
+class Telemetry
+{
+    TelemetryBlock* block = nullptr;
+    std::string name;
+    bool owner = false;
+    std::chrono::steady_clock::time_point window_start;
+    uint64_t window_steps = 0;
+public:
+    Telemetry() = default;
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+    ~Telemetry();
+    bool Create(std::string Name);
+    bool Attach(std::string Name);
+    bool IsOpen();
+    void Publish(double Simulated_Time, uint64_t Active_Vehicles, uint64_t Pending_Negotiations, uint64_t Queue_Depth);
+    void Finish();
+    bool Read(TelemetrySnapshot& Snapshot);
+    static std::string SegmentName(std::string Name);
+    static uint64_t GetResidentSetSize();
+};
+
+#endif
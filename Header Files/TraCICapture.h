@@ -0,0 +1,55 @@
+#ifndef COSIMULATION_TRACICAPTURE_H
+#define COSIMULATION_TRACICAPTURE_H
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+/**
+ * A single TraCI message exchanged with SUMO as found within a capture. Messages are stored exactly as they appeared on
+ * the wire, including their four byte length prefix, along with the time (relative to the start of the capture) at
+ * which they were seen.
+ */
+struct TraCIRecord
+{
+    uint8_t Direction = 0;
+    int64_t Timestamp_NS = 0;
+    std::vector<uint8_t> Message;
+};
+
+/**
+ * This class is responsible for capturing every TraCI message exchanged between this application and SUMO. When
+ * started it connects to SUMO itself and offers a local port for the TraCIClient to connect to instead. Each request is
+ * then relayed to SUMO and each response relayed back, with both being appended to the capture file as they pass. The
+ * static functions are shared with the replay server which serves a capture back in place of SUMO.
+ */
+class TraCICapture
+{
+    int listener = -1;
+    int client_side = -1;
+    int sumo_side = -1;
+    FILE* file = nullptr;
+    std::thread relay;
+    std::chrono::steady_clock::time_point start;
+    void Relay();
+    void Write(uint8_t Direction, const std::vector<uint8_t>& Message);
+public:
+    enum Direction {Request = 0, Reply = 1};
+    TraCICapture() = default;
+    TraCICapture(const TraCICapture&) = delete;
+    TraCICapture& operator=(const TraCICapture&) = delete;
+    ~TraCICapture();
+    int Start(std::string URL, std::string Address, int Port);
+    static int Connect(std::string Address, int Port);
+    static int Listen(int Port);
+    static bool ReadMessage(int Socket, std::vector<uint8_t>& Message);
+    static bool WriteMessage(int Socket, const std::vector<uint8_t>& Message);
+    static bool ReadHeader(FILE* File);
+    static bool ReadRecord(FILE* File, TraCIRecord& Record);
+    static int GetCommandID(const std::vector<uint8_t>& Message, int& Variable);
+};
+
+#endif
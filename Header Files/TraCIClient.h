@@ -1,23 +1,72 @@
 #ifndef COSIMULATION_TRACICLIENT_H
 #define COSIMULATION_TRACICLIENT_H
 
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include <utils/traci/TraCIAPI.h>
+#include "TraCICapture.h"
+
+#ifndef CMD_SAVE_SIMSTATE
+#define CMD_SAVE_SIMSTATE 0x95
+#endif
+
+/**
+ * A command issued to a detached client that is to be forwarded to, and executed by, a client connected to SUMO.
+ */
+struct TraCICommand
+{
+    enum Type {Set_Lane_Change_Mode, Change_Lane, Change_Lane_Speed_Limit, Slow_Down};
+    int Command_Type;
+    std::string ID;
+    int Integer;
+    double Real;
+    int64_t Duration;
+};
 
 /**
  * This class is responsible for establishing and maintaining a connection to SUMO via the TraCIAPI. This class is
  * expected to be used throughout the program in order to query SUMO about the state of all vehicles within the current
  * simulation and issue commands on how the simulation will progress. Three functions have been implemented on top of
  * the base of this in order to provide much need functionality that is currently missing from the base API. Please
- * refer to the documentation of SUMO and TraCAPI on usage details.
+ * refer to the documentation of SUMO and TraCAPI on usage details. The remaining functions wrap the calls into the base
+ * API used by this application so that each round trip to SUMO may be counted by the Profiler. A client may also be
+ * detached from SUMO, in which case queries are answered from state supplied by the caller (such as a recorded
+ * trajectory) and commands are discarded. When connected with a capture file every message exchanged with SUMO is
+ * recorded so that the session can later be served again by the replay server. A detached client may instead forward
+ * its commands, in which case they are held until taken and executed by a client that is connected.
  */
 class TraCIClient : public TraCIAPI
 {
+    bool detached = false;
+    std::vector<std::string> detached_vehicle_ids;
+    int detached_expected_number = 0;
+    bool forwarding = false;
+    std::vector<TraCICommand> forwarded_commands;
+    std::unique_ptr<TraCICapture> capture;
 public:
     TraCIClient() = default;
     ~TraCIClient() = default;
     void SetLaneChangeMode(std::string Vehicle_ID, int Mode);
     void ChangeLane(std::string Vehicle_ID, int Lane_Index, SUMOTime Duration);
     void ChangeLaneSpeedLimit(std::string Lane_ID, double New_Speed);
+    void SlowDown(std::string Vehicle_ID, double Speed, int Duration);
+    void Subscribe(std::string Vehicle_ID, const std::vector<int>& Variables);
+    std::vector<std::string> GetVehicleIDList();
+    int GetMinExpectedNumber();
+    SUMOTime GetCurrentTime();
+    void Connect(std::string Address, int Port, std::string Capture_URL);
+    void Step();
+    void Load(const std::vector<std::string>& Arguments);
+    void SaveState(std::string URL);
+    void Close();
+    void Detach();
+    bool IsDetached();
+    void SetDetachedState(const std::vector<std::string>& Vehicle_IDs, int Expected_Number);
+    void SetForwarding(bool Forwarding);
+    std::vector<TraCICommand> TakeForwardedCommands();
+    void Execute(const TraCICommand& Command);
 };
 
 #endif
\ No newline at end of file
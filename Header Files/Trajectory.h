@@ -0,0 +1,122 @@
+#ifndef COSIMULATION_TRAJECTORY_H
+#define COSIMULATION_TRAJECTORY_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include "VehicleAttributes.h"
+
+/**
+ * Layout of a trajectory file. The header is followed by one block per step, each holding a TrajectoryStepHeader and
+ * then the columns of that step (vehicle index, x, y and speed as 32 bit values followed by the lane index as a byte)
+ * padded to eight bytes. The file ends with a table of TrajectoryVehicle records holding the identifier and static
+ * attributes of each vehicle, the identifiers themselves and the offset of every step block.
+ */
+struct TrajectoryHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t Vehicle_Count;
+    double Step_Length;
+    uint64_t Step_Count;
+    uint64_t Vehicle_Table_Offset;
+    uint64_t Step_Table_Offset;
+};
+
+struct TrajectoryStepHeader
+{
+    double Time;
+    uint32_t Count;
+    uint32_t Reserved;
+};
+
+struct TrajectoryVehicle
+{
+    uint32_t ID_Offset;
+    uint32_t ID_Length;
+    float Length;
+    float Max_Speed;
+    float Acceleration;
+    float Deceleration;
+    float Max_Legal_Speed;
+    uint32_t Reserved;
+};
+
+/**
+ * A view of a single step within a mapped trajectory file. The columns point directly into the mapping.
+ */
+struct TrajectoryStep
+{
+    double Time = 0;
+    uint32_t Count = 0;
+    const uint32_t* Vehicle_Index = nullptr;
+    const float* X = nullptr;
+    const float* Y = nullptr;
+    const float* Speed = nullptr;
+    const int8_t* Lane_Index = nullptr;
+};
+
+/**
+ * This class is responsible for recording the state of every vehicle at each step of a live co-simulation. Each step is
+ * collected into column buffers that are reused between steps and then appended to the file in a single write.
+ */
+class TrajectoryRecorder
+{
+    FILE* file = nullptr;
+    TrajectoryHeader header;
+    std::map<std::string, uint32_t> vehicle_indices;
+    std::vector<TrajectoryVehicle> vehicles;
+    std::string vehicle_ids;
+    std::vector<uint64_t> step_offsets;
+    uint64_t offset = 0;
+    double step_time = 0;
+    std::vector<uint32_t> vehicle_index_column;
+    std::vector<float> x_column;
+    std::vector<float> y_column;
+    std::vector<float> speed_column;
+    std::vector<int8_t> lane_column;
+    void Write(const void* Data, size_t Size);
+public:
+    TrajectoryRecorder() = default;
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+    ~TrajectoryRecorder();
+    bool Open(std::string URL, double Step_Length);
+    void BeginStep(double Time);
+    void Add(const std::string& Vehicle_ID, const VehicleAttributes& Attributes);
+    void EndStep();
+    void Close();
+};
+
+/**
+ * This class is responsible for reading a trajectory file produced by TrajectoryRecorder. The file is memory mapped and
+ * read sequentially, pages that have already been replayed are released so that traces far larger than the available
+ * memory can be streamed.
+ */
+class TrajectoryReader
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t position = 0;
+    size_t released = 0;
+    uint64_t step = 0;
+    const TrajectoryHeader* header = nullptr;
+    const TrajectoryVehicle* vehicles = nullptr;
+    const char* vehicle_ids = nullptr;
+public:
+    TrajectoryReader() = default;
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+    ~TrajectoryReader();
+    bool Open(std::string URL);
+    double GetStepLength();
+    uint32_t GetVehicleCount();
+    std::string GetVehicleID(uint32_t Index);
+    void GetStaticAttributes(uint32_t Index, VehicleAttributes& Attributes);
+    bool Next(TrajectoryStep& Step);
+    bool HasNext();
+};
+
+#endif
@@ -4,15 +4,24 @@
 #include <memory>
 #include <string>
 #include <ns3/node.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
 #include "TraCIClient.h"
 #include "VehicleAttributes.h"
 #include <ns3/net-device-container.h>
 
+class VehicleApplication;
+
 /**
  * This class is responsible for acting as a common interface between the two simulators used within this application.
  * NS-3 is represented with the use of the network node and network devices each configured appropriately to conform to
  * IEEE 802.11p standards. SUMO is represented with the use of the unique identifier that can be used to query SUMO via
  * the TraCIAPI for information about the vehicle or to issue commands.
+ *
+ * Each negotiation moves from requested, as the application is asked to change lane, to collecting while responses are
+ * gathered and then to recommended or deferred, at which point a timer is set to verify the change or to retry it. The
+ * negotiation is done once the target lane is observed during a step or the vehicle arrives, at which point any timer
+ * still pending is removed from the event queue.
  */
 class Vehicle
 {
@@ -20,22 +29,63 @@ class Vehicle
     ns3::NetDeviceContainer vehicle_devices;
     std::shared_ptr<VehicleAttributes> vehicle_attributes;
     std::string vehicle_id;
+    std::string road_id;
+    int lane_count = -1;
     int target_lane = -1;
     int previous_lane = -1;
+    bool owned = true;
+    bool visible = true;
+    ns3::Time negotiation_start;
+    ns3::Time request_start = ns3::Time(-1);
+    ns3::Time depart_time = ns3::Time(-1);
+    bool arrived = false;
+    bool departed = false;
+    int retries = 0;
+    int observed_lane = -1;
+    VehicleApplication* application = nullptr;
+public:
+    enum StepAction {Step_None, Step_Request, Step_Reached};
+    enum NegotiationState {Negotiation_Done, Negotiation_Requested, Negotiation_Collecting, Negotiation_Recommended,
+                           Negotiation_Deferred};
+private:
+    NegotiationState negotiation_state = Negotiation_Done;
+    ns3::EventId negotiation_timer;
+    void RemoveNegotiationTimer();
     void VerifyLaneChange(int Lane_Index);
+    void RetryLaneChange(int Lane_Index);
 public:
     Vehicle(ns3::Ptr<ns3::Node> Vehicle_Node, ns3::NetDeviceContainer Vehicle_Devices,
             std::shared_ptr<VehicleAttributes> Vehicle_Attributes, std::string ID);
     ~Vehicle() = default;
+    void Subscribe(std::shared_ptr<TraCIClient> Client, const std::vector<int>& Step_Variables,
+                   const std::vector<int>& Departure_Variables, TraCIAPI::TraCIValues& Results);
+    void Decode(const TraCIAPI::TraCIValues& Results);
     void Step(std::shared_ptr<TraCIClient> Client);
+    StepAction Plan();
+    void Apply(StepAction Action, std::shared_ptr<TraCIClient> Client, bool Move = true);
     ns3::Ptr<ns3::Node> GetNode();
     ns3::NetDeviceContainer& GetDevices();
     std::shared_ptr<VehicleAttributes> GetAttributes();
     std::string GetID();
+    const std::string& GetRoadID();
+    int GetLaneCount();
+    void SetLaneCount(int Lane_Count);
     std::string GetIPAddress();
     void RecommendLaneChange(bool Recommendation, int Lane_Index, std::shared_ptr<TraCIClient> Client);
+    void DeferLaneChange(ns3::Time Delay, int Lane_Index, std::shared_ptr<TraCIClient> Client);
+    void BeginRequest();
+    NegotiationState GetNegotiationState();
+    void Arrive();
     void SetTarget(int Target_Lane);
     bool HasTarget();
+    int GetTarget();
+    int GetPreviousLane();
+    void SetPreviousLane(int Lane_Index);
+    void SetOwnership(bool Owned, bool Visible);
+    bool IsOwned();
+    bool IsVisible();
+    void SetApplication(VehicleApplication* Application);
+    VehicleApplication* GetApplication();
     std::string ToString();
 };
 
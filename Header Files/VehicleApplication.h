@@ -2,11 +2,14 @@
 #define COSIMULATION_VEHICLEAPPLICATION_H
 
 #include <memory>
+#include <vector>
 #include <ns3/ptr.h>
 #include "Vehicle.h"
 #include <ns3/socket.h>
 #include <ns3/application.h>
 #include "VehicleAttributes.h"
+#include "AnimationWriter.h"
+#include "NetworkAbstraction.h"
 
 /**
  * This enum represents the types of packets that maybe sent between vehicles within this VehicleApplication installed
@@ -18,6 +21,13 @@
  */
 enum Context {Get, Response, Command};
 
+/**
+ * The responses to a request for information, one for each responding vehicle in the order of its address. The list is
+ * kept by the application from one request to the next so that, once it has grown, collecting responses allocates
+ * nothing.
+ */
+typedef std::vector<std::pair<ns3::Address, VehicleAttributes>> ResponseList;
+
 /**
  * This class will act as the base of the two applications that shall be installed upon the vehicle node within this
  * simulation. This base will ensure that components are configured appropriately however implementation will be carried
@@ -27,21 +37,43 @@ class VehicleApplication : public ns3::Application
 {
 private:
     ns3::Ptr<ns3::Socket> socket;
-    std::map<ns3::Address, VehicleAttributes> responses;
+    ResponseList responses;
     std::shared_ptr<Vehicle> vehicle;
     std::shared_ptr<TraCIClient> client;
     ns3::Time transmission_delay_ns;
+    std::shared_ptr<NetworkAbstraction> network_abstraction;
+    std::shared_ptr<AnimationWriter> animation_writer;
+    ns3::Address local_address;
+    ns3::Time request_time;
+    std::vector<std::pair<ns3::Address, ns3::Time>> response_times;
+    std::string send_buffer;
+    std::vector<uint8_t> receive_buffer;
+    std::string receive_content;
+    std::vector<std::string> messages;
+    std::vector<size_t> free_messages;
+    void EndRequest(int Lane_Index);
+    void SendMessage(Context Action, size_t Slot, ns3::Address Recipient);
+    void DeliverMessage(Context Action, size_t Slot, ns3::Address From);
 protected:
     virtual void StartApplication();
     virtual void StopApplication() { };
     virtual void RunAlgorithm(int Lane_Index);
-    virtual void Send(Context Action, std::string Content, ns3::Address Recipient);
+    virtual void Send(Context Action, const std::string& Content, ns3::Address Recipient);
     virtual Context Read(ns3::Ptr<ns3::Packet> Packet, std::string& Content);
     virtual void Receive(ns3::Ptr<ns3::Socket> Socket);
+    bool ReadNext(ns3::Ptr<ns3::Socket> Socket, Context& Action, std::string& Content, ns3::Address& From);
+    virtual void Handle(Context Action, const std::string& Content, ns3::Address From) { };
+    virtual bool IsRespondent(int Lane_Index, const VehicleAttributes& Attributes);
+    void Request(const std::string& Content, int Lane_Index);
+    std::string& BeginMessage(size_t& Slot);
+    void ReleaseMessage(size_t Slot);
+    void ScheduleMessage(ns3::Time Delay, Context Action, size_t Slot, ns3::Address Recipient);
+    void AddResponse(const ns3::Address& From, const VehicleAttributes& Attributes);
     bool GetPartner(std::pair<ns3::Address, VehicleAttributes>& Partner);
     bool IsPresent();
     ns3::Ptr<ns3::Socket> GetSocket();
-    std::map<ns3::Address, VehicleAttributes>& GetResponses();
+    ResponseList& GetResponses();
+    std::string& GetReceiveContent();
     std::shared_ptr<Vehicle> GetVehicle();
     std::string GetVehicleID();
     std::shared_ptr<VehicleAttributes> GetVehicleAttributes();
@@ -52,6 +84,9 @@ public:
     ~VehicleApplication() = default;
     virtual void ChangeLane(int Lane_Index);
     void Install(std::shared_ptr<Vehicle> Vehicle, std::shared_ptr<TraCIClient> Client);
+    void SetNetworkAbstraction(std::shared_ptr<NetworkAbstraction> Network_Abstraction);
+    void SetAnimationWriter(std::shared_ptr<AnimationWriter> Animation_Writer);
+    size_t GetResponseCapacity();
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define COSIMULATION_VEHICLEATTRIBUTES_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <libsumo/TraCIDefs.h>
 #include <utils/traci/TraCIAPI.h>
 
@@ -10,9 +12,22 @@
  * this simulation. These values can be accessed to enable NS-3 the ability to position the nodes and network devices
  * appropriately and empower the algorithms to make valid and accurate decisions. This struct also provides the ability
  * to update the values with a TraCIValues object obtained via a TraCI subscription.
+ *
+ * Which attributes are subscribed to is described at compile time by a set of fields. The static fields describe the
+ * vehicle itself and never change, so are fetched once as the vehicle departs, while the remainder are fetched every
+ * step. The fields each lane change protocol reads are declared by the protocol, see ProtocolApplication, and those
+ * no part of the simulation reads are not fetched at all. The road a vehicle is upon is only read by the Governor,
+ * which subscribes to it when the edges of the network differ in their number of lanes. It is kept by the Vehicle, see
+ * Vehicle::Decode, so that these attributes hold no heap memory and cost nothing to copy into messages and responses.
  */
 struct VehicleAttributes
 {
+    enum Field : uint32_t {Field_Speed = 1 << 0, Field_Position = 1 << 1, Field_Lane_Index = 1 << 2,
+                           Field_Length = 1 << 3, Field_Max_Speed = 1 << 4, Field_Acceleration = 1 << 5,
+                           Field_Deceleration = 1 << 6, Field_Max_Legal_Speed = 1 << 7, Field_Road_ID = 1 << 8};
+    static const uint32_t Static_Fields = Field_Length | Field_Max_Speed | Field_Acceleration | Field_Deceleration;
+    static const uint32_t Step_Fields = Field_Position | Field_Lane_Index;
+    static const uint32_t All_Fields = (1 << 9) - 1;
     double Speed;
     libsumo::TraCIPosition Position;
     int Lane_Index;
@@ -21,18 +36,15 @@ struct VehicleAttributes
     double Acceleration;
     double Deceleration;
     double Max_Legal_Speed;
-    std::vector<int> Attribute_Names = {VAR_SPEED, VAR_POSITION,
-                                        VAR_LANE_INDEX, VAR_LENGTH,
-                                        VAR_MAXSPEED, VAR_ACCEL,
-                                        VAR_DECEL, VAR_ALLOWED_SPEED};
-    void Update(TraCIAPI::TraCIValues Results);
+    void Update(const TraCIAPI::TraCIValues& Results);
+    static std::vector<int> GetVariables(uint32_t Fields);
     VehicleAttributes(double Speed = 0, libsumo::TraCIPosition Position = libsumo::TraCIPosition(),
                       int Lane_Index = 0, double Length = 0,
                       double Max_Speed = 0, double Acceleration = 0,
                       double Deceleration = 0, double Max_Legal_Speed = 0);
     ~VehicleAttributes() = default;
-    static std::string Serialise(VehicleAttributes Vehicle_Attributes);
-    static VehicleAttributes Deserialise(std::string Data);
+    static void Serialise(const VehicleAttributes& Vehicle_Attributes, std::string& Data);
+    static VehicleAttributes Deserialise(const std::string& Data);
     std::string ToString();
 };
 
@@ -32,6 +32,7 @@ public:
     explicit VehicleFactory(std::string Address_Base = "10.0.0.0", std::string Subnet_Mask = "255.0.0.0");
     ~VehicleFactory() = default;
     std::shared_ptr<Vehicle> CreateVehicle(std::string ID);
+    void SetLegacyPropagation(bool Legacy_Propagation);
 };
 
 #endif
\ No newline at end of file
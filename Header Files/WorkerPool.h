@@ -0,0 +1,41 @@
+#ifndef COSIMULATION_WORKERPOOL_H
+#define COSIMULATION_WORKERPOOL_H
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * This class is responsible for spreading independent work, such as the per-vehicle bookkeeping of a step, across a
+ * fixed set of threads that persist between steps. Work is divided into contiguous slices, one per thread, with the
+ * calling thread taking the first slice itself. Tasks must not touch NS-3 or SUMO, which are only safe to use from the
+ * simulator thread, nor anything shared between vehicles such as the Profiler or Metrics. Small amounts of work are
+ * carried out by the calling thread alone as waking the pool would cost more than it saves.
+ */
+class WorkerPool
+{
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_condition;
+    std::condition_variable done_condition;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t count = 0;
+    size_t slices = 0;
+    size_t remaining = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    void Work(size_t Slice);
+    void RunSlice(size_t Slice);
+public:
+    explicit WorkerPool(unsigned int Threads);
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool();
+    void Run(size_t Count, const std::function<void(size_t)>& Task);
+    unsigned int GetSize();
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/internet-module.h>
+#include "../Header Files/Vehicle.h"
+#include "../Header Files/TraCIClient.h"
+#include "../Header Files/MemoryReport.h"
+#include "../Header Files/VehicleFactory.h"
+#include "../Header Files/NetworkAbstraction.h"
+#include "../Header Files/ILACHPlusApplication.h"
+
+using namespace ns3;
+
+namespace
+{
+    /**
+     * Exposes the entry point of the ILACHPlusApplication for packets, which is otherwise only reachable through its
+     * socket, together with the responses it has collected.
+     */
+    class MessageProbe : public ILACHPlusApplication
+    {
+    public:
+        using ILACHPlusApplication::Handle;
+        using ILACHPlusApplication::GetResponses;
+        using ILACHPlusApplication::GetVehicle;
+    };
+
+    /**
+     * Does nothing, scheduled with the same arguments as the messages of the application to count the allocations of
+     * the simulator for each event.
+     */
+    void Discard(Context Action, size_t Slot, Address Recipient) { }
+
+    /**
+     * Hand the request to every other application as Receive would once read from the socket and run the simulator
+     * until every response has been sent, delivered and collected by the requesting application.
+     */
+    void HandleRound(const std::vector<Ptr<MessageProbe>>& Applications, const std::vector<Address>& Addresses,
+                     const std::string& Request)
+    {
+        Applications.at(0)->GetResponses().clear();
+        for(size_t i = 1; i < Applications.size(); i++)
+            Applications.at(i)->Handle(Get, Request, Addresses.at(0));
+        Simulator::Stop(Seconds(1));
+        Simulator::Run();
+        ILACHPlusPolicy::RequiresYield(Applications.at(0)->GetResponses(),
+                                       *Applications.at(0)->GetVehicle()->GetAttributes());
+    }
+}
+
+/**
+ * Check that the message path of the ILACHPlusApplication allocates nothing once warmed up. One vehicle requests
+ * information from every other, whose applications handle the request, serialise their attributes into a message
+ * buffer and schedule the response, which the network abstraction delivers into a message buffer of the requesting
+ * application to be deserialised and collected. Every allocation made through operator new is counted, see
+ * MemoryReport, less those of the events the simulator executes, the number of allocations for each having been
+ * counted beforehand with events that do nothing. The first rounds grow the buffers kept by the applications and are
+ * not counted. Packets are not sent as the network abstraction stands in for the network.
+ * Usage: CosimulationAllocationCheck [--vehicles=N] [--rounds=N]
+ */
+int main(int argc, char** argv)
+{
+    size_t vehicles = 32;
+    int rounds = 1000;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if(argument.compare(0, 11, "--vehicles=") == 0)
+            vehicles = std::max<size_t>(2, std::stoul(argument.substr(11)));
+        else if(argument.compare(0, 9, "--rounds=") == 0)
+            rounds = std::stoi(argument.substr(9));
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--vehicles=N] [--rounds=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    VehicleFactory factory;
+    std::shared_ptr<TraCIClient> client = std::make_shared<TraCIClient>();
+    client->Detach();
+    // Every exchange succeeds after a millisecond, the vehicles all lying well within range of one another.
+    std::shared_ptr<NetworkAbstraction> network_abstraction =
+            std::make_shared<NetworkAbstraction>(true, 1000, 1, 1, 0, 1, "");
+    std::vector<Ptr<MessageProbe>> applications;
+    std::vector<Address> addresses;
+    for(size_t i = 0; i < vehicles; i++)
+    {
+        // Identifiers as SUMO gives vehicles of a flow, short enough to be copied without allocating.
+        std::shared_ptr<Vehicle> vehicle = factory.CreateVehicle("flow0." + std::to_string(i));
+        VehicleAttributes& attributes = *vehicle->GetAttributes();
+        attributes = VehicleAttributes(20 + i % 10, libsumo::TraCIPosition(), 1 + (int)(i % 2), 4, 50, 2.6, 4.5, 33);
+        attributes.Position.x = 900 + 7.5 * i;
+        Ptr<MessageProbe> application = CreateObject<MessageProbe>();
+        application->SetNetworkAbstraction(network_abstraction);
+        application->Install(vehicle, client);
+        applications.push_back(application);
+        addresses.push_back(InetSocketAddress(vehicle->GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal(), 80));
+    }
+    // Every other vehicle lies within either the current or the desired lane of the first and so responds to it.
+    applications.at(0)->GetVehicle()->GetAttributes()->Lane_Index = 1;
+    std::string request = ILACHPlusPolicy::Encode(2, 1);
+    for(int round = 0; round < 3; round++)
+        HandleRound(applications, addresses, request);
+    MemoryReport::Instance().Enable(true, true);
+    uint64_t calibration_events = Simulator::GetEventCount();
+    uint64_t before = MemoryReport::GetAllocationCount();
+    for(size_t i = 0; i < 1000; i++)
+        Simulator::Schedule(MilliSeconds(1), &Discard, Response, i, addresses.at(0));
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    uint64_t event_allocations = MemoryReport::GetAllocationCount() - before;
+    uint64_t events = Simulator::GetEventCount();
+    calibration_events = events - calibration_events;
+    before = MemoryReport::GetAllocationCount();
+    for(int round = 0; round < rounds; round++)
+        HandleRound(applications, addresses, request);
+    uint64_t allocations = MemoryReport::GetAllocationCount() - before;
+    MemoryReport::Instance().Enable(false, false);
+    events = Simulator::GetEventCount() - events;
+    uint64_t expected = events * event_allocations / calibration_events;
+    size_t responses = applications.at(0)->GetResponses().size();
+    Simulator::Destroy();
+    std::printf("%llu responses collected in %d rounds with %llu allocations, of which %llu were of the %llu events\n",
+                (unsigned long long)responses * rounds, rounds, (unsigned long long)allocations,
+                (unsigned long long)expected, (unsigned long long)events);
+    if(responses != vehicles - 1)
+    {
+        std::printf("Expected %zu responses in each round, collected %zu\n", vehicles - 1, responses);
+        return 1;
+    }
+    return allocations <= expected ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+#include "../Header Files/OutputAnalyser.h"
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <algorithm>
+#include <sys/stat.h>
+
+namespace
+{
+    /**
+     * Collect every XML file at or beneath the given path, in a stable order.
+     */
+    void CollectFiles(const std::string& URL, std::vector<std::string>& Files)
+    {
+        struct stat status;
+        if(stat(URL.c_str(), &status) == -1)
+        {
+            std::perror(URL.c_str());
+            return;
+        }
+        if(!S_ISDIR(status.st_mode))
+        {
+            Files.push_back(URL);
+            return;
+        }
+        DIR* directory = opendir(URL.c_str());
+        if(directory == nullptr)
+            return;
+        std::vector<std::string> entries;
+        while(dirent* entry = readdir(directory))
+        {
+            std::string name = entry->d_name;
+            if(name != "." && name != "..")
+                entries.push_back(name);
+        }
+        closedir(directory);
+        std::sort(entries.begin(), entries.end());
+        for(const auto& name : entries)
+        {
+            std::string path = URL + "/" + name;
+            if(stat(path.c_str(), &status) == 0 &&
+               (S_ISDIR(status.st_mode) || (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)))
+                CollectFiles(path, Files);
+        }
+    }
+
+    void PrintDistribution(const char* Name, const Histogram& Distribution)
+    {
+        std::printf("%s,count,%llu\n", Name, (unsigned long long)Distribution.Count);
+        std::printf("%s,mean,%.3f\n", Name, Distribution.Count ? Distribution.Sum / Distribution.Count : 0);
+        std::printf("%s,min,%.3f\n", Name, Distribution.Minimum);
+        std::printf("%s,p50,%.3f\n", Name, Distribution.GetPercentile(0.5));
+        std::printf("%s,p90,%.3f\n", Name, Distribution.GetPercentile(0.9));
+        std::printf("%s,p99,%.3f\n", Name, Distribution.GetPercentile(0.99));
+        std::printf("%s,max,%.3f\n", Name, Distribution.Maximum);
+    }
+}
+
+/**
+ * Analyse every trip info and lane change output at or beneath the given paths in parallel and print their aggregate
+ * statistics as CSV. Files that are neither are ignored. With --per-file a line of statistics is printed for each file
+ * ahead of the aggregate. With --metrics the binary metrics file written by a run is printed instead.
+ * Usage: CosimulationAnalyse <file or directory> [file or directory...] [--jobs=N] [--per-file]
+ *        CosimulationAnalyse --metrics=<file>
+ */
+int main(int argc, char** argv)
+{
+    std::vector<std::string> files;
+    unsigned int jobs = std::max(1u, std::thread::hardware_concurrency());
+    bool per_file = false;
+    std::string metrics;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if(argument.compare(0, 10, "--metrics=") == 0)
+            metrics = argument.substr(10);
+        else if(argument.compare(0, 7, "--jobs=") == 0)
+            jobs = std::max(1u, (unsigned int)std::stoul(argument.substr(7)));
+        else if(argument == "--per-file")
+            per_file = true;
+        else
+            CollectFiles(argument, files);
+    }
+    if(!metrics.empty())
+    {
+        Metrics& summary = Metrics::Instance();
+        if(!summary.Read(metrics))
+            return 1;
+        std::printf("section,name,value\n");
+        for(int i = 0; i < Metrics::Tally_Count; i++)
+        {
+            std::printf("tally,%s,%llu\n", Metrics::TallyName((Metrics::Tally)i),
+                        (unsigned long long)summary.GetTally((Metrics::Tally)i));
+        }
+        for(int i = 0; i < Metrics::Distribution_Count; i++)
+        {
+            PrintDistribution(Metrics::DistributionName((Metrics::Distribution)i),
+                              summary.GetDistribution((Metrics::Distribution)i));
+        }
+        return 0;
+    }
+    if(files.empty())
+    {
+        std::fprintf(stderr, "Usage: %s <file or directory> [file or directory...] [--jobs=N] [--per-file]\n"
+                     "       %s --metrics=<file>\n", argv[0], argv[0]);
+        return 1;
+    }
+    std::vector<OutputSummary> summaries(files.size());
+    std::vector<OutputAnalyser::Output> outputs(files.size(), OutputAnalyser::Unknown);
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for(unsigned int i = 0; i < std::min<size_t>(jobs, files.size()); i++)
+    {
+        workers.emplace_back([&]()
+        {
+            for(size_t index = next++; index < files.size(); index = next++)
+                outputs.at(index) = OutputAnalyser::Analyse(files.at(index), summaries.at(index));
+        });
+    }
+    for(auto& worker : workers)
+        worker.join();
+    OutputSummary total;
+    if(per_file)
+        std::printf("file,type,trips,mean_travel_time,mean_time_loss,lane_changes\n");
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        const OutputSummary& summary = summaries.at(i);
+        if(per_file && outputs.at(i) != OutputAnalyser::Unknown)
+        {
+            std::printf("%s,%s,%llu,%.3f,%.3f,%llu\n", files.at(i).c_str(),
+                        outputs.at(i) == OutputAnalyser::Trip_Info ? "tripinfo" : "lanechange",
+                        (unsigned long long)summary.Trips,
+                        summary.Trips ? summary.Travel_Time.Sum / summary.Travel_Time.Count : 0,
+                        summary.Trips ? summary.Time_Loss.Sum / summary.Time_Loss.Count : 0,
+                        (unsigned long long)summary.Lane_Changes);
+        }
+        total.Merge(summary);
+    }
+    if(per_file)
+        std::printf("\n");
+    std::printf("section,name,value\n");
+    std::printf("files,analysed,%llu\n", (unsigned long long)total.Files);
+    std::printf("trips,count,%llu\n", (unsigned long long)total.Trips);
+    PrintDistribution("travel_time_s", total.Travel_Time);
+    PrintDistribution("time_loss_s", total.Time_Loss);
+    PrintDistribution("depart_delay_s", total.Depart_Delay);
+    std::printf("lane_changes,count,%llu\n", (unsigned long long)total.Lane_Changes);
+    for(const auto& pair : total.Lane_Pairs)
+    {
+        std::printf("lane_pair,%s>%s,%llu\n", total.Lanes.Names.at(pair.first.first).c_str(),
+                    total.Lanes.Names.at(pair.first.second).c_str(), (unsigned long long)pair.second);
+    }
+    for(size_t i = 0; i < total.Reason_Counts.size(); i++)
+    {
+        std::printf("reason,%s,%llu\n", total.Reasons.Names.at(i).c_str(),
+                    (unsigned long long)total.Reason_Counts.at(i));
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include "../Header Files/AnimationWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <ns3/ipv4.h>
+#include <ns3/simulator.h>
+#include <ns3/mobility-model.h>
+#include <ns3/inet-socket-address.h>
+
+using namespace ns3;
+
+namespace
+{
+    const unsigned int Buffer_Size = 1 << 20;
+    const double Hidden_Y = -100;
+
+    /**
+     * Escape the characters of a string that may not appear within an XML attribute.
+     */
+    std::string Escape(const std::string& Value)
+    {
+        std::string result;
+        result.reserve(Value.size());
+        for(char character : Value)
+        {
+            switch(character)
+            {
+                case '"': result.append("&quot;"); break;
+                case '&': result.append("&amp;"); break;
+                case '<': result.append("&lt;"); break;
+                case '>': result.append("&gt;"); break;
+                default: result.push_back(character);
+            }
+        }
+        return result;
+    }
+}
+
+/**
+ * Close the trace should it still be open.
+ */
+AnimationWriter::~AnimationWriter()
+{
+    this->Close();
+}
+
+/**
+ * Open the trace and declare every vehicle within it. Vehicles are declared hidden, beneath the road, until they are
+ * first shown.
+ * @param URL Name of the trace, compressed if it ends with '.gz'.
+ * @param Options Options of the trace.
+ * @param Vehicles Every vehicle in the order their nodes were created.
+ * @return True if the trace could be opened.
+ */
+bool AnimationWriter::Open(std::string URL, const AnimationOptions& Options,
+                           const std::vector<std::shared_ptr<Vehicle>>& Vehicles)
+{
+    bool compress = URL.size() >= 3 && URL.compare(URL.size() - 3, 3, ".gz") == 0;
+    this->file = gzopen(URL.c_str(), compress ? "wb6" : "wbT");
+    if(this->file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    gzbuffer(this->file, Buffer_Size);
+    this->options = Options;
+    this->next_update = Options.Start_Time;
+    this->vehicles = Vehicles;
+    this->states.assign(Vehicles.size(), Hidden);
+    gzprintf(this->file, "<anim ver=\"netanim-3.108\" filetype=\"animation\" >\n");
+    for(const auto& vehicle : this->vehicles)
+    {
+        Ptr<Node> node = vehicle->GetNode();
+        gzprintf(this->file, "<node id=\"%u\" sysId=\"0\" locX=\"0\" locY=\"%.0f\" />\n", node->GetId(), Hidden_Y);
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        if(ipv4)
+            this->address_nodes[ipv4->GetAddress(1, 0).GetLocal().Get()] = node->GetId();
+    }
+    return true;
+}
+
+/**
+ * Determine if the given time lies within the window of the trace.
+ * @param Time Simulation time in seconds.
+ * @return True if the time lies within the window.
+ */
+bool AnimationWriter::IsRecording(double Time)
+{
+    return this->file != nullptr && Time >= this->options.Start_Time &&
+           (this->options.Stop_Time <= 0 || Time <= this->options.Stop_Time);
+}
+
+/**
+ * Write the position of each shown vehicle should a position update be due. Vehicles negotiating a lane change are
+ * drawn in red and the others in blue. Vehicles that cease to be shown are moved beneath the road once.
+ * @param Time Current simulation time in seconds.
+ */
+void AnimationWriter::Step(double Time)
+{
+    if(!this->IsRecording(Time) || Time < this->next_update)
+        return;
+    this->next_update = Time + this->options.Interval;
+    std::vector<Vector> negotiating;
+    if(this->options.Radius > 0)
+    {
+        for(const auto& vehicle : this->vehicles)
+        {
+            Vector position = vehicle->GetNode()->GetObject<MobilityModel>()->GetPosition();
+            if(vehicle->HasTarget() && position.z != 10000)
+                negotiating.push_back(position);
+        }
+    }
+    for(size_t i = 0; i < this->vehicles.size(); i++)
+    {
+        std::shared_ptr<Vehicle> vehicle = this->vehicles.at(i);
+        Vector position = vehicle->GetNode()->GetObject<MobilityModel>()->GetPosition();
+        State state = position.z == 10000 ? Hidden : vehicle->HasTarget() ? Negotiating : Shown;
+        if(state == Shown && this->options.Radius > 0)
+        {
+            state = Hidden;
+            for(const auto& other : negotiating)
+            {
+                if(std::abs(other.x - position.x) <= this->options.Radius &&
+                   std::abs(other.y - position.y) <= this->options.Radius)
+                {
+                    state = Shown;
+                    break;
+                }
+            }
+        }
+        uint32_t id = vehicle->GetNode()->GetId();
+        if(state != this->states.at(i) && state != Hidden)
+        {
+            gzprintf(this->file, "<nu p=\"c\" t=\"%.3f\" id=\"%u\" r=\"%d\" g=\"0\" b=\"%d\" />\n", Time, id,
+                     state == Negotiating ? 255 : 0, state == Negotiating ? 0 : 255);
+        }
+        if(state != Hidden)
+            gzprintf(this->file, "<nu p=\"p\" t=\"%.3f\" id=\"%u\" x=\"%.2f\" y=\"%.2f\" />\n", Time, id, position.x,
+                     position.y);
+        else if(this->states.at(i) != Hidden)
+            gzprintf(this->file, "<nu p=\"p\" t=\"%.3f\" id=\"%u\" x=\"0\" y=\"%.0f\" />\n", Time, id, Hidden_Y);
+        this->states.at(i) = state;
+    }
+}
+
+/**
+ * Record a packet received by an application. Packets are drawn at the moment they are received.
+ * @param From Address the packet was received from.
+ * @param Recipient Node that received the packet.
+ * @param Action Name of the action of the packet.
+ * @param Content Content of the packet, only recorded if metadata has been requested.
+ */
+void AnimationWriter::RecordPacket(const Address& From, Ptr<Node> Recipient, const std::string& Action,
+                                   const std::string& Content)
+{
+    double time = Simulator::Now().GetSeconds();
+    if(!this->options.Record_Packets || !this->IsRecording(time) || !InetSocketAddress::IsMatchingType(From))
+        return;
+    auto sender = this->address_nodes.find(InetSocketAddress::ConvertFrom(From).GetIpv4().Get());
+    if(sender == this->address_nodes.end())
+        return;
+    std::string description = this->options.Record_Metadata ? Escape(Action + "/" + Content) : Action;
+    gzprintf(this->file, "<p fId=\"%u\" fbTx=\"%.6f\" lbTx=\"%.6f\" meta-info=\"%s\" tId=\"%u\" fbRx=\"%.6f\" "
+                         "lbRx=\"%.6f\" />\n", sender->second, time, time, description.c_str(), Recipient->GetId(),
+             time, time);
+}
+
+/**
+ * Finish and close the trace.
+ */
+void AnimationWriter::Close()
+{
+    if(this->file == nullptr)
+        return;
+    gzprintf(this->file, "</anim>\n");
+    gzclose(this->file);
+    this->file = nullptr;
+}
@@ -0,0 +1,157 @@
+#include "../Header Files/CachedPropagationLossModel.h"
+#include <cmath>
+
+using namespace ns3;
+
+NS_OBJECT_ENSURE_REGISTERED(CachedLogDistancePropagationLossModel);
+
+/**
+ * Get the type identifier used to select this model via a YansWifiChannelHelper.
+ * @return Type identifier of this model.
+ */
+TypeId CachedLogDistancePropagationLossModel::GetTypeId()
+{
+    static TypeId type_id = TypeId("CachedLogDistancePropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Cosimulation")
+            .AddConstructor<CachedLogDistancePropagationLossModel>();
+    return type_id;
+}
+
+/**
+ * Set the path loss exponent, the default of which matches the stock model.
+ * @param Exponent Path loss exponent.
+ */
+void CachedLogDistancePropagationLossModel::SetPathLossExponent(double Exponent)
+{
+    this->exponent = Exponent;
+    this->row_sender = -1;
+}
+
+/**
+ * Set the distance at which the reference loss is measured and the loss itself, the defaults of which match the stock
+ * model.
+ * @param Reference_Distance Reference distance in metres.
+ * @param Reference_Loss Loss at the reference distance in dB.
+ */
+void CachedLogDistancePropagationLossModel::SetReference(double Reference_Distance, double Reference_Loss)
+{
+    this->reference_distance = Reference_Distance;
+    this->reference_loss = Reference_Loss;
+    this->row_sender = -1;
+}
+
+/**
+ * Get the power received by one node from a transmission of another, computing the losses from the sender to every
+ * known node if they are not already held.
+ * @param Tx_Power_Dbm Power transmitted in dBm.
+ * @param A Mobility model of the sender.
+ * @param B Mobility model of the receiver.
+ * @return Power received in dBm.
+ */
+double CachedLogDistancePropagationLossModel::DoCalcRxPower(double Tx_Power_Dbm, Ptr<MobilityModel> A,
+                                                            Ptr<MobilityModel> B) const
+{
+    uint32_t sender = this->GetIndex(A);
+    uint32_t receiver = this->GetIndex(B);
+    if(!this->stale.empty())
+        this->Refresh();
+    if(this->row_sender != sender)
+        this->ComputeRow(sender);
+    return Tx_Power_Dbm + this->losses[receiver];
+}
+
+/**
+ * Get the index of a node within the position arrays, adding it and listening for its changes of course when it is
+ * first seen.
+ * @param Mobility Mobility model of the node.
+ * @return Index of the node.
+ */
+uint32_t CachedLogDistancePropagationLossModel::GetIndex(Ptr<MobilityModel> Mobility) const
+{
+    auto entry = this->indices.find(PeekPointer(Mobility));
+    if(entry != this->indices.end())
+        return entry->second;
+    uint32_t index = (uint32_t)this->mobilities.size();
+    this->indices.emplace(PeekPointer(Mobility), index);
+    this->mobilities.push_back(PeekPointer(Mobility));
+    Vector position = Mobility->GetPosition();
+    this->x.push_back(position.x);
+    this->y.push_back(position.y);
+    this->z.push_back(position.z);
+    this->losses.push_back(0);
+    this->row_sender = -1;
+    auto self = const_cast<CachedLogDistancePropagationLossModel*>(this);
+    Mobility->TraceConnectWithoutContext("CourseChange",
+                                         MakeCallback(&CachedLogDistancePropagationLossModel::CourseChanged, self));
+    return index;
+}
+
+/**
+ * Note that the position of a node has changed, to be read again before the next loss is computed.
+ * @param Mobility Mobility model of the node.
+ */
+void CachedLogDistancePropagationLossModel::CourseChanged(Ptr<const MobilityModel> Mobility)
+{
+    auto entry = this->indices.find(PeekPointer(Mobility));
+    if(entry != this->indices.end())
+        this->stale.push_back(entry->second);
+}
+
+/**
+ * Read the positions of the nodes whose course has changed and discard the row of losses.
+ */
+void CachedLogDistancePropagationLossModel::Refresh() const
+{
+    for(uint32_t index : this->stale)
+    {
+        Vector position = this->mobilities[index]->GetPosition();
+        this->x[index] = position.x;
+        this->y[index] = position.y;
+        this->z[index] = position.z;
+    }
+    this->stale.clear();
+    this->row_sender = -1;
+}
+
+/**
+ * Compute the loss from the sender to every known node. The distance is computed as MobilityModel::GetDistanceFrom
+ * does and the loss as LogDistancePropagationLossModel does, so that each is identical to the stock model.
+ * @param Sender Index of the sender.
+ */
+void CachedLogDistancePropagationLossModel::ComputeRow(uint32_t Sender) const
+{
+    const size_t count = this->mobilities.size();
+    const double sender_x = this->x[Sender];
+    const double sender_y = this->y[Sender];
+    const double sender_z = this->z[Sender];
+    const double* x = this->x.data();
+    const double* y = this->y.data();
+    const double* z = this->z.data();
+    double* losses = this->losses.data();
+    for(size_t i = 0; i < count; i++)
+    {
+        double dx = x[i] - sender_x;
+        double dy = y[i] - sender_y;
+        double dz = z[i] - sender_z;
+        losses[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        if(losses[i] <= this->reference_distance)
+            losses[i] = -this->reference_loss;
+        else
+            losses[i] = -this->reference_loss - 10 * this->exponent * std::log10(losses[i] / this->reference_distance);
+    }
+    this->row_sender = Sender;
+}
+
+/**
+ * The model is deterministic and so uses no random streams.
+ * @param Stream First stream index that may be used.
+ * @return Number of streams used.
+ */
+int64_t CachedLogDistancePropagationLossModel::DoAssignStreams(int64_t Stream)
+{
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    struct Observation
+    {
+        double Distance;
+        bool Delivered;
+        double Latency_MS;
+    };
+
+    /**
+     * Read the observations written by a simulation run with --calibration-output.
+     */
+    bool ReadObservations(const std::string& URL, std::vector<Observation>& Observations)
+    {
+        std::ifstream file(URL);
+        if(!file)
+        {
+            std::fprintf(stderr, "Unable to read %s\n", URL.c_str());
+            return false;
+        }
+        std::string line;
+        std::getline(file, line);
+        while(std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            Observation observation;
+            char separator;
+            int delivered;
+            if(fields >> observation.Distance >> separator >> delivered >> separator >> observation.Latency_MS)
+            {
+                observation.Delivered = delivered != 0;
+                Observations.push_back(observation);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Fit the logistic curve p = 1 / (1 + exp(-(Intercept + Slope * Distance))) to whether each exchange succeeded by
+     * maximum likelihood, using iteratively reweighted least squares. Distances are scaled to kilometres to keep the
+     * system well conditioned.
+     */
+    bool FitDelivery(const std::vector<Observation>& Observations, double& Intercept, double& Slope)
+    {
+        Intercept = 0;
+        Slope = 0;
+        for(int iteration = 0; iteration < 100; iteration++)
+        {
+            double h00 = 0, h01 = 0, h11 = 0, g0 = 0, g1 = 0;
+            for(const auto& observation : Observations)
+            {
+                double x = observation.Distance / 1000.0;
+                double p = 1.0 / (1.0 + std::exp(-(Intercept + Slope * x)));
+                double w = std::max(p * (1 - p), 1e-9);
+                double residual = (observation.Delivered ? 1.0 : 0.0) - p;
+                g0 += residual;
+                g1 += residual * x;
+                h00 += w;
+                h01 += w * x;
+                h11 += w * x * x;
+            }
+            double determinant = h00 * h11 - h01 * h01;
+            if(std::fabs(determinant) < 1e-12)
+                return false;
+            double step0 = (h11 * g0 - h01 * g1) / determinant;
+            double step1 = (h00 * g1 - h01 * g0) / determinant;
+            Intercept += step0;
+            Slope += step1;
+            if(std::fabs(step0) < 1e-9 && std::fabs(step1) < 1e-9)
+                break;
+        }
+        Slope /= 1000.0;
+        return Slope < 0;
+    }
+
+    /**
+     * Fit Latency = Intercept + Slope * Distance to the exchanges that succeeded by least squares.
+     */
+    void FitLatency(const std::vector<Observation>& Observations, double& Intercept, double& Slope)
+    {
+        double n = 0, sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+        for(const auto& observation : Observations)
+        {
+            if(!observation.Delivered)
+                continue;
+            n++;
+            sum_x += observation.Distance;
+            sum_y += observation.Latency_MS;
+            sum_xx += observation.Distance * observation.Distance;
+            sum_xy += observation.Distance * observation.Latency_MS;
+        }
+        double denominator = n * sum_xx - sum_x * sum_x;
+        Slope = n > 1 && std::fabs(denominator) > 1e-12 ? (n * sum_xy - sum_x * sum_y) / denominator : 0;
+        Intercept = n > 0 ? (sum_y - Slope * sum_x) / n : 0;
+    }
+}
+
+/**
+ * Fit the parameters of the network abstraction against the exchanges recorded by one or more full-fidelity runs, each
+ * made with --calibration-output, and print the command line options that apply them along with a comparison of the
+ * observed and fitted delivery ratio by distance.
+ * Usage: CosimulationCalibrate <observations> [observations...]
+ */
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <observations> [observations...]\n", argv[0]);
+        return 1;
+    }
+    std::vector<Observation> observations;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!ReadObservations(argv[i], observations))
+            return 1;
+    }
+    if(observations.empty())
+    {
+        std::fprintf(stderr, "No observations found.\n");
+        return 1;
+    }
+    double intercept, slope;
+    if(!FitDelivery(observations, intercept, slope))
+    {
+        std::fprintf(stderr, "Delivery does not fall away with distance within these observations, record runs with "
+                             "vehicles further apart.\n");
+        return 1;
+    }
+    double range = -intercept / slope;
+    double fade = -1.0 / slope;
+    double latency, latency_per_metre;
+    FitLatency(observations, latency, latency_per_metre);
+    std::printf("%zu observations\n\n%10s %10s %10s %10s\n", observations.size(), "Distance", "Exchanges", "Observed",
+                "Fitted");
+    const double bin_width = 25;
+    std::vector<double> exchanges, delivered;
+    for(const auto& observation : observations)
+    {
+        size_t bin = (size_t)(observation.Distance / bin_width);
+        if(bin >= exchanges.size())
+        {
+            exchanges.resize(bin + 1, 0);
+            delivered.resize(bin + 1, 0);
+        }
+        exchanges.at(bin)++;
+        delivered.at(bin) += observation.Delivered ? 1 : 0;
+    }
+    for(size_t i = 0; i < exchanges.size(); i++)
+    {
+        if(exchanges.at(i) == 0)
+            continue;
+        double distance = (i + 0.5) * bin_width;
+        std::printf("%10.0f %10.0f %10.3f %10.3f\n", distance, exchanges.at(i), delivered.at(i) / exchanges.at(i),
+                    1.0 / (1.0 + std::exp((distance - range) / fade)));
+    }
+    std::printf("\n--abstract-network=true --abstract-range=%.2f --abstract-fade=%.2f --abstract-latency=%.4f "
+                "--abstract-latency-per-metre=%.6f\n", range, fade, latency, latency_per_metre);
+    return 0;
+}
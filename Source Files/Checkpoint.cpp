@@ -0,0 +1,121 @@
+#include "../Header Files/Checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    const char Checkpoint_Magic[8] = {'C', 'O', 'S', 'I', 'C', 'K', 'P', 'T'};
+    const uint32_t Checkpoint_Version = 1;
+
+    /**
+     * Replace a file with new contents by writing them to a temporary file and renaming it over the original, so that
+     * a crash part way through never leaves a partial file behind.
+     */
+    bool WriteAtomically(const std::string& URL, const std::string& Contents)
+    {
+        std::string temporary_url = URL + ".tmp";
+        FILE* file = std::fopen(temporary_url.c_str(), "wb");
+        if(file == nullptr)
+        {
+            std::perror(temporary_url.c_str());
+            return false;
+        }
+        bool written = std::fwrite(Contents.data(), 1, Contents.size(), file) == Contents.size();
+        written = std::fclose(file) == 0 && written;
+        return written && std::rename(temporary_url.c_str(), URL.c_str()) == 0;
+    }
+}
+
+/**
+ * Write the checkpoint to the given directory and point the directory's latest file at it.
+ * @param Directory Directory the checkpoint is written to.
+ * @param Write_Vehicle_IDs Whether the identifiers of the vehicles have changed since they were last written.
+ * @return True if the checkpoint was written.
+ */
+bool Checkpoint::Write(std::string Directory, bool Write_Vehicle_IDs)
+{
+    if(Write_Vehicle_IDs)
+    {
+        std::string vehicle_ids;
+        for(const auto& id : this->Vehicle_IDs)
+            vehicle_ids.append(id).append("\n");
+        if(!WriteAtomically(Directory + "/vehicles.txt", vehicle_ids))
+            return false;
+    }
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(CheckpointHeader));
+    std::memcpy(header.Magic, Checkpoint_Magic, sizeof(Checkpoint_Magic));
+    header.Version = Checkpoint_Version;
+    header.Vehicle_Count = (uint32_t)this->Vehicles.size();
+    header.Time = this->Time;
+    header.Selection_Delay = this->Selection_Delay;
+    header.Random_State_Length = (uint32_t)this->Random_State.size();
+    header.SUMO_State_Length = (uint32_t)this->SUMO_State_URL.size();
+    std::string contents((const char*)&header, sizeof(CheckpointHeader));
+    contents.append(this->Random_State);
+    contents.append(this->SUMO_State_URL);
+    contents.append((const char*)this->Vehicles.data(), this->Vehicles.size() * sizeof(CheckpointVehicle));
+    std::string url = GetURL(Directory, this->Time, ".bin");
+    return WriteAtomically(url, contents) && WriteAtomically(Directory + "/latest", url + "\n");
+}
+
+/**
+ * Read a checkpoint along with the identifiers of its vehicles.
+ * @param URL Name of the checkpoint file, or of a checkpoint directory in which case its latest checkpoint is read.
+ * @return True if the checkpoint could be read.
+ */
+bool Checkpoint::Read(std::string URL)
+{
+    std::ifstream latest(URL + "/latest");
+    if(latest)
+        std::getline(latest, URL);
+    std::ifstream file(URL, std::ios::binary);
+    CheckpointHeader header;
+    if(!file.read((char*)&header, sizeof(CheckpointHeader)) ||
+       std::memcmp(header.Magic, Checkpoint_Magic, sizeof(Checkpoint_Magic)) != 0 ||
+       header.Version != Checkpoint_Version)
+    {
+        std::fprintf(stderr, "%s is not a checkpoint.\n", URL.c_str());
+        return false;
+    }
+    this->Time = header.Time;
+    this->Selection_Delay = header.Selection_Delay;
+    this->Random_State.resize(header.Random_State_Length);
+    this->SUMO_State_URL.resize(header.SUMO_State_Length);
+    this->Vehicles.resize(header.Vehicle_Count);
+    file.read(&this->Random_State[0], this->Random_State.size());
+    file.read(&this->SUMO_State_URL[0], this->SUMO_State_URL.size());
+    file.read((char*)this->Vehicles.data(), this->Vehicles.size() * sizeof(CheckpointVehicle));
+    if(!file)
+    {
+        std::fprintf(stderr, "%s is incomplete.\n", URL.c_str());
+        return false;
+    }
+    size_t slash = URL.rfind('/');
+    std::ifstream vehicle_ids((slash == std::string::npos ? "." : URL.substr(0, slash)) + "/vehicles.txt");
+    std::string id;
+    this->Vehicle_IDs.clear();
+    while(std::getline(vehicle_ids, id))
+        this->Vehicle_IDs.push_back(id);
+    if(this->Vehicle_IDs.size() != this->Vehicles.size())
+    {
+        std::fprintf(stderr, "%s does not match the vehicles of its directory.\n", URL.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Get the name of a file belonging to the checkpoint taken at the given time.
+ * @param Directory Directory of the checkpoint.
+ * @param Time Simulation time the checkpoint was taken at in seconds.
+ * @param Extension Extension of the file.
+ * @return Name of the file.
+ */
+std::string Checkpoint::GetURL(std::string Directory, double Time, std::string Extension)
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "/checkpoint-%010.1f", Time);
+    return Directory + name + Extension;
+}
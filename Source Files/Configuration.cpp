@@ -1,4 +1,6 @@
 #include "../Header Files/Configuration.h"
+#include <sstream>
+#include <algorithm>
 
 Configuration::Configuration(int argc, char** argv)
 {
@@ -10,9 +12,9 @@ Configuration::Configuration(int argc, char** argv)
                                 ns3::MakeCallback(&Configuration::SetRemoteAddress, this));
     this->command_line.AddValue("remote-port", "Remote port used to connect to the TraCIAPI server.",
                                 ns3::MakeCallback(&Configuration::SetRemotePort, this));
-    this->command_line.AddValue("animate", "Enable the NS-3 animation trace. Requires a XML file name.",
+    this->command_line.AddValue("animate", "Write a NetAnim trace to the given file, gzipped if it ends .gz.",
                                 ns3::MakeCallback(&Configuration::SetAnimate, this));
-    this->command_line.AddValue("selection-lanes", "Set the lanes where vehicles maybe selected from to change lane.",
+    this->command_line.AddValue("selection-lanes", "Lanes vehicles may be selected from, as digits or comma separated.",
                                 ns3::MakeCallback(&Configuration::SetSelectionLanes, this));
     this->command_line.AddValue("selection-probability", "Set the probability maybe picked to change lane.",
                                 ns3::MakeCallback(&Configuration::SetSelectionProbability, this));
@@ -20,7 +22,7 @@ Configuration::Configuration(int argc, char** argv)
                                 ns3::MakeCallback(&Configuration::SetSelectionInterval, this));
     this->command_line.AddValue("seed", "Set the seed for the RNG.",
                                 ns3::MakeCallback(&Configuration::SetSeed, this));
-    this->command_line.AddValue("speed-limits", "Set the speed for each of the five lanes. (ms/s).",
+    this->command_line.AddValue("speed-limits", "Speed limit of each lane by index in m/s, otherwise the network's.",
                                 ns3::MakeCallback(&Configuration::SetSpeedLimits, this));
     this->command_line.AddValue("lane-change-output", "Set the name of lane change output generated by SUMO.",
                                 ns3::MakeCallback(&Configuration::SetLaneChangeOutput, this));
@@ -28,9 +30,112 @@ Configuration::Configuration(int argc, char** argv)
                                 ns3::MakeCallback(&Configuration::SetTripInfoOutput, this));
     this->command_line.AddValue("use-enhanced", "Set to 'true' is you wish to simulate with ILACH-Plus otherwise ILACH.",
                                 ns3::MakeCallback(&Configuration::SetUseEnhanced, this));
+    this->command_line.AddValue("profile", "Enable phase timing and counters. Requires a JSON (or .csv) file name.",
+                                ns3::MakeCallback(&Configuration::SetProfile, this));
+    this->command_line.AddValue("telemetry", "Publish live statistics to the named shared memory segment.",
+                                ns3::MakeCallback(&Configuration::SetTelemetry, this));
+    this->command_line.AddValue("record-trajectory", "Record the state of every vehicle at each step to a file.",
+                                ns3::MakeCallback(&Configuration::SetRecordTrajectory, this));
+    this->command_line.AddValue("replay-trajectory", "Feed mobility from a recorded trajectory instead of SUMO.",
+                                ns3::MakeCallback(&Configuration::SetReplayTrajectory, this));
+    this->command_line.AddValue("traci-capture", "Record every message exchanged with SUMO to the given file.",
+                                ns3::MakeCallback(&Configuration::SetTraCICapture, this));
+    this->command_line.AddValue("variants", "Fork one replication per line of the given file after initialisation.",
+                                ns3::MakeCallback(&Configuration::SetVariants, this));
+    this->command_line.AddValue("warmup", "Simulate this many seconds in SUMO alone before forking replications.",
+                                ns3::MakeCallback(&Configuration::SetWarmup, this));
+    this->command_line.AddValue("sumo-binary", "SUMO executable launched for each replication or by launch-sumo.",
+                                ns3::MakeCallback(&Configuration::SetSUMOBinary, this));
+    this->command_line.AddValue("checkpoint", "Periodically checkpoint the simulation to the given directory.",
+                                ns3::MakeCallback(&Configuration::SetCheckpoint, this));
+    this->command_line.AddValue("checkpoint-interval", "Simulated seconds between each checkpoint.",
+                                ns3::MakeCallback(&Configuration::SetCheckpointInterval, this));
+    this->command_line.AddValue("restore", "Resume from a checkpoint file or the latest within a directory.",
+                                ns3::MakeCallback(&Configuration::SetRestore, this));
+    this->command_line.AddValue("road-length", "Length of road divided between processes when distributed.",
+                                ns3::MakeCallback(&Configuration::SetRoadLength, this));
+    this->command_line.AddValue("halo-width", "Distance beyond its partition each process simulates vehicles for.",
+                                ns3::MakeCallback(&Configuration::SetHaloWidth, this));
+    this->command_line.AddValue("abstract-network", "Replace the 802.11p network with a fast abstraction [true|false].",
+                                ns3::MakeCallback(&Configuration::SetAbstractNetwork, this));
+    this->command_line.AddValue("abstract-range", "Distance in metres at which half of all abstract exchanges succeed.",
+                                ns3::MakeCallback(&Configuration::SetAbstractRange, this));
+    this->command_line.AddValue("abstract-fade", "Distance in metres over which abstract exchanges fade out.",
+                                ns3::MakeCallback(&Configuration::SetAbstractFade, this));
+    this->command_line.AddValue("abstract-latency", "Latency of an abstract exchange in milliseconds.",
+                                ns3::MakeCallback(&Configuration::SetAbstractLatency, this));
+    this->command_line.AddValue("abstract-latency-per-metre", "Latency added to an abstract exchange per metre.",
+                                ns3::MakeCallback(&Configuration::SetAbstractLatencyPerMetre, this));
+    this->command_line.AddValue("calibration-output", "Record each exchange over the network for calibration.",
+                                ns3::MakeCallback(&Configuration::SetCalibrationOutput, this));
+    this->command_line.AddValue("metrics", "Write negotiation and trip metrics to the given file (.csv or binary).",
+                                ns3::MakeCallback(&Configuration::SetMetrics, this));
+    this->command_line.AddValue("digest", "Record a canonical digest of the events of the run to the given file.",
+                                ns3::MakeCallback(&Configuration::SetDigest, this));
+    this->command_line.AddValue("memory-report", "Write the memory used by each part of a vehicle to the given file.",
+                                ns3::MakeCallback(&Configuration::SetMemoryReport, this));
+    this->command_line.AddValue("memory-budget", "Fail the run if it grows by more than these bytes per vehicle.",
+                                ns3::MakeCallback(&Configuration::SetMemoryBudget, this));
+    this->command_line.AddValue("count-allocations", "Count the allocations made within each profiled phase.",
+                                ns3::MakeCallback(&Configuration::SetCountAllocations, this));
+    this->command_line.AddValue("legacy-propagation", "Compute propagation loss with the stock log-distance model.",
+                                ns3::MakeCallback(&Configuration::SetLegacyPropagation, this));
+    this->command_line.AddValue("packet-trace", "Record the packets of the vehicles to the given file, see SIGUSR1.",
+                                ns3::MakeCallback(&Configuration::SetPacketTrace, this));
+    this->command_line.AddValue("packet-trace-capacity", "Number of the most recent packets the trace holds.",
+                                ns3::MakeCallback(&Configuration::SetPacketTraceCapacity, this));
+    this->command_line.AddValue("packet-trace-nodes", "Only trace the packets of one in every this many nodes.",
+                                ns3::MakeCallback(&Configuration::SetPacketTraceNodes, this));
+    this->command_line.AddValue("packet-trace-start", "Simulation time in seconds the packet trace begins at.",
+                                ns3::MakeCallback(&Configuration::SetPacketTraceStart, this));
+    this->command_line.AddValue("packet-trace-stop", "Simulation time in seconds the packet trace ends at.",
+                                ns3::MakeCallback(&Configuration::SetPacketTraceStop, this));
+    this->command_line.AddValue("launch-sumo", "Launch and own SUMO upon a free port instead of connecting to one.",
+                                ns3::MakeCallback(&Configuration::SetLaunchSUMO, this));
+    this->command_line.AddValue("sumo-cpus", "CPUs a launched SUMO is pinned to and NS-3 avoids, e.g. 2,3 or 2-3.",
+                                ns3::MakeCallback(&Configuration::SetSUMOCPUs, this));
+    this->command_line.AddValue("realtime", "Drive the co-simulation against wall time with the real-time simulator.",
+                                ns3::MakeCallback(&Configuration::SetRealtime, this));
+    this->command_line.AddValue("deadline-report", "Output file of the slack and misses of each step's deadline.",
+                                ns3::MakeCallback(&Configuration::SetDeadlineReport, this));
+    this->command_line.AddValue("degrade-mobility", "When behind wall time, move idle vehicles every N steps only.",
+                                ns3::MakeCallback(&Configuration::SetDegradeMobility, this));
+    this->command_line.AddValue("lane-count", "Number of lanes of every edge, when not read from the network file.",
+                                ns3::MakeCallback(&Configuration::SetLaneCount, this));
+    this->command_line.AddValue("animate-start", "Simulation time in seconds the animation trace begins at.",
+                                ns3::MakeCallback(&Configuration::SetAnimationStart, this));
+    this->command_line.AddValue("animate-stop", "Simulation time in seconds the animation trace ends at.",
+                                ns3::MakeCallback(&Configuration::SetAnimationStop, this));
+    this->command_line.AddValue("animate-interval", "Simulated seconds between each position update.",
+                                ns3::MakeCallback(&Configuration::SetAnimationInterval, this));
+    this->command_line.AddValue("animate-radius", "Only animate vehicles within this many metres of a negotiation.",
+                                ns3::MakeCallback(&Configuration::SetAnimationRadius, this));
+    this->command_line.AddValue("animate-packets", "Record packets within the animation trace [true|false].",
+                                ns3::MakeCallback(&Configuration::SetAnimationPackets, this));
+    this->command_line.AddValue("animate-metadata", "Record the content of each packet [true|false].",
+                                ns3::MakeCallback(&Configuration::SetAnimationMetadata, this));
+    this->command_line.AddValue("animate-legacy", "Use NS-3's own AnimationInterface instead [true|false].",
+                                ns3::MakeCallback(&Configuration::SetAnimationLegacy, this));
+    this->command_line.AddValue("legacy-selection", "Draw for every vehicle when selecting as before [true|false].",
+                                ns3::MakeCallback(&Configuration::SetLegacySelection, this));
+    this->command_line.AddValue("step-threads", "Threads sharing the per-vehicle work of each step, 0 for all.",
+                                ns3::MakeCallback(&Configuration::SetStepThreads, this));
     this->command_line.Parse(argc, argv);
 }
 
+/**
+ * Apply further command line arguments on top of the current configuration.
+ * @param Arguments Arguments in the same form as those given upon the command line.
+ */
+void Configuration::Parse(const std::vector<std::string>& Arguments)
+{
+    std::vector<char*> argv = {const_cast<char*>("Cosimulation")};
+    for(const auto& argument : Arguments)
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+    this->command_line.Parse((int)argv.size() - 1, argv.data());
+}
+
 bool Configuration::SetStepLength(std::string Value)
 {
     this->Step_Length = std::stod(Value);
@@ -63,10 +168,28 @@ bool Configuration::SetAnimate(std::string Value)
 
 bool Configuration::SetSelectionLanes(std::string Value)
 {
-    for(auto c : Value)
+    this->Selection_Lanes.clear();
+    std::vector<size_t> lanes;
+    if(Value.find(',') != std::string::npos)
     {
-        if(!isspace(c))
-            this->Selection_Lanes.set((size_t)c - 48, true);
+        std::stringstream stream(Value);
+        std::string lane;
+        while(std::getline(stream, lane, ','))
+            lanes.push_back(std::stoul(lane));
+    }
+    else
+    {
+        for(auto c : Value)
+        {
+            if(!isspace(c))
+                lanes.push_back((size_t)c - 48);
+        }
+    }
+    for(size_t lane : lanes)
+    {
+        if(lane >= this->Selection_Lanes.size())
+            this->Selection_Lanes.resize(lane + 1, false);
+        this->Selection_Lanes.at(lane) = true;
     }
     return true;
 }
@@ -92,21 +215,11 @@ bool Configuration::SetSeed(std::string Value)
 bool Configuration::SetSpeedLimits(std::string Value)
 {
     this->Lane_Speed_Limits.clear();
-    std::string speed;
-    for(char c : Value)
-    {
-        if(!isspace(c))
-        {
-            speed.append(std::to_string(c - 48));
-        }
-        else
-        {
-            this->Lane_Speed_Limits.push_back(std::stod(speed));
-            speed.clear();
-        }
-    }
-    this->Lane_Speed_Limits.push_back(std::stod(speed));
-    speed.clear();
+    std::replace(Value.begin(), Value.end(), ',', ' ');
+    std::stringstream stream(Value);
+    double speed;
+    while(stream >> speed)
+        this->Lane_Speed_Limits.push_back(speed);
     return true;
 }
 
@@ -123,7 +236,285 @@ bool Configuration::SetTripInfoOutput(std::string Value)
 }
 
 bool Configuration::SetUseEnhanced(std::string Value) {
-    if(Value == "true")
-        this->Use_Enhanced = true;
+    this->Use_Enhanced = Value == "true";
+    return true;
+}
+
+bool Configuration::SetProfile(std::string Value)
+{
+    this->Profile_URL = Value;
+    return true;
+}
+
+bool Configuration::SetTelemetry(std::string Value)
+{
+    this->Telemetry_Name = Value;
+    return true;
+}
+
+bool Configuration::SetRecordTrajectory(std::string Value)
+{
+    this->Trajectory_URL = Value;
     return true;
-}
\ No newline at end of file
+}
+
+bool Configuration::SetReplayTrajectory(std::string Value)
+{
+    this->Replay_URL = Value;
+    return true;
+}
+
+bool Configuration::SetTraCICapture(std::string Value)
+{
+    this->TraCI_Capture_URL = Value;
+    return true;
+}
+
+bool Configuration::SetVariants(std::string Value)
+{
+    this->Variants_URL = Value;
+    return true;
+}
+
+bool Configuration::SetWarmup(std::string Value)
+{
+    this->Warmup_Time = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetSUMOBinary(std::string Value)
+{
+    this->SUMO_Binary = Value;
+    return true;
+}
+
+bool Configuration::SetCheckpoint(std::string Value)
+{
+    this->Checkpoint_Directory = Value;
+    return true;
+}
+
+bool Configuration::SetCheckpointInterval(std::string Value)
+{
+    this->Checkpoint_Interval = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetRestore(std::string Value)
+{
+    this->Restore_URL = Value;
+    return true;
+}
+bool Configuration::SetRoadLength(std::string Value)
+{
+    this->Road_Length = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetHaloWidth(std::string Value)
+{
+    this->Halo_Width = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAbstractNetwork(std::string Value)
+{
+    this->Abstract_Network = Value == "true";
+    return true;
+}
+
+bool Configuration::SetAbstractRange(std::string Value)
+{
+    this->Abstract_Range = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAbstractFade(std::string Value)
+{
+    this->Abstract_Fade = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAbstractLatency(std::string Value)
+{
+    this->Abstract_Latency = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAbstractLatencyPerMetre(std::string Value)
+{
+    this->Abstract_Latency_Per_Metre = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetCalibrationOutput(std::string Value)
+{
+    this->Calibration_Output = Value;
+    return true;
+}
+
+bool Configuration::SetMetrics(std::string Value)
+{
+    this->Metrics_URL = Value;
+    return true;
+}
+
+bool Configuration::SetAnimationStart(std::string Value)
+{
+    this->Animation_Start = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAnimationStop(std::string Value)
+{
+    this->Animation_Stop = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAnimationInterval(std::string Value)
+{
+    this->Animation_Interval = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAnimationRadius(std::string Value)
+{
+    this->Animation_Radius = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetAnimationPackets(std::string Value)
+{
+    this->Animation_Packets = Value == "true";
+    return true;
+}
+
+bool Configuration::SetAnimationMetadata(std::string Value)
+{
+    this->Animation_Metadata = Value == "true";
+    return true;
+}
+
+bool Configuration::SetAnimationLegacy(std::string Value)
+{
+    this->Animation_Legacy = Value == "true";
+    return true;
+}
+
+bool Configuration::SetLegacySelection(std::string Value)
+{
+    this->Legacy_Selection = Value == "true";
+    return true;
+}
+
+bool Configuration::SetStepThreads(std::string Value)
+{
+    this->Step_Threads = (unsigned int)std::stoul(Value);
+    return true;
+}
+
+bool Configuration::SetDigest(std::string Value)
+{
+    this->Digest_URL = Value;
+    return true;
+}
+
+bool Configuration::SetMemoryReport(std::string Value)
+{
+    this->Memory_URL = Value;
+    return true;
+}
+
+bool Configuration::SetMemoryBudget(std::string Value)
+{
+    this->Memory_Budget = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetCountAllocations(std::string Value)
+{
+    this->Count_Allocations = Value == "true";
+    return true;
+}
+
+bool Configuration::SetLegacyPropagation(std::string Value)
+{
+    this->Legacy_Propagation = Value == "true";
+    return true;
+}
+
+bool Configuration::SetPacketTrace(std::string Value)
+{
+    this->Packet_Trace_URL = Value;
+    return true;
+}
+
+bool Configuration::SetPacketTraceCapacity(std::string Value)
+{
+    this->Packet_Trace_Capacity = std::stoul(Value);
+    return true;
+}
+
+bool Configuration::SetPacketTraceNodes(std::string Value)
+{
+    this->Packet_Trace_Nodes = (unsigned int)std::stoul(Value);
+    return true;
+}
+
+bool Configuration::SetPacketTraceStart(std::string Value)
+{
+    this->Packet_Trace_Start = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetPacketTraceStop(std::string Value)
+{
+    this->Packet_Trace_Stop = std::stod(Value);
+    return true;
+}
+
+bool Configuration::SetLaunchSUMO(std::string Value)
+{
+    this->Launch_SUMO = Value == "true";
+    return true;
+}
+
+bool Configuration::SetSUMOCPUs(std::string Value)
+{
+    this->SUMO_CPUs.clear();
+    std::stringstream stream(Value);
+    std::string range;
+    while(std::getline(stream, range, ','))
+    {
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for(int cpu = first; cpu <= last; cpu++)
+            this->SUMO_CPUs.push_back(cpu);
+    }
+    return true;
+}
+
+bool Configuration::SetRealtime(std::string Value)
+{
+    this->Realtime = Value == "true";
+    return true;
+}
+
+bool Configuration::SetDeadlineReport(std::string Value)
+{
+    this->Deadline_URL = Value;
+    return true;
+}
+
+bool Configuration::SetDegradeMobility(std::string Value)
+{
+    this->Degrade_Mobility = (unsigned int)std::stoul(Value);
+    return true;
+}
+
+bool Configuration::SetLaneCount(std::string Value)
+{
+    this->Lane_Count = std::stoi(Value);
+    return true;
+}
@@ -0,0 +1,126 @@
+#include "../Header Files/DeadlineMonitor.h"
+#include <cstdio>
+#include <algorithm>
+
+namespace
+{
+    /**
+     * Convert a duration to milliseconds.
+     */
+    double ToMilliseconds(DeadlineMonitor::Clock::duration Duration)
+    {
+        return std::chrono::duration<double, std::milli>(Duration).count();
+    }
+}
+
+/**
+ * Get the deadline monitor shared by the whole run.
+ * @return The deadline monitor.
+ */
+DeadlineMonitor& DeadlineMonitor::Instance()
+{
+    static DeadlineMonitor instance;
+    return instance;
+}
+
+/**
+ * Enable or disable the accounting of step deadlines.
+ * @param Enabled Whether deadlines should be accounted for.
+ * @param Step_Length Length of a step in seconds, which each step must finish within.
+ */
+void DeadlineMonitor::Enable(bool Enabled, double Step_Length)
+{
+    this->enabled = Enabled;
+    this->step_length = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(Step_Length));
+}
+
+/**
+ * Mark the beginning of a step, measuring how late it began and so whether the co-simulation is behind wall time. The
+ * wall time of the first step is taken as the origin all others are due relative to.
+ * @param Time Simulation time of the step in seconds.
+ */
+void DeadlineMonitor::BeginStep(double Time)
+{
+    if(!this->enabled)
+        return;
+    Clock::time_point now = Clock::now();
+    Clock::duration offset = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(Time));
+    if(!this->started)
+    {
+        this->origin = now - offset;
+        this->started = true;
+    }
+    this->step_time = Time;
+    this->deadline = this->origin + offset + this->step_length;
+    this->lateness = now - (this->origin + offset);
+    this->worst_lateness_ms = std::max(this->worst_lateness_ms, ToMilliseconds(this->lateness));
+    this->behind = this->lateness * 10 > this->step_length || this->last_slack < Clock::duration::zero();
+}
+
+/**
+ * Mark the end of a step, recording its slack and, should it have the least slack so far, the phases it spent its time
+ * within.
+ * @param Degraded Whether the step was carried out with degraded fidelity.
+ */
+void DeadlineMonitor::EndStep(bool Degraded)
+{
+    if(!this->enabled || !this->started)
+        return;
+    this->last_slack = this->deadline - Clock::now();
+    double slack_ms = ToMilliseconds(this->last_slack);
+    if(this->slacks_ms.empty() || slack_ms < this->worst_slack_ms)
+    {
+        this->worst_slack_ms = slack_ms;
+        this->worst_time = this->step_time;
+        this->worst_phases = this->step_phases;
+    }
+    this->slacks_ms.push_back(slack_ms);
+    this->misses += slack_ms < 0;
+    this->degraded_steps += Degraded;
+    this->step_phases.fill(Clock::duration::zero());
+}
+
+/**
+ * Write the report of the step deadlines if enabled. Phases nest within one another and so the phases of the step with
+ * the least slack are inclusive, as they are within the profile.
+ * @param URL Name of the report file.
+ * @return True if the report was written or there was nothing to write.
+ */
+bool DeadlineMonitor::Write(std::string URL)
+{
+    if(!this->enabled || URL.empty())
+        return true;
+    FILE* file = std::fopen(URL.c_str(), "w");
+    if(file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    std::vector<double> sorted = this->slacks_ms;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double Fraction) -> double
+    {
+        if(sorted.empty())
+            return 0;
+        return sorted.at(std::min(sorted.size() - 1, (size_t)(Fraction * (sorted.size() - 1) + 0.5)));
+    };
+    std::fprintf(file, "section,name,value\n");
+    std::fprintf(file, "run,step_ms,%.6f\n", ToMilliseconds(this->step_length));
+    std::fprintf(file, "run,steps,%zu\n", sorted.size());
+    std::fprintf(file, "run,misses,%llu\n", (unsigned long long)this->misses);
+    std::fprintf(file, "run,degraded_steps,%llu\n", (unsigned long long)this->degraded_steps);
+    std::fprintf(file, "run,worst_lateness_ms,%.6f\n", this->worst_lateness_ms);
+    const double fractions[] = {0.0, 0.01, 0.1, 0.5};
+    const char* fraction_names[] = {"min", "p1", "p10", "p50"};
+    for(int i = 0; i < 4; i++)
+        std::fprintf(file, "slack_ms,%s,%.6f\n", fraction_names[i], percentile(fractions[i]));
+    std::fprintf(file, "worst_step,time_seconds,%.6f\n", this->worst_time);
+    std::fprintf(file, "worst_step,slack_ms,%.6f\n", this->worst_slack_ms);
+    for(int i = 0; i < Profiler::Phase_Count; i++)
+    {
+        std::fprintf(file, "worst_step_phase_ms,%s,%.6f\n", Profiler::PhaseName((Profiler::Phase)i),
+                     ToMilliseconds(this->worst_phases[i]));
+    }
+    std::fclose(file);
+    return true;
+}
@@ -0,0 +1,222 @@
+#include "../Header Files/EventDigest.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <dirent.h>
+#include <algorithm>
+#include <sys/stat.h>
+
+namespace
+{
+    /**
+     * Determine if the given path is a directory.
+     */
+    bool IsDirectory(const std::string& URL)
+    {
+        struct stat status;
+        return stat(URL.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+    }
+
+    /**
+     * List the entries of a directory beginning with the given prefix, in a stable order.
+     */
+    std::vector<std::string> ListDirectory(const std::string& URL, const std::string& Prefix)
+    {
+        std::vector<std::string> entries;
+        DIR* directory = opendir(URL.c_str());
+        if(directory == nullptr)
+            return entries;
+        while(dirent* entry = readdir(directory))
+        {
+            std::string name = entry->d_name;
+            if(name.compare(0, Prefix.size(), Prefix) == 0)
+                entries.push_back(name);
+        }
+        closedir(directory);
+        std::sort(entries.begin(), entries.end());
+        return entries;
+    }
+
+    /**
+     * Copy a file, replacing the destination.
+     */
+    bool CopyFile(const std::string& From, const std::string& To)
+    {
+        std::ifstream source(From, std::ios::binary);
+        std::ofstream destination(To, std::ios::binary | std::ios::trunc);
+        if(!source || !destination)
+        {
+            std::fprintf(stderr, "Unable to copy %s to %s\n", From.c_str(), To.c_str());
+            return false;
+        }
+        destination << source.rdbuf();
+        return (bool)destination;
+    }
+
+    /**
+     * Compare two digests, reporting the first event upon which they differ. Digests whose headers, holding the count
+     * and hash of their events, are the same are taken to be identical without reading further.
+     */
+    bool CompareExactly(const std::string& Name, const std::string& Golden_URL, const std::string& Candidate_URL)
+    {
+        std::ifstream golden(Golden_URL);
+        std::ifstream candidate(Candidate_URL);
+        std::string golden_line;
+        std::string candidate_line;
+        bool same_header = true;
+        for(size_t line = 1; ; line++)
+        {
+            bool golden_read = (bool)std::getline(golden, golden_line);
+            bool candidate_read = (bool)std::getline(candidate, candidate_line);
+            bool same = golden_read == candidate_read && golden_line == candidate_line;
+            if(line <= 2)
+            {
+                same_header &= same;
+                if(line == 2 && same_header)
+                    return true;
+                continue;
+            }
+            if(!golden_read && !candidate_read)
+            {
+                std::printf("%s: differs within its header\n", Name.c_str());
+                return false;
+            }
+            if(!same)
+            {
+                std::printf("%s: differs at line %zu\n    golden:    %s\n    candidate: %s\n", Name.c_str(), line,
+                            golden_read ? golden_line.c_str() : "<end>",
+                            candidate_read ? candidate_line.c_str() : "<end>");
+                return false;
+            }
+        }
+    }
+
+    /**
+     * Check that a statistic of the candidate lies within the relative tolerance of the golden value.
+     */
+    bool IsWithin(const std::string& Name, const char* Statistic, double Golden, double Candidate, double Tolerance)
+    {
+        double difference = std::fabs(Candidate - Golden);
+        if(difference <= Tolerance * std::fabs(Golden) || difference == 0)
+            return true;
+        std::printf("%s: %s is %.6g, golden %.6g\n", Name.c_str(), Statistic, Candidate, Golden);
+        return false;
+    }
+
+    /**
+     * Compare the totals of two digests, allowing each to differ from the golden value by the relative tolerance.
+     */
+    bool CompareApproximately(const std::string& Name, const std::string& Golden_URL,
+                              const std::string& Candidate_URL, double Tolerance)
+    {
+        EventDigest::Summary golden;
+        EventDigest::Summary candidate;
+        if(!EventDigest::Summarise(Golden_URL, golden) || !EventDigest::Summarise(Candidate_URL, candidate))
+            return false;
+        bool within = true;
+        for(int i = 0; i < EventDigest::Event_Count; i++)
+        {
+            within &= IsWithin(Name, EventDigest::EventName((EventDigest::Event)i), golden.Counts[i],
+                               candidate.Counts[i], Tolerance);
+        }
+        within &= IsWithin(Name, "recommendations_accepted", golden.Recommendations_Accepted,
+                           candidate.Recommendations_Accepted, Tolerance);
+        uint64_t golden_trips = std::max<uint64_t>(golden.Counts[EventDigest::Arrival], 1);
+        uint64_t candidate_trips = std::max<uint64_t>(candidate.Counts[EventDigest::Arrival], 1);
+        within &= IsWithin(Name, "mean_travel_time_s", golden.Travel_Time_Sum_S / golden_trips,
+                           candidate.Travel_Time_Sum_S / candidate_trips, Tolerance);
+        return within;
+    }
+}
+
+/**
+ * Compare the event digests of a run, or of every run of a sweep, against stored golden digests. Without a tolerance
+ * the digests must be identical. With one, intended for fast paths that are knowingly approximate, the count of each
+ * event, the number of recommendations accepted and the mean travel time may each differ from the golden value by the
+ * given fraction. Golden digests of a sweep are stored as run-NNNNNN-digest.txt along with the parameters of the run,
+ * and are replaced by those of the sweep with --update.
+ * Usage: CosimulationDigest <golden digest or directory> <candidate digest or sweep results> [--tolerance=F] [--update]
+ */
+int main(int argc, char** argv)
+{
+    double tolerance = -1;
+    bool update = false;
+    std::vector<std::string> paths;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if(argument.compare(0, 12, "--tolerance=") == 0)
+            tolerance = std::stod(argument.substr(12));
+        else if(argument == "--update")
+            update = true;
+        else
+            paths.push_back(argument);
+    }
+    if(paths.size() != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <golden digest or directory> <candidate digest or sweep results> "
+                             "[--tolerance=F] [--update]\n", argv[0]);
+        return 1;
+    }
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::string golden_url = paths.at(0);
+    std::string candidate_url = paths.at(1);
+    if(!IsDirectory(candidate_url))
+        pairs.push_back(std::make_pair(golden_url, candidate_url));
+    else if(update)
+    {
+        mkdir(golden_url.c_str(), 0755);
+        for(const auto& run : ListDirectory(candidate_url, "run-"))
+        {
+            std::string directory = candidate_url + "/" + run;
+            if(!CopyFile(directory + "/digest.txt", golden_url + "/" + run + "-digest.txt") ||
+               !CopyFile(directory + "/parameters.txt", golden_url + "/" + run + "-parameters.txt"))
+                return 1;
+            std::printf("%s updated\n", run.c_str());
+        }
+        return 0;
+    }
+    else
+    {
+        for(const auto& name : ListDirectory(golden_url, "run-"))
+        {
+            std::string suffix = "-digest.txt";
+            if(name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+                continue;
+            std::string run = name.substr(0, name.size() - suffix.size());
+            std::ifstream golden_parameters(golden_url + "/" + run + "-parameters.txt");
+            std::ifstream candidate_parameters(candidate_url + "/" + run + "/parameters.txt");
+            std::string golden_text((std::istreambuf_iterator<char>(golden_parameters)),
+                                    std::istreambuf_iterator<char>());
+            std::string candidate_text((std::istreambuf_iterator<char>(candidate_parameters)),
+                                       std::istreambuf_iterator<char>());
+            if(golden_text != candidate_text)
+            {
+                std::fprintf(stderr, "%s was run with different parameters, the golden digests must be updated.\n",
+                             run.c_str());
+                return 1;
+            }
+            pairs.push_back(std::make_pair(golden_url + "/" + name, candidate_url + "/" + run + "/digest.txt"));
+        }
+        if(pairs.empty())
+        {
+            std::fprintf(stderr, "No golden digests within %s, create them with --update.\n", golden_url.c_str());
+            return 1;
+        }
+    }
+    if(update)
+        return CopyFile(candidate_url, golden_url) ? 0 : 1;
+    size_t failures = 0;
+    for(const auto& pair : pairs)
+    {
+        std::string name = pair.second;
+        bool matches = tolerance < 0 ? CompareExactly(name, pair.first, pair.second)
+                                     : CompareApproximately(name, pair.first, pair.second, tolerance);
+        if(!matches)
+            failures++;
+    }
+    std::printf("%zu of %zu digests match\n", pairs.size() - failures, pairs.size());
+    return failures == 0 ? 0 : 1;
+}
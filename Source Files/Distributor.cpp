@@ -0,0 +1,236 @@
+#include "../Header Files/Distributor.h"
+
+#ifdef COSIMULATION_MPI
+
+#include <mpi.h>
+#include <cstring>
+
+namespace
+{
+    template<typename T>
+    void Append(std::vector<char>& Buffer, const T& Value)
+    {
+        const char* data = (const char*)&Value;
+        Buffer.insert(Buffer.end(), data, data + sizeof(T));
+    }
+
+    template<typename T>
+    T Extract(const std::vector<char>& Buffer, size_t& Offset)
+    {
+        T value;
+        std::memcpy(&value, Buffer.data() + Offset, sizeof(T));
+        Offset += sizeof(T);
+        return value;
+    }
+
+    void AppendString(std::vector<char>& Buffer, const std::string& Value)
+    {
+        Append(Buffer, (uint32_t)Value.size());
+        Buffer.insert(Buffer.end(), Value.begin(), Value.end());
+    }
+
+    std::string ExtractString(const std::vector<char>& Buffer, size_t& Offset)
+    {
+        uint32_t length = Extract<uint32_t>(Buffer, Offset);
+        std::string value(Buffer.data() + Offset, length);
+        Offset += length;
+        return value;
+    }
+
+    /**
+     * Broadcast a buffer of any length from the first process to every other.
+     */
+    void Broadcast(std::vector<char>& Buffer)
+    {
+        uint64_t size = Buffer.size();
+        MPI_Bcast(&size, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+        Buffer.resize(size);
+        MPI_Bcast(Buffer.data(), (int)size, MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+}
+
+/**
+ * Construct a distributor for this process. MPI must already have been initialised.
+ */
+Distributor::Distributor()
+{
+    MPI_Comm_rank(MPI_COMM_WORLD, &this->rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &this->size);
+}
+
+/**
+ * Get the index of this process.
+ * @return Index of this process.
+ */
+int Distributor::GetRank()
+{
+    return this->rank;
+}
+
+/**
+ * Get the number of processes taking part in the simulation.
+ * @return Number of processes taking part in the simulation.
+ */
+int Distributor::GetSize()
+{
+    return this->size;
+}
+
+/**
+ * Broadcast the vehicles discovered by the first process so that every process may construct them in the same order,
+ * giving each vehicle the same node and address within every process.
+ * @param Vehicle_IDs Unique identifiers of the vehicles in the order they were constructed by the first process.
+ * @return Unique identifiers of the vehicles as broadcast by the first process.
+ */
+std::vector<std::string> Distributor::BroadcastVehicleIDs(const std::vector<std::string>& Vehicle_IDs)
+{
+    this->buffer.clear();
+    if(this->rank == 0)
+    {
+        Append(this->buffer, (uint32_t)Vehicle_IDs.size());
+        for(const auto& id : Vehicle_IDs)
+            AppendString(this->buffer, id);
+    }
+    Broadcast(this->buffer);
+    size_t offset = 0;
+    std::vector<std::string> vehicle_ids(Extract<uint32_t>(this->buffer, offset));
+    for(auto& id : vehicle_ids)
+        id = ExtractString(this->buffer, offset);
+    return vehicle_ids;
+}
+
+/**
+ * Set the vehicles whose attributes are exchanged.
+ * @param Vehicles Every vehicle in the order they were constructed.
+ */
+void Distributor::SetVehicles(const std::vector<std::shared_ptr<Vehicle>>& Vehicles)
+{
+    this->vehicle_table = Vehicles;
+    this->vehicle_indices.clear();
+    for(uint32_t i = 0; i < Vehicles.size(); i++)
+        this->vehicle_indices[Vehicles.at(i)->GetID()] = i;
+}
+
+/**
+ * Gather the commands forwarded by every process to the first, which then executes them in order of process.
+ * @param Client Client of this process, connected to SUMO upon the first process and forwarding upon the others.
+ */
+void Distributor::ExchangeCommands(std::shared_ptr<TraCIClient> Client)
+{
+    this->buffer.clear();
+    if(this->rank != 0)
+    {
+        for(const auto& command : Client->TakeForwardedCommands())
+        {
+            Append(this->buffer, (int32_t)command.Command_Type);
+            AppendString(this->buffer, command.ID);
+            Append(this->buffer, (int32_t)command.Integer);
+            Append(this->buffer, command.Real);
+            Append(this->buffer, command.Duration);
+        }
+    }
+    int size = (int)this->buffer.size();
+    std::vector<int> sizes(this->rank == 0 ? this->size : 0);
+    MPI_Gather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<int> offsets(sizes.size());
+    int total = 0;
+    for(size_t i = 0; i < sizes.size(); i++)
+    {
+        offsets.at(i) = total;
+        total += sizes.at(i);
+    }
+    std::vector<char> commands(total);
+    MPI_Gatherv(this->buffer.data(), size, MPI_CHAR, commands.data(), sizes.data(), offsets.data(), MPI_CHAR, 0,
+                MPI_COMM_WORLD);
+    size_t offset = 0;
+    while(offset < commands.size())
+    {
+        TraCICommand command;
+        command.Command_Type = Extract<int32_t>(commands, offset);
+        command.ID = ExtractString(commands, offset);
+        command.Integer = Extract<int32_t>(commands, offset);
+        command.Real = Extract<double>(commands, offset);
+        command.Duration = Extract<int64_t>(commands, offset);
+        Client->Execute(command);
+    }
+}
+
+/**
+ * Scatter the attributes of every vehicle present during this step from the first process to the others, which assign
+ * them to their vehicles and detached client. The number of lanes of the edge each vehicle is upon is resolved by the
+ * first process, as only it knows the road of each vehicle.
+ * @param Client Client of this process.
+ * @param Running Whether the first process has stepped, false once SUMO has no vehicles left.
+ * @param ID_List Unique identifiers of the vehicles present during this step upon the first process.
+ * @param Lanes Governor of the first process, which resolves the number of lanes of each vehicle's edge.
+ * @return Whether the simulation is still running.
+ */
+bool Distributor::ExchangeAttributes(std::shared_ptr<TraCIClient> Client, bool Running,
+                                     const std::vector<std::string>& ID_List, const Governor& Lanes)
+{
+    this->buffer.clear();
+    if(this->rank == 0)
+    {
+        Append(this->buffer, (uint8_t)Running);
+        for(const auto& id : ID_List)
+        {
+            auto iterator = this->vehicle_indices.find(id);
+            if(iterator == this->vehicle_indices.end())
+                continue;
+            std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(iterator->second);
+            std::shared_ptr<VehicleAttributes> attributes = vehicle->GetAttributes();
+            DistributedAttributes record;
+            record.Index = iterator->second;
+            record.Lane_Index = attributes->Lane_Index;
+            record.Lane_Count = Lanes.GetLaneCount(*vehicle);
+            record.X = attributes->Position.x;
+            record.Y = attributes->Position.y;
+            record.Speed = attributes->Speed;
+            record.Length = attributes->Length;
+            record.Max_Speed = attributes->Max_Speed;
+            record.Acceleration = attributes->Acceleration;
+            record.Deceleration = attributes->Deceleration;
+            record.Max_Legal_Speed = attributes->Max_Legal_Speed;
+            Append(this->buffer, record);
+        }
+    }
+    Broadcast(this->buffer);
+    size_t offset = 0;
+    bool running = Extract<uint8_t>(this->buffer, offset) != 0;
+    if(this->rank == 0)
+        return running;
+    std::vector<std::string> id_list;
+    id_list.reserve((this->buffer.size() - offset) / sizeof(DistributedAttributes));
+    while(offset < this->buffer.size())
+    {
+        DistributedAttributes record = Extract<DistributedAttributes>(this->buffer, offset);
+        std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(record.Index);
+        std::shared_ptr<VehicleAttributes> attributes = vehicle->GetAttributes();
+        attributes->Lane_Index = record.Lane_Index;
+        vehicle->SetLaneCount(record.Lane_Count);
+        attributes->Position.x = record.X;
+        attributes->Position.y = record.Y;
+        attributes->Speed = record.Speed;
+        attributes->Length = record.Length;
+        attributes->Max_Speed = record.Max_Speed;
+        attributes->Acceleration = record.Acceleration;
+        attributes->Deceleration = record.Deceleration;
+        attributes->Max_Legal_Speed = record.Max_Legal_Speed;
+        id_list.push_back(vehicle->GetID());
+    }
+    Client->SetDetachedState(id_list, running ? 1 : 0);
+    return running;
+}
+
+/**
+ * Determine if this program was launched as more than one MPI process.
+ * @return True if there is more than one process.
+ */
+bool Distributor::IsDistributed()
+{
+    int size = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    return size > 1;
+}
+
+#endif
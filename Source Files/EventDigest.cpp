@@ -0,0 +1,148 @@
+#include "../Header Files/EventDigest.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+namespace
+{
+    const char* const Digest_Title = "# Cosimulation event digest";
+
+    /**
+     * Fold a line into a 64 bit FNV-1a hash.
+     */
+    uint64_t HashLine(uint64_t Hash, const char* Line, size_t Length)
+    {
+        for(size_t i = 0; i < Length; i++)
+        {
+            Hash ^= (unsigned char)Line[i];
+            Hash *= 1099511628211ULL;
+        }
+        return Hash;
+    }
+}
+
+/**
+ * Get the digest shared by the whole run.
+ * @return The digest.
+ */
+EventDigest& EventDigest::Instance()
+{
+    static EventDigest instance;
+    return instance;
+}
+
+/**
+ * Enable or disable the recording of events.
+ * @param Enabled Whether events should be recorded.
+ */
+void EventDigest::Enable(bool Enabled)
+{
+    this->enabled = Enabled;
+}
+
+/**
+ * Append an event to the digest, see Record.
+ * @param Event_Type Event that occurred.
+ * @param Time_US Simulation time of the event in microseconds.
+ * @param Vehicle_ID Vehicle the event concerns.
+ * @param First First value of the event.
+ * @param Second Second value of the event.
+ */
+void EventDigest::Append(Event Event_Type, int64_t Time_US, const std::string& Vehicle_ID, int64_t First,
+                         int64_t Second)
+{
+    char line[256];
+    int length = std::snprintf(line, sizeof(line), "%lld %s %s %lld %lld\n", (long long)Time_US,
+                               EventName(Event_Type), Vehicle_ID.c_str(), (long long)First, (long long)Second);
+    length = std::min(length, (int)sizeof(line) - 1);
+    this->hash = HashLine(this->hash, line, (size_t)length);
+    this->events.append(line, (size_t)length);
+    this->event_total++;
+}
+
+/**
+ * Write the digest if it has been enabled.
+ * @param URL Name of the digest file.
+ * @return True if the digest was written or there was nothing to write.
+ */
+bool EventDigest::Write(std::string URL)
+{
+    if(!this->enabled || URL.empty())
+        return true;
+    FILE* file = std::fopen(URL.c_str(), "w");
+    if(file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    std::fprintf(file, "%s\n# events %llu hash %016llx\n", Digest_Title, (unsigned long long)this->event_total,
+                 (unsigned long long)this->hash);
+    std::fwrite(this->events.data(), 1, this->events.size(), file);
+    return std::fclose(file) == 0;
+}
+
+/**
+ * Read a digest and total its events.
+ * @param URL Name of the digest file.
+ * @param Digest_Summary Summary the totals are written to.
+ * @return True if the file is a digest.
+ */
+bool EventDigest::Summarise(std::string URL, Summary& Digest_Summary)
+{
+    std::ifstream file(URL);
+    std::string line;
+    unsigned long long total = 0;
+    unsigned long long hash = 0;
+    if(!std::getline(file, line) || line != Digest_Title || !std::getline(file, line) ||
+       std::sscanf(line.c_str(), "# events %llu hash %llx", &total, &hash) != 2)
+    {
+        std::fprintf(stderr, "%s is not an event digest.\n", URL.c_str());
+        return false;
+    }
+    Digest_Summary = Summary();
+    Digest_Summary.Event_Total = total;
+    Digest_Summary.Hash = hash;
+    char name[32];
+    long long time;
+    long long first;
+    long long second;
+    while(std::getline(file, line))
+    {
+        if(std::sscanf(line.c_str(), "%lld %31s %*s %lld %lld", &time, name, &first, &second) != 4)
+            continue;
+        for(int i = 0; i < Event_Count; i++)
+        {
+            if(std::strcmp(name, EventName((Event)i)) != 0)
+                continue;
+            Digest_Summary.Counts[i]++;
+            if(i == Recommendation && first != 0)
+                Digest_Summary.Recommendations_Accepted++;
+            else if(i == Arrival)
+                Digest_Summary.Travel_Time_Sum_S += first / 1000.0;
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Get the name of an event as written to the digest.
+ * @param Event_Type The event to name.
+ * @return Name of the event.
+ */
+const char* EventDigest::EventName(Event Event_Type)
+{
+    switch(Event_Type)
+    {
+        case Selection: return "selection";
+        case Lane_Change_Mode: return "lane_change_mode";
+        case Request: return "request";
+        case Packet_Sent: return "packet_sent";
+        case Packet_Received: return "packet_received";
+        case Recommendation: return "recommendation";
+        case Lane_Change: return "lane_change";
+        case Arrival: return "arrival";
+        default: return "unknown";
+    }
+}
@@ -1,21 +1,117 @@
 #include "../Header Files/Experiment.h"
 #include <vector>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
 #include <ns3/core-module.h>
+#include <ns3/mobility-model.h>
 #include <ns3/animation-interface.h>
+#include "../Header Files/Metrics.h"
+#include "../Header Files/EventDigest.h"
+#include "../Header Files/MemoryReport.h"
+#include "../Header Files/PacketTrace.h"
+#include "../Header Files/Profiler.h"
+#include "../Header Files/DeadlineMonitor.h"
+#include "../Header Files/Partition.h"
+#include "../Header Files/QueueDepthScheduler.h"
 #include "../Header Files/ILACHApplication.h"
 #include "../Header Files/VehicleApplication.h"
 #include "../Header Files/ILACHPlusApplication.h"
 
 using namespace ns3;
 
+namespace
+{
+    /**
+     * Read the variants of a replication, one per line, each as a list of command line arguments separated by
+     * whitespace. The leading dashes of each argument may be omitted. Blank lines and lines beginning with '#' are
+     * ignored.
+     */
+    std::vector<std::vector<std::string>> ReadVariants(const std::string& URL)
+    {
+        std::ifstream file(URL);
+        if(!file)
+            throw std::runtime_error("Unable to read variants " + URL);
+        std::vector<std::vector<std::string>> variants;
+        std::string line;
+        while(std::getline(file, line))
+        {
+            std::istringstream tokens(line);
+            std::vector<std::string> variant;
+            std::string token;
+            while(tokens >> token)
+            {
+                if(variant.empty() && token.front() == '#')
+                    break;
+                variant.push_back(token.compare(0, 2, "--") == 0 ? token : "--" + token);
+            }
+            if(!variant.empty())
+                variants.push_back(variant);
+        }
+        if(variants.empty())
+            throw std::runtime_error("No variants found within " + URL);
+        return variants;
+    }
+
+    /**
+     * Insert a suffix before the extension of a file name, leaving empty names untouched.
+     */
+    std::string AppendSuffix(const std::string& URL, const std::string& Suffix)
+    {
+        if(URL.empty())
+            return URL;
+        size_t extension = URL.rfind('.');
+        size_t slash = URL.rfind('/');
+        if(extension == std::string::npos || (slash != std::string::npos && extension < slash))
+            return URL + Suffix;
+        return URL.substr(0, extension) + Suffix + URL.substr(extension);
+    }
+
+    /**
+     * Construct the application of the protocol specified by the policy, selected once for every vehicle.
+     */
+    template<typename Policy>
+    Ptr<VehicleApplication> CreateProtocol()
+    {
+        return Create<ProtocolApplication<Policy>>();
+    }
+}
+
 /**
- * Construct a new experiment.
+ * Construct a new experiment. The lanes of the road network are read once from the network file named by the SUMO
+ * configuration. Should the connection to SUMO be lost the experiment fails, reporting how a launched SUMO exited.
  */
 Experiment::Experiment(int argc, char** argv)
         : configuration(Configuration(argc, argv))
 {
-    this->Initialise();
-    this->Run();
+    this->factory.SetLegacyPropagation(this->configuration.Legacy_Propagation);
+    std::string network_url = RoadNetwork::FindNetwork(this->configuration.SUMO_URL);
+    if(!network_url.empty())
+        this->road_network.Read(network_url);
+    try
+    {
+        this->Initialise();
+        if(this->replications.empty())
+            this->Run();
+        else
+            this->WaitForReplications();
+    }
+    catch(tcpip::SocketException& error)
+    {
+        std::cerr << "Lost the connection to SUMO: " << error.what() << std::endl;
+        std::string exit = this->sumo.DescribeExit();
+        if(!exit.empty())
+            std::cerr << exit << "." << std::endl;
+        this->exit_status = 1;
+    }
 }
 
 /**
@@ -23,64 +119,630 @@ Experiment::Experiment(int argc, char** argv)
  */
 void Experiment::Initialise()
 {
-    this->client->connect(this->configuration.Remote_Address, this->configuration.Remote_Port);
-    while(this->client->simulation.getMinExpectedNumber() > 0)
+    // The simulator is created upon its first use, which for replications is while every vehicle is constructed ahead
+    // of the fork, so the real-time simulator is selected before anything else.
+    if(this->configuration.Realtime)
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::RealtimeSimulatorImpl"));
+    if(!this->configuration.Variants_URL.empty())
     {
-        std::vector<std::string> id_list = this->client->vehicle.getIDList();
+        this->InitialiseReplications();
+        return;
+    }
+#ifdef COSIMULATION_MPI
+    if(Distributor::IsDistributed())
+    {
+        this->InitialiseDistributed();
+        return;
+    }
+#endif
+    this->InitialiseInstrumentation();
+    if(!this->configuration.Replay_URL.empty())
+    {
+        this->InitialiseReplay();
+        return;
+    }
+    if(!this->configuration.Restore_URL.empty())
+    {
+        this->InitialiseRestore();
+        return;
+    }
+    this->ConnectSUMO(this->configuration.TraCI_Capture_URL);
+    this->PreRun(true);
+    this->client->Load(this->GetReloadArguments(true));
+    this->SetLaneSpeedLimits();
+    this->InitialiseGovernor();
+    this->governor.ScheduleSelection();
+}
+
+/**
+ * Enable the profiler, metrics, event digest, packet trace, memory report, deadline monitor, animation trace and
+ * telemetry if they have been requested. The animation trace is only opened once every vehicle has been constructed,
+ * see Run. The memory used before any vehicle is constructed, including the ring buffer of the packet trace, is sampled
+ * as the baseline of the memory report. The simulator running must be the real-time one exactly when requested, which
+ * a variant cannot change as the simulator was created before the replications were forked.
+ */
+void Experiment::InitialiseInstrumentation()
+{
+    if(this->configuration.Realtime !=
+       (Simulator::GetImplementation()->GetInstanceTypeId().GetName() == "ns3::RealtimeSimulatorImpl"))
+        throw std::runtime_error("The realtime option must be given for every replication or none of them");
+    DeadlineMonitor::Instance().Enable(this->configuration.Realtime || !this->configuration.Deadline_URL.empty(),
+                                       this->configuration.Step_Length);
+    Profiler::Instance().Enable(!this->configuration.Profile_URL.empty());
+    Metrics::Instance().Enable(!this->configuration.Metrics_URL.empty());
+    EventDigest::Instance().Enable(!this->configuration.Digest_URL.empty());
+    PacketTrace::Instance().Enable(this->configuration.Packet_Trace_URL, this->configuration.Packet_Trace_Capacity,
+                                   this->configuration.Packet_Trace_Nodes, this->configuration.Packet_Trace_Start,
+                                   this->configuration.Packet_Trace_Stop);
+    MemoryReport::Instance().Enable(!this->configuration.Memory_URL.empty(), this->configuration.Count_Allocations);
+    MemoryReport::Instance().TakeSample("start", 0);
+    if(!this->configuration.Animation_URL.empty() && !this->configuration.Animation_Legacy)
+        this->animation_writer = std::make_shared<AnimationWriter>();
+    if(!this->configuration.Telemetry_Name.empty() && this->telemetry.Create(this->configuration.Telemetry_Name))
+    {
+        ObjectFactory scheduler_factory;
+        scheduler_factory.SetTypeId(QueueDepthScheduler::GetTypeId());
+        Simulator::SetScheduler(scheduler_factory);
+    }
+}
+
+/**
+ * Run SUMO to completion in order to discover every vehicle that will take part in the simulation and construct each
+ * of them ahead of time.
+ * @param Install_Applications Whether the application selected by the configuration is installed upon each vehicle.
+ */
+void Experiment::PreRun(bool Install_Applications)
+{
+    while(this->client->GetMinExpectedNumber() > 0)
+    {
+        std::vector<std::string> id_list = this->client->GetVehicleIDList();
         for(const auto& id : id_list)
         {
             if(this->vehicles.find(id) == this->vehicles.end())
             {
-                ns3::Ptr<VehicleApplication> vehicle_application;
-                if(this->configuration.Use_Enhanced)
-                {
-                    vehicle_application = Create<ILACHPlusApplication>();
-                }
+                if(Install_Applications)
+                    this->AddVehicle(id);
                 else
-                {
-                    vehicle_application = Create<ILACHApplication>();
-                }
-                std::shared_ptr<Vehicle> vehicle = this->factory.CreateVehicle(id);
-                vehicle_application->Install(vehicle, this->client);
-                this->vehicles.insert(std::pair<std::string, std::shared_ptr<Vehicle>>(id, vehicle));
+                    this->vehicles.insert(std::pair<std::string, std::shared_ptr<Vehicle>>(id,
+                            this->factory.CreateVehicle(id)));
             }
         }
-        this->client->simulationStep();
+        this->client->Step();
     }
-    std::vector<std::string> reload_arguments = {"-c", this->configuration.SUMO_URL, "--remote-port",
-                                                 std::to_string(this->configuration.Remote_Port),
-                                                 "--step-length", std::to_string(this->configuration.Step_Length)};
-    if(!this->configuration.Lane_Change_Output.empty())
+}
+
+/**
+ * Connect to SUMO. With launch-sumo an instance is first launched upon a free port and owned by this process, after
+ * which this process keeps off the CPUs SUMO is pinned to. Otherwise an instance must already be listening upon the
+ * remote address and port.
+ * @param Capture_URL Name of the capture file or empty if the session should not be captured.
+ */
+void Experiment::ConnectSUMO(std::string Capture_URL)
+{
+    if(!this->configuration.Launch_SUMO)
     {
-        reload_arguments.push_back("--lanechange-output");
-        reload_arguments.push_back(this->configuration.Lane_Change_Output);
+        this->client->Connect(this->configuration.Remote_Address, this->configuration.Remote_Port, Capture_URL);
+        return;
     }
-    if(!this->configuration.Trip_Info_Output.empty())
+    if(!this->sumo.Start(this->configuration.SUMO_Binary, this->GetSUMOArguments(false), "sumo.log",
+                         this->configuration.SUMO_CPUs))
+        throw std::runtime_error("Unable to launch SUMO, see sumo.log");
+    if(!this->configuration.SUMO_CPUs.empty())
+        SUMOProcess::SetAffinity(this->configuration.SUMO_CPUs, true);
+    this->client->Connect("127.0.0.1", this->sumo.GetPort(), Capture_URL);
+}
+
+/**
+ * Get the arguments SUMO is reloaded with for the measured part of the simulation, keeping the port it listens upon.
+ * @param Include_Outputs Whether the lane change and trip info outputs are included.
+ * @return Arguments SUMO is reloaded with.
+ */
+std::vector<std::string> Experiment::GetReloadArguments(bool Include_Outputs)
+{
+    int port = this->configuration.Launch_SUMO ? this->sumo.GetPort() : this->configuration.Remote_Port;
+    std::vector<std::string> arguments = {"--remote-port", std::to_string(port)};
+    std::vector<std::string> sumo_arguments = this->GetSUMOArguments(Include_Outputs);
+    arguments.insert(arguments.end(), sumo_arguments.begin(), sumo_arguments.end());
+    return arguments;
+}
+
+/**
+ * Get the arguments SUMO is (re)started with for the measured part of the simulation.
+ * @param Include_Outputs Whether the lane change and trip info outputs are included.
+ * @return Arguments SUMO is (re)started with, excluding the remote port.
+ */
+std::vector<std::string> Experiment::GetSUMOArguments(bool Include_Outputs)
+{
+    std::vector<std::string> arguments = {"-c", this->configuration.SUMO_URL,
+                                          "--step-length", std::to_string(this->configuration.Step_Length)};
+    if(Include_Outputs && !this->configuration.Lane_Change_Output.empty())
     {
-        reload_arguments.push_back("--tripinfo-output");
-        reload_arguments.push_back(this->configuration.Trip_Info_Output);
+        arguments.push_back("--lanechange-output");
+        arguments.push_back(this->configuration.Lane_Change_Output);
     }
-    this->client->load(reload_arguments);
-    for(int i = 0; i < 4; i++)
+    if(Include_Outputs && !this->configuration.Trip_Info_Output.empty())
     {
-        std::string lane_id = "gneE0_";
-        lane_id.append(std::to_string(i));
-        this->client->ChangeLaneSpeedLimit(lane_id, this->configuration.Lane_Speed_Limits.at(i));
+        arguments.push_back("--tripinfo-output");
+        arguments.push_back(this->configuration.Trip_Info_Output);
     }
+    return arguments;
+}
+
+/**
+ * Apply the configured speed limit to the lanes of that index upon every edge of the network. Lanes beyond those given
+ * keep the speed limit of the network.
+ */
+void Experiment::SetLaneSpeedLimits()
+{
+    for(const auto& lane : this->road_network.GetLanes())
+    {
+        if((size_t)lane.Index < this->configuration.Lane_Speed_Limits.size() &&
+           this->configuration.Lane_Speed_Limits.at(lane.Index) != lane.Speed)
+            this->client->ChangeLaneSpeedLimit(lane.ID, this->configuration.Lane_Speed_Limits.at(lane.Index));
+    }
+}
+
+/**
+ * Get the number of lanes of every edge as given by the lane-count option, or otherwise that of the widest edge of the
+ * network. The experiment fails should neither be known, rather than select vehicles against a guessed road.
+ * @return Number of lanes.
+ */
+int Experiment::GetLaneCount()
+{
+    if(this->configuration.Lane_Count > 0)
+        return this->configuration.Lane_Count;
+    if(this->road_network.GetLaneCount() > 0)
+        return this->road_network.GetLaneCount();
+    throw std::runtime_error("Unable to read the lanes of the network named by " + this->configuration.SUMO_URL +
+                             ", give their number with --lane-count");
+}
+
+/**
+ * Construct the governor, attaching the trajectory recorder if one has been requested.
+ */
+void Experiment::InitialiseGovernor()
+{
     this->governor = Governor(this->vehicles, this->client,
-                              this->configuration.Selection_Lanes, this->configuration.Selection_Probability,
+                              this->configuration.Selection_Lanes, this->GetLaneCount(),
+                              this->configuration.Selection_Probability,
                               this->configuration.Selection_Interval, this->configuration.Seed);
+    if(this->configuration.Lane_Count == 0)
+        this->governor.SetEdgeLaneCounts(this->road_network.GetEdgeLaneCounts());
+    this->governor.SetLegacySelection(this->configuration.Legacy_Selection);
+    this->governor.SetStepThreads(this->configuration.Step_Threads);
+    this->governor.SetSubscribedFields(this->GetSubscribedFields());
+    if(!this->configuration.Trajectory_URL.empty())
+    {
+        this->trajectory_recorder = std::make_shared<TrajectoryRecorder>();
+        if(this->trajectory_recorder->Open(this->configuration.Trajectory_URL, this->configuration.Step_Length))
+            this->governor.SetTrajectoryRecorder(this->trajectory_recorder);
+    }
+}
+
+/**
+ * Initialisation of replications goes here. The pre-run, construction of every node, reload of SUMO and the optional
+ * warm-up are carried out once, after which the state of SUMO is saved and a child is forked for every variant. Each
+ * child shares the nodes of this process copy-on-write and goes on to run its own simulation while this process only
+ * waits for them to finish.
+ */
+void Experiment::InitialiseReplications()
+{
+    std::vector<std::vector<std::string>> variants = ReadVariants(this->configuration.Variants_URL);
+    this->ConnectSUMO("");
+    this->PreRun(false);
+    this->client->Load(this->GetReloadArguments(false));
+    this->SetLaneSpeedLimits();
+    while(this->client->GetCurrentTime() < (SUMOTime)(this->configuration.Warmup_Time * 1000) &&
+          this->client->GetMinExpectedNumber() > 0)
+    {
+        this->client->Step();
+    }
+    char directory[PATH_MAX];
+    if(getcwd(directory, sizeof(directory)) == nullptr)
+        throw std::runtime_error("Unable to determine the working directory");
+    this->state_url = std::string(directory) + "/warmup-" + std::to_string(getpid()) + ".xml";
+    this->client->SaveState(this->state_url);
+    this->client->Close();
+    this->sumo.Wait();
+    std::fflush(nullptr);
+    for(size_t i = 0; i < variants.size(); i++)
+    {
+        pid_t child = fork();
+        if(child == -1)
+            throw std::runtime_error("Unable to fork replication " + std::to_string(i));
+        if(child == 0)
+        {
+            this->replications.clear();
+            this->InitialiseReplication(i, variants.at(i));
+            return;
+        }
+        this->replications.push_back(child);
+    }
+}
+
+/**
+ * Initialisation of a single replication goes here, within the forked child. The variant is applied on top of the
+ * configuration and every output is given a suffix unique to the replication. A new SUMO is then started from the saved
+ * state after which the applications and governor are created as they would be normally.
+ * @param Index Index of the replication.
+ * @param Variant Command line arguments that distinguish this replication.
+ */
+void Experiment::InitialiseReplication(size_t Index, const std::vector<std::string>& Variant)
+{
+    std::string suffix = "-" + std::to_string(Index);
+    for(std::string* url : {&this->configuration.Lane_Change_Output, &this->configuration.Trip_Info_Output,
+                            &this->configuration.Profile_URL, &this->configuration.Trajectory_URL,
+                            &this->configuration.Animation_URL, &this->configuration.TraCI_Capture_URL,
+                            &this->configuration.Calibration_Output, &this->configuration.Metrics_URL,
+                            &this->configuration.Digest_URL, &this->configuration.Memory_URL,
+                            &this->configuration.Packet_Trace_URL, &this->configuration.Deadline_URL})
+    {
+        *url = AppendSuffix(*url, suffix);
+    }
+    if(!this->configuration.Telemetry_Name.empty())
+        this->configuration.Telemetry_Name += suffix;
+    this->configuration.Parse(Variant);
+    this->InitialiseInstrumentation();
+    std::vector<std::string> sumo_arguments = this->GetSUMOArguments(true);
+    sumo_arguments.push_back("--load-state");
+    sumo_arguments.push_back(this->state_url);
+    if(!this->sumo.Start(this->configuration.SUMO_Binary, sumo_arguments, "sumo" + suffix + ".log",
+                         this->configuration.SUMO_CPUs))
+        throw std::runtime_error("Unable to start SUMO for replication " + std::to_string(Index));
+    this->client->Connect("127.0.0.1", this->sumo.GetPort(), this->configuration.TraCI_Capture_URL);
+    this->SetLaneSpeedLimits();
+    for(const auto& vehicle : this->vehicles)
+    {
+        this->CreateApplication()->Install(vehicle.second, this->client);
+    }
+    this->InitialiseGovernor();
     this->governor.ScheduleSelection();
 }
 
 /**
- * Each step between the two simulations is handled here.
+ * Wait for every replication to finish and then remove the saved state they were started from.
+ */
+void Experiment::WaitForReplications()
+{
+    for(size_t i = 0; i < this->replications.size(); i++)
+    {
+        int status = 0;
+        waitpid(this->replications.at(i), &status, 0);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            this->exit_status = 1;
+            std::cerr << "Replication " << i << " failed with status " << status << "." << std::endl;
+        }
+    }
+    std::remove(this->state_url.c_str());
+}
+
+/**
+ * Get every vehicle in the order their nodes were created, which is the order they are given their addresses in.
+ * @return Every vehicle in the order their nodes were created.
+ */
+std::vector<std::shared_ptr<Vehicle>> Experiment::GetVehiclesInCreationOrder()
+{
+    std::vector<std::shared_ptr<Vehicle>> vehicles;
+    vehicles.reserve(this->vehicles.size());
+    for(const auto& pair : this->vehicles)
+        vehicles.push_back(pair.second);
+    std::sort(vehicles.begin(), vehicles.end(), [](const std::shared_ptr<Vehicle>& A, const std::shared_ptr<Vehicle>& B)
+              {
+                  return A->GetNode()->GetId() < B->GetNode()->GetId();
+              });
+    return vehicles;
+}
+
+#ifdef COSIMULATION_MPI
+/**
+ * Initialisation of a distributed simulation goes here. Only the first process connects to SUMO, carrying out the
+ * pre-run and reload as normal, after which it broadcasts the vehicles it discovered. Every other process detaches its
+ * client, forwarding any command issued by its applications to the first process, and constructs the same vehicles in
+ * the same order so that nodes and addresses agree between processes. Each process then simulates only the vehicles
+ * within its partition of the road along with those within the halo either side of it. The outputs of every process but
+ * the first are given a suffix unique to the process and trajectories are only recorded by the first.
+ */
+void Experiment::InitialiseDistributed()
+{
+    this->distributor = std::make_shared<Distributor>();
+    int rank = this->distributor->GetRank();
+    if(rank != 0)
+    {
+        std::string suffix = "-rank" + std::to_string(rank);
+        for(std::string* url : {&this->configuration.Profile_URL, &this->configuration.Animation_URL,
+                                &this->configuration.Metrics_URL, &this->configuration.Digest_URL,
+                                &this->configuration.Memory_URL, &this->configuration.Packet_Trace_URL,
+                                &this->configuration.Deadline_URL})
+        {
+            *url = AppendSuffix(*url, suffix);
+        }
+        if(!this->configuration.Telemetry_Name.empty())
+            this->configuration.Telemetry_Name += suffix;
+        this->configuration.Trajectory_URL.clear();
+    }
+    this->InitialiseInstrumentation();
+    std::vector<std::string> vehicle_ids;
+    if(rank == 0)
+    {
+        this->ConnectSUMO(this->configuration.TraCI_Capture_URL);
+        this->PreRun(true);
+        for(const auto& vehicle : this->GetVehiclesInCreationOrder())
+            vehicle_ids.push_back(vehicle->GetID());
+        this->client->Load(this->GetReloadArguments(true));
+        this->SetLaneSpeedLimits();
+    }
+    vehicle_ids = this->distributor->BroadcastVehicleIDs(vehicle_ids);
+    if(rank != 0)
+    {
+        this->client->Detach();
+        this->client->SetForwarding(true);
+        for(const auto& id : vehicle_ids)
+            this->AddVehicle(id);
+    }
+    this->distributor->SetVehicles(this->GetVehiclesInCreationOrder());
+    this->InitialiseGovernor();
+    this->governor.SetPartition(std::make_shared<Partition>(rank, this->distributor->GetSize(),
+                                                            this->configuration.Road_Length,
+                                                            this->configuration.Halo_Width));
+    this->governor.ScheduleSelection();
+}
+
+/**
+ * Each step of a distributed simulation is handled here. The commands forwarded during the previous step are executed
+ * by the first process before it steps SUMO, after which the attributes of every vehicle are passed on to the other
+ * processes so that they may step their own vehicles.
+ */
+void Experiment::DistributedStep()
+{
+    this->distributor->ExchangeCommands(this->client);
+    bool running = false;
+    if(this->distributor->GetRank() == 0)
+    {
+        running = this->client->GetMinExpectedNumber() > 0;
+        if(running)
+            this->governor.Step();
+    }
+    running = this->distributor->ExchangeAttributes(this->client, running, this->governor.GetStepVehicleIDList(),
+                                                    this->governor);
+    if(this->distributor->GetRank() != 0 && running)
+        this->governor.Step();
+    if(running)
+    {
+        if(this->animation_writer)
+            this->animation_writer->Step(Simulator::Now().GetSeconds());
+        this->telemetry.Publish(Simulator::Now().GetSeconds(), this->governor.GetActiveVehicles(),
+                                this->governor.GetPendingNegotiations(), QueueDepthScheduler::GetDepth());
+        Simulator::Schedule(MilliSeconds((uint64_t)this->configuration.Step_Length * 1000), &Experiment::Step, this);
+    }
+}
+#endif
+
+/**
+ * Initialisation of a restoration from a checkpoint goes here. SUMO is reloaded from the state saved with the
+ * checkpoint and the vehicles are constructed in the same order as before, so that each is given the same node and
+ * address, without the need for a pre-run. Negotiations that were under way are issued again upon the first step, as
+ * their timers are lost, while every other vehicle keeps the lane it last requested from. The lane change mode set by
+ * the governor when a vehicle is first seen is set again upon every vehicle still within SUMO, as it has already been
+ * seen and is placed where it was.
+ */
+void Experiment::InitialiseRestore()
+{
+    Checkpoint checkpoint;
+    if(!checkpoint.Read(this->configuration.Restore_URL))
+        throw std::runtime_error("Unable to restore from " + this->configuration.Restore_URL);
+    this->ConnectSUMO(this->configuration.TraCI_Capture_URL);
+    std::vector<std::string> reload_arguments = this->GetReloadArguments(true);
+    reload_arguments.push_back("--load-state");
+    reload_arguments.push_back(checkpoint.SUMO_State_URL);
+    this->client->Load(reload_arguments);
+    this->SetLaneSpeedLimits();
+    std::vector<std::string> present = this->client->GetVehicleIDList();
+    std::sort(present.begin(), present.end());
+    for(size_t i = 0; i < checkpoint.Vehicle_IDs.size(); i++)
+    {
+        const CheckpointVehicle& state = checkpoint.Vehicles.at(i);
+        std::shared_ptr<Vehicle> vehicle = this->AddVehicle(checkpoint.Vehicle_IDs.at(i));
+        vehicle->GetNode()->GetObject<MobilityModel>()->SetPosition(Vector(state.X, state.Y, state.Z));
+        vehicle->SetTarget(state.Target_Lane);
+        vehicle->SetPreviousLane(state.Target_Lane == -1 ? state.Previous_Lane : -1);
+        if(std::binary_search(present.begin(), present.end(), vehicle->GetID()))
+            this->client->SetLaneChangeMode(vehicle->GetID(), 256);
+    }
+    this->InitialiseGovernor();
+    this->governor.SetRandomState(checkpoint.Random_State);
+    this->governor.ScheduleSelection(Seconds(checkpoint.Selection_Delay));
+}
+
+/**
+ * Write a checkpoint of the co-simulation. SUMO saves its own state in its binary format, which is considerably
+ * faster to write than XML, after which the state of the governor and of every vehicle is written alongside it. The
+ * identifiers of the vehicles are only written with the first checkpoint of a run.
+ */
+void Experiment::WriteCheckpoint()
+{
+    std::string directory = this->configuration.Checkpoint_Directory;
+    bool write_vehicle_ids = this->checkpoint_vehicles.empty();
+    if(write_vehicle_ids)
+    {
+        mkdir(directory.c_str(), 0755);
+        char* absolute_directory = realpath(directory.c_str(), nullptr);
+        if(absolute_directory == nullptr)
+            throw std::runtime_error("Unable to create checkpoint directory " + directory);
+        this->configuration.Checkpoint_Directory = directory = absolute_directory;
+        std::free(absolute_directory);
+        this->checkpoint_vehicles = this->GetVehiclesInCreationOrder();
+    }
+    Checkpoint checkpoint;
+    checkpoint.Time = this->client->GetCurrentTime() / 1000.0;
+    checkpoint.Selection_Delay = this->governor.GetTimeUntilSelection().GetSeconds();
+    checkpoint.Random_State = this->governor.GetRandomState();
+    checkpoint.SUMO_State_URL = Checkpoint::GetURL(directory, checkpoint.Time, ".sbx");
+    checkpoint.Vehicle_IDs.reserve(this->checkpoint_vehicles.size());
+    checkpoint.Vehicles.reserve(this->checkpoint_vehicles.size());
+    for(const auto& vehicle : this->checkpoint_vehicles)
+    {
+        Vector position = vehicle->GetNode()->GetObject<MobilityModel>()->GetPosition();
+        CheckpointVehicle state;
+        state.X = (float)position.x;
+        state.Y = (float)position.y;
+        state.Z = (float)position.z;
+        state.Target_Lane = (int8_t)vehicle->GetTarget();
+        state.Previous_Lane = (int8_t)vehicle->GetPreviousLane();
+        state.Reserved = 0;
+        checkpoint.Vehicle_IDs.push_back(vehicle->GetID());
+        checkpoint.Vehicles.push_back(state);
+    }
+    this->client->SaveState(checkpoint.SUMO_State_URL);
+    if(!checkpoint.Write(directory, write_vehicle_ids))
+        std::cerr << "Unable to write checkpoint to " << directory << "." << std::endl;
+}
+
+/**
+ * Initialisation of a replay goes here. Rather than connecting to SUMO the vehicles are created from those found within
+ * the recorded trajectory and the client is detached so that their mobility is fed from the trajectory instead. Any
+ * commands issued by the applications are discarded making the replay open-loop.
+ */
+void Experiment::InitialiseReplay()
+{
+    if(!this->trajectory_reader.Open(this->configuration.Replay_URL))
+        throw std::runtime_error("Unable to replay trajectory " + this->configuration.Replay_URL);
+    this->configuration.Step_Length = this->trajectory_reader.GetStepLength();
+    this->client->Detach();
+    for(uint32_t i = 0; i < this->trajectory_reader.GetVehicleCount(); i++)
+    {
+        std::shared_ptr<Vehicle> vehicle = this->AddVehicle(this->trajectory_reader.GetVehicleID(i));
+        this->trajectory_reader.GetStaticAttributes(i, *vehicle->GetAttributes());
+        this->trajectory_vehicles.push_back(vehicle);
+    }
+    this->governor = Governor(this->vehicles, this->client,
+                              this->configuration.Selection_Lanes, this->GetLaneCount(),
+                              this->configuration.Selection_Probability,
+                              this->configuration.Selection_Interval, this->configuration.Seed);
+    if(this->configuration.Lane_Count == 0)
+        this->governor.SetEdgeLaneCounts(this->road_network.GetEdgeLaneCounts());
+    this->governor.SetLegacySelection(this->configuration.Legacy_Selection);
+    this->governor.SetStepThreads(this->configuration.Step_Threads);
+    this->governor.SetSubscribedFields(this->GetSubscribedFields());
+    this->governor.ScheduleSelection();
+}
+
+/**
+ * Construct a new vehicle with the application selected by the configuration installed upon it.
+ * @param ID Unique identifier used to interact with SUMO/TraCI.
+ * @return Newly constructed vehicle.
+ */
+std::shared_ptr<Vehicle> Experiment::AddVehicle(std::string ID)
+{
+    uint64_t mark = MemoryReport::Instance().Mark();
+    ns3::Ptr<VehicleApplication> vehicle_application = this->CreateApplication();
+    MemoryReport::Instance().Attribute(MemoryReport::Application, mark);
+    std::shared_ptr<Vehicle> vehicle = this->factory.CreateVehicle(ID);
+    vehicle_application->Install(vehicle, this->client);
+    this->vehicles.insert(std::pair<std::string, std::shared_ptr<Vehicle>>(ID, vehicle));
+    return vehicle;
+}
+
+/**
+ * Construct the application selected by the configuration. The network abstraction is shared by every application and
+ * is created along with the first of them, if either the abstraction or calibration output has been requested.
+ * @return ILACH+ if enhanced has been selected otherwise ILACH.
+ */
+ns3::Ptr<VehicleApplication> Experiment::CreateApplication()
+{
+    if(!this->network_abstraction &&
+       (this->configuration.Abstract_Network || !this->configuration.Calibration_Output.empty()))
+    {
+        this->network_abstraction = std::make_shared<NetworkAbstraction>(
+                this->configuration.Abstract_Network, this->configuration.Abstract_Range,
+                this->configuration.Abstract_Fade, this->configuration.Abstract_Latency,
+                this->configuration.Abstract_Latency_Per_Metre, this->configuration.Seed,
+                this->configuration.Calibration_Output);
+    }
+    if(this->create_protocol == nullptr)
+        this->create_protocol = this->configuration.Use_Enhanced ? &CreateProtocol<ILACHPlusPolicy>
+                                                                 : &CreateProtocol<ILACHPolicy>;
+    ns3::Ptr<VehicleApplication> application = this->create_protocol();
+    application->SetNetworkAbstraction(this->network_abstraction);
+    application->SetAnimationWriter(this->animation_writer);
+    return application;
+}
+
+/**
+ * Get the attributes of each vehicle to subscribe to from SUMO, those read by the selected protocol unless a trajectory
+ * is being recorded in which case every attribute is recorded.
+ * @return Fields of VehicleAttributes to be subscribed to.
+ */
+uint32_t Experiment::GetSubscribedFields()
+{
+    if(!this->configuration.Trajectory_URL.empty())
+        return VehicleAttributes::All_Fields;
+    if(this->configuration.Use_Enhanced)
+        return ProtocolApplication<ILACHPlusPolicy>::Fields;
+    return ProtocolApplication<ILACHPolicy>::Fields;
+}
+
+/**
+ * Feed the next step of the recorded trajectory to the vehicles and the detached client.
+ */
+void Experiment::ReplayStep()
+{
+    TrajectoryStep step;
+    if(!this->trajectory_reader.Next(step))
+    {
+        this->client->SetDetachedState(std::vector<std::string>(), 0);
+        return;
+    }
+    std::vector<std::string> id_list;
+    id_list.reserve(step.Count);
+    for(uint32_t i = 0; i < step.Count; i++)
+    {
+        std::shared_ptr<Vehicle> vehicle = this->trajectory_vehicles.at(step.Vehicle_Index[i]);
+        std::shared_ptr<VehicleAttributes> attributes = vehicle->GetAttributes();
+        attributes->Position.x = step.X[i];
+        attributes->Position.y = step.Y[i];
+        attributes->Speed = step.Speed[i];
+        attributes->Lane_Index = step.Lane_Index[i];
+        id_list.push_back(vehicle->GetID());
+    }
+    this->client->SetDetachedState(id_list, (int)id_list.size() + 1);
+}
+
+/**
+ * Each step between the two simulations is handled here. When behind wall time, see DeadlineMonitor, the nodes of idle
+ * vehicles are moved less often should the degrade-mobility option have been given.
  */
 void Experiment::Step()
 {
-    if(this->client->simulation.getMinExpectedNumber() > 0)
+    Profiler::Instance().MarkStep();
+#ifdef COSIMULATION_MPI
+    if(this->distributor)
+    {
+        this->DistributedStep();
+        return;
+    }
+#endif
+    if(!this->configuration.Replay_URL.empty())
+        this->ReplayStep();
+    if(!this->configuration.Checkpoint_Directory.empty() && !this->client->IsDetached() &&
+       Simulator::Now().GetSeconds() >= this->next_checkpoint)
+    {
+        if(this->next_checkpoint > 0)
+            this->WriteCheckpoint();
+        this->next_checkpoint = Simulator::Now().GetSeconds() + this->configuration.Checkpoint_Interval;
+    }
+    DeadlineMonitor& deadline = DeadlineMonitor::Instance();
+    deadline.BeginStep(Simulator::Now().GetSeconds());
+    if(this->client->GetMinExpectedNumber() > 0)
     {
+        bool degrade = this->configuration.Degrade_Mobility > 1 && deadline.IsBehind();
+        this->governor.SetMobilityStride(degrade ? this->configuration.Degrade_Mobility : 1);
         this->governor.Step();
+        if(this->animation_writer)
+            this->animation_writer->Step(Simulator::Now().GetSeconds());
+        this->telemetry.Publish(Simulator::Now().GetSeconds(), this->governor.GetActiveVehicles(),
+                                this->governor.GetPendingNegotiations(), QueueDepthScheduler::GetDepth());
+        deadline.EndStep(degrade);
         Simulator::Schedule(MilliSeconds((uint64_t)this->configuration.Step_Length * 1000), &Experiment::Step, this);
     }
 }
@@ -90,19 +752,83 @@ void Experiment::Step()
  */
 void Experiment::Run()
 {
-    if(this->configuration.Animation_URL.empty())
+    std::unique_ptr<AnimationInterface> animation;
+    if(!this->configuration.Animation_URL.empty() && this->configuration.Animation_Legacy)
     {
-        Simulator::Schedule(MilliSeconds(0), &Experiment::Step, this);
-        Simulator::Run();
-        Simulator::Destroy();
-        this->client->close();
+        animation.reset(new AnimationInterface(this->configuration.Animation_URL));
+        animation->SetStartTime(Seconds(this->configuration.Animation_Start));
+        if(this->configuration.Animation_Stop > 0)
+            animation->SetStopTime(Seconds(this->configuration.Animation_Stop));
+        animation->SetMobilityPollInterval(Seconds(this->configuration.Animation_Interval));
+        animation->EnablePacketMetadata(this->configuration.Animation_Metadata);
+        if(!this->configuration.Animation_Packets)
+            animation->SkipPacketTracing();
     }
-    else
+    else if(this->animation_writer)
     {
-        AnimationInterface animation = AnimationInterface(this->configuration.Animation_URL);
-        Simulator::Schedule(MilliSeconds(0), &Experiment::Step, this);
-        Simulator::Run();
-        Simulator::Destroy();
-        this->client->close();
+        AnimationOptions options;
+        options.Start_Time = this->configuration.Animation_Start;
+        options.Stop_Time = this->configuration.Animation_Stop;
+        options.Interval = this->configuration.Animation_Interval;
+        options.Radius = this->configuration.Animation_Radius;
+        options.Record_Packets = this->configuration.Animation_Packets;
+        options.Record_Metadata = this->configuration.Animation_Metadata;
+        if(!this->animation_writer->Open(this->configuration.Animation_URL, options,
+                                         this->GetVehiclesInCreationOrder()))
+            this->animation_writer.reset();
     }
+    Simulator::Schedule(MilliSeconds(0), &Experiment::Step, this);
+    MemoryReport::Instance().TakeSample("simulation_start", Simulator::Now().GetSeconds());
+    Simulator::Run();
+    this->SampleMemory();
+    Simulator::Destroy();
+    if(this->animation_writer)
+        this->animation_writer->Close();
+    this->client->Close();
+    this->sumo.Wait();
+    if(this->trajectory_recorder)
+        this->trajectory_recorder->Close();
+    Profiler::Instance().Report(this->configuration.Profile_URL);
+    Metrics::Instance().Write(this->configuration.Metrics_URL);
+    EventDigest::Instance().Write(this->configuration.Digest_URL);
+    if(!DeadlineMonitor::Instance().Write(this->configuration.Deadline_URL))
+        this->exit_status = 1;
+    if(!PacketTrace::Instance().Write())
+        std::perror(this->configuration.Packet_Trace_URL.c_str());
+    if(!MemoryReport::Instance().Report(this->configuration.Memory_URL, this->configuration.Memory_Budget))
+        this->exit_status = 1;
+    this->telemetry.Finish();
+}
+
+/**
+ * Estimate the memory held by the waypoints queued upon each node and the responses held by each application, which
+ * grow and shrink during the run rather than being fixed at construction, and sample the memory at the end of the run.
+ */
+void Experiment::SampleMemory()
+{
+    MemoryReport& memory_report = MemoryReport::Instance();
+    if(!memory_report.IsEnabled())
+        return;
+    uint64_t waypoints = 0;
+    uint64_t responses = 0;
+    for(const auto& vehicle : this->vehicles)
+    {
+        waypoints += vehicle.second->GetNode()->GetObject<WaypointMobilityModel>()->WaypointsLeft();
+        if(vehicle.second->GetApplication() != nullptr)
+            responses += vehicle.second->GetApplication()->GetResponseCapacity();
+    }
+    // Room for each response is kept along with room for the time it was received.
+    size_t response_bytes = sizeof(std::pair<Address, VehicleAttributes>) + sizeof(std::pair<Address, Time>);
+    memory_report.SetEstimate(MemoryReport::Waypoints, waypoints, sizeof(Waypoint));
+    memory_report.SetEstimate(MemoryReport::Responses, responses, response_bytes);
+    memory_report.TakeSample("simulation_end", Simulator::Now().GetSeconds());
+}
+
+/**
+ * Get the status the process should exit with, non-zero if a replication failed or the memory budget was exceeded.
+ * @return Status the process should exit with.
+ */
+int Experiment::GetExitStatus() const
+{
+    return this->exit_status;
 }
\ No newline at end of file
@@ -1,27 +1,43 @@
 #include "../Header Files/Governor.h"
-#include <algorithm>
+#include <cmath>
+#include <sstream>
 #include <ns3/nstime.h>
 #include <ns3/simulator.h>
 #include <ns3/mobility-model.h>
+#include "../Header Files/Profiler.h"
+#include "../Header Files/EventDigest.h"
 
 /**
  * Construct a new governor that is configured to oversee all vehicles within the simulation.
  * @param Vehicles Collection of vehicles that populate the simulation space.
  * @param Client TraCIClient will valid established connection to the TraCI server.
  * @param Selection_Lanes Lanes which will be used to select vehicle to change lane from. Other lanes ignored.
+ * @param Lane_Count Number of lanes of every edge, or of the widest edge, see SetEdgeLaneCounts.
  * @param Selection_Probability The probability that a vehicle maybe selected.
  * @param Selection_Interval The length of time between selection processes.
  * @param Seed The random generator will be seeded with this value.
  */
 Governor::Governor(std::map<std::string, std::shared_ptr<Vehicle>> Vehicles, std::shared_ptr<TraCIClient> Client,
-                   std::bitset<5> Selection_Lanes, double Selection_Probability, int Selection_Interval, int Seed)
+                   std::vector<bool> Selection_Lanes, int Lane_Count, double Selection_Probability,
+                   int Selection_Interval, int Seed)
 {
     this->vehicles = Vehicles;
     this->client = Client;
     this->selection_lanes = Selection_Lanes;
+    this->lane_count = Lane_Count;
     this->selection_probability = Selection_Probability;
     this->selection_interval = Selection_Interval;
     this->random_generator = std::mt19937(Seed);
+    this->UpdateVariables();
+    for(const auto& pair : this->vehicles)
+    {
+        this->vehicle_indices[pair.first] = (uint32_t)this->vehicle_table.size();
+        this->vehicle_table.push_back(pair.second);
+    }
+    this->present_steps.assign(this->vehicle_table.size(), 0);
+    this->candidate_lanes.assign(this->vehicle_table.size(), -1);
+    this->candidate_slots.assign(this->vehicle_table.size(), 0);
+    this->lane_candidates.resize(this->selection_lanes.size());
 }
 
 /**
@@ -29,82 +45,445 @@ Governor::Governor(std::map<std::string, std::shared_ptr<Vehicle>> Vehicles, std
  */
 void Governor::Step()
 {
-    std::vector<std::string> id_list = this->client->vehicle.getIDList();
-    for(const auto& id : id_list)
+    Profiler::Scope scope(Profiler::Governor_Step);
+    this->step_id_list = this->client->GetVehicleIDList();
+    const std::vector<std::string>& id_list = this->step_id_list;
+    this->step_count++;
+    this->active_vehicles = 0;
+    this->pending_negotiations = 0;
+    if(this->recorder)
+        this->recorder->BeginStep(ns3::Simulator::Now().GetSeconds());
+    if(!this->worker_pool)
+        this->worker_pool = std::make_shared<WorkerPool>(this->step_threads);
+    this->step_indices.clear();
     {
-        if(this->vehicles.find(id) != this->vehicles.end())
+        // Round trips to SUMO are serial, therefore the results are only collected here and decoded below.
+        Profiler::Scope decode_scope(Profiler::Subscription_Decode);
+        for(const auto& id : id_list)
         {
-            ns3::Ptr<ns3::MobilityModel> mobility = this->vehicles.at(id)->GetNode()->GetObject<ns3::MobilityModel>();
-            if(mobility->GetPosition().z == 10000 && mobility->GetPosition().x == 0)
+            auto iterator = this->vehicle_indices.find(id);
+            if(iterator != this->vehicle_indices.end())
             {
-                this->client->SetLaneChangeMode(id, 256);
+                uint32_t index = iterator->second;
+                this->present_steps.at(index) = this->step_count;
+                if(this->step_results.size() <= this->step_indices.size())
+                    this->step_results.resize(this->step_indices.size() + 1);
+                TraCIAPI::TraCIValues& results = this->step_results.at(this->step_indices.size());
+                this->vehicle_table.at(index)->Subscribe(this->client, this->step_variables, this->departure_variables,
+                                                         results);
+                this->step_indices.push_back(index);
             }
-            this->vehicles.at(id)->Step(this->client);
         }
+        // Decoding and planning touch nothing but each vehicle and so are spread across the worker pool.
+        this->step_actions.resize(this->step_indices.size());
+        bool detached = this->client->IsDetached();
+        this->worker_pool->Run(this->step_indices.size(), [this, detached](size_t i)
+        {
+            std::shared_ptr<Vehicle> vehicle = this->vehicle_table[this->step_indices[i]];
+            if(!detached)
+                vehicle->Decode(this->step_results[i]);
+            if(this->partition)
+            {
+                double x = vehicle->GetAttributes()->Position.x;
+                vehicle->SetOwnership(this->partition->Owns(x), this->partition->IsVisible(x));
+            }
+            this->step_actions[i] = vehicle->Plan();
+        });
     }
-    for(const auto& pair : this->vehicles)
+    // The resulting calls upon NS-3 and SUMO are then made serially in the order SUMO listed the vehicles.
+    for(size_t i = 0; i < this->step_indices.size(); i++)
+    {
+        uint32_t index = this->step_indices.at(i);
+        std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(index);
+        ns3::Ptr<ns3::MobilityModel> mobility = vehicle->GetNode()->GetObject<ns3::MobilityModel>();
+        if(vehicle->IsOwned() && mobility->GetPosition().z == 10000 && mobility->GetPosition().x == 0)
+        {
+            this->client->SetLaneChangeMode(vehicle->GetID(), 256);
+            EventDigest::Instance().Record(EventDigest::Lane_Change_Mode, ns3::Simulator::Now().GetMicroSeconds(),
+                                           vehicle->GetID(), 256);
+        }
+        bool move = this->mobility_stride <= 1 || vehicle->HasTarget() ||
+                    (index + this->step_count) % this->mobility_stride == 0;
+        vehicle->Apply(this->step_actions.at(i), this->client, move);
+        this->UpdateCandidate(index, true);
+        this->active_vehicles++;
+        if(vehicle->HasTarget())
+            this->pending_negotiations++;
+        if(this->recorder)
+            this->recorder->Add(vehicle->GetID(), *vehicle->GetAttributes());
+    }
+    if(this->recorder)
+        this->recorder->EndStep();
     {
-        std::string id = pair.first;
-        ns3::Ptr<ns3::MobilityModel> mobility = this->vehicles.at(id)->GetNode()->GetObject<ns3::MobilityModel>();
-        ns3::Vector position = mobility->GetPosition();
-        if(std::find(id_list.begin(), id_list.end(), id) == id_list.end() && position.z != 10000)
+        // Vehicles that have left SUMO are noted as having arrived and, along with those that lie outside the partition
+        // of this process, are moved out of range of the others.
+        Profiler::Scope mobility_scope(Profiler::Mobility_Update);
+        for(uint32_t i = 0; i < this->vehicle_table.size(); i++)
         {
-            position.z = 10000;
-            mobility->SetPosition(position);
+            std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(i);
+            ns3::Ptr<ns3::MobilityModel> mobility = vehicle->GetNode()->GetObject<ns3::MobilityModel>();
+            ns3::Vector position = mobility->GetPosition();
+            bool present = this->present_steps.at(i) == this->step_count;
+            if(!present)
+            {
+                vehicle->Arrive();
+                this->UpdateCandidate(i, false);
+            }
+            if((!present || !vehicle->IsVisible()) && position.z != 10000)
+            {
+                position.z = 10000;
+                mobility->SetPosition(position);
+            }
         }
     }
-    this->client->simulationStep();
+    this->client->Step();
 }
 
 /**
- * Select vehicles currently active within the simulation to change lane.
+ * Move a vehicle into, out of or between the per-lane sets of candidates for selection. A vehicle is a candidate if it
+ * is present within SUMO, lies within a selection lane and has no target. Removal swaps the last candidate of the lane
+ * into the vacated slot.
+ * @param Index Index of the vehicle within the vehicle table.
+ * @param Present Whether the vehicle was present within SUMO during this step.
+ */
+void Governor::UpdateCandidate(uint32_t Index, bool Present)
+{
+    std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(Index);
+    int lane = vehicle->GetAttributes()->Lane_Index;
+    if(!Present || vehicle->HasTarget() || !this->IsSelectionLane(lane))
+        lane = -1;
+    int current = this->candidate_lanes.at(Index);
+    if(lane == current)
+        return;
+    if(current != -1)
+    {
+        std::vector<uint32_t>& candidates = this->lane_candidates.at(current);
+        uint32_t slot = this->candidate_slots.at(Index);
+        candidates.at(slot) = candidates.back();
+        this->candidate_slots.at(candidates.at(slot)) = slot;
+        candidates.pop_back();
+    }
+    if(lane != -1)
+    {
+        this->candidate_slots.at(Index) = (uint32_t)this->lane_candidates.at(lane).size();
+        this->lane_candidates.at(lane).push_back(Index);
+    }
+    this->candidate_lanes.at(Index) = lane;
+}
+
+/**
+ * Select vehicles currently active within the simulation to change lane. Rather than drawing for every candidate, the
+ * number of candidates skipped before the next selection is drawn from the geometric distribution by inversion, one
+ * draw per selection. The candidates of every lane are treated as a single sequence in ascending order of lane. Each
+ * candidate is therefore selected independently with the selection probability exactly as before. Selections are
+ * identical in distribution to the legacy selection, and determined entirely by the seed, although not draw for draw
+ * identical to it. As candidates are updated as each vehicle steps they are those of the last step.
  */
 void Governor::SelectVehicles()
 {
-    std::vector<std::string> id_list = this->client->vehicle.getIDList();
+    if(this->legacy_selection)
+    {
+        this->SelectVehiclesLegacy();
+        return;
+    }
+    Profiler::Scope scope(Profiler::Select_Vehicles);
+    size_t candidate_count = 0;
+    for(const auto& candidates : this->lane_candidates)
+        candidate_count += candidates.size();
+    std::vector<uint32_t> selected;
+    if(this->selection_probability >= 1)
+    {
+        for(const auto& candidates : this->lane_candidates)
+            selected.insert(selected.end(), candidates.begin(), candidates.end());
+    }
+    else if(this->selection_probability > 0)
+    {
+        double log_miss = std::log(1 - this->selection_probability);
+        size_t position = 0;
+        size_t lane = 0;
+        size_t lane_start = 0;
+        while(true)
+        {
+            double skip = std::floor(std::log(1 - this->distribution(this->random_generator)) / log_miss);
+            if(skip >= (double)(candidate_count - position))
+                break;
+            position += (size_t)skip;
+            while(position - lane_start >= this->lane_candidates.at(lane).size())
+                lane_start += this->lane_candidates.at(lane++).size();
+            selected.push_back(this->lane_candidates.at(lane).at(position - lane_start));
+            position++;
+        }
+    }
+    for(uint32_t index : selected)
+        this->SetTarget(index);
+    if(this->client->GetMinExpectedNumber() > 0)
+    {
+        this->ScheduleSelection();
+    }
+}
+
+/**
+ * Select vehicles currently active within the simulation to change lane by drawing for every vehicle in turn, which
+ * reproduces the selections of earlier versions draw for draw.
+ */
+void Governor::SelectVehiclesLegacy()
+{
+    Profiler::Scope scope(Profiler::Select_Vehicles);
+    // When partitioned every process must make identical selections, therefore the vehicles of the last step are used
+    // rather than the position of their nodes which differs between processes.
+    std::vector<std::string> id_list = this->partition ? this->step_id_list : this->client->GetVehicleIDList();
     for(const auto& id : id_list)
     {
-        if(this->vehicles.find(id) != this->vehicles.end())
+        auto iterator = this->vehicle_indices.find(id);
+        if(iterator != this->vehicle_indices.end())
         {
-            std::shared_ptr<Vehicle> vehicle = this->vehicles.at(id);
+            std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(iterator->second);
             ns3::Ptr<ns3::MobilityModel> mobility = vehicle->GetNode()->GetObject<ns3::MobilityModel>();
             ns3::Vector position = mobility->GetPosition();
-            if(position.z != 10000 && this->selection_lanes.test((size_t)vehicle->GetAttributes()->Lane_Index))
+            if((this->partition || position.z != 10000) &&
+               this->IsSelectionLane(vehicle->GetAttributes()->Lane_Index))
             {
                 if(!vehicle->HasTarget() && this->distribution(random_generator) < this->selection_probability)
                 {
-                    int target_delta;
-                    int current_lane = vehicle->GetAttributes()->Lane_Index;
-                    if(current_lane == 4 || current_lane == 0)
-                    {
-                        if(current_lane == 4)
-                        {
-                            target_delta = -1;
-                        }
-                        else
-                        {
-                            target_delta = 1;
-                        }
-                    }
-                    else
-                    {
-                        target_delta = distribution(random_generator) <= 0.5 ? 1 : -1;
-                    }
-                    vehicle->SetTarget(current_lane + target_delta);
+                    this->SetTarget(iterator->second);
                 }
             }
         }
     }
-    if(this->client->simulation.getMinExpectedNumber() > 0)
+    if(this->client->GetMinExpectedNumber() > 0)
     {
         this->ScheduleSelection();
     }
 }
 
+/**
+ * Give a selected vehicle a target lane adjacent to its current lane, choosing between the two at random unless it lies
+ * within an outermost lane of the edge it is upon, and remove it from the candidates. Vehicles upon an edge with a
+ * single lane, or within a junction, are left as candidates.
+ * @param Index Index of the vehicle within the vehicle table.
+ */
+void Governor::SetTarget(uint32_t Index)
+{
+    std::shared_ptr<Vehicle> vehicle = this->vehicle_table.at(Index);
+    int target_delta;
+    int current_lane = vehicle->GetAttributes()->Lane_Index;
+    int lane_count = this->GetLaneCount(*vehicle);
+    if(lane_count < 2)
+        return;
+    if(current_lane >= lane_count - 1 || current_lane == 0)
+    {
+        if(current_lane >= lane_count - 1)
+        {
+            target_delta = -1;
+        }
+        else
+        {
+            target_delta = 1;
+        }
+    }
+    else
+    {
+        target_delta = distribution(random_generator) <= 0.5 ? 1 : -1;
+    }
+    vehicle->SetTarget(current_lane + target_delta);
+    EventDigest::Instance().Record(EventDigest::Selection, ns3::Simulator::Now().GetMicroSeconds(), vehicle->GetID(),
+                                   current_lane + target_delta);
+    this->UpdateCandidate(Index, true);
+}
+
+/**
+ * Get the number of lanes of the edge a vehicle is upon. Unless the edges differ in their number of lanes every edge
+ * has the lane count the governor was constructed with, as does every edge when replaying a trajectory, which does not
+ * record the road of each vehicle. Processes of a distributed simulation other than the first do not know the road of
+ * any vehicle and use the lane count resolved by the first instead.
+ * @param Subject The vehicle.
+ * @return Number of lanes, zero should the vehicle be within a junction.
+ */
+int Governor::GetLaneCount(Vehicle& Subject) const
+{
+    if(this->edge_lane_counts.empty())
+        return this->lane_count;
+    if(Subject.GetRoadID().empty())
+        return Subject.GetLaneCount() != -1 ? Subject.GetLaneCount() : this->lane_count;
+    auto entry = this->edge_lane_counts.find(Subject.GetRoadID());
+    return entry != this->edge_lane_counts.end() ? entry->second : 0;
+}
+
+/**
+ * Determine if vehicles within the given lane may be selected.
+ * @param Lane_Index Index of the lane.
+ * @return True if the lane is a selection lane.
+ */
+bool Governor::IsSelectionLane(int Lane_Index)
+{
+    return Lane_Index >= 0 && (size_t)Lane_Index < this->selection_lanes.size() && this->selection_lanes.at(Lane_Index);
+}
+
 /**
  * Schedule the selection function to be called when required.
  */
 void Governor::ScheduleSelection()
 {
-    ns3::Simulator::Schedule(ns3::Seconds(this->selection_interval), &Governor::SelectVehicles, this);
+    this->ScheduleSelection(ns3::Seconds(this->selection_interval));
+}
+
+/**
+ * Schedule the selection function to be called after the given delay.
+ * @param Delay The length of time until the selection function is called.
+ */
+void Governor::ScheduleSelection(ns3::Time Delay)
+{
+    this->next_selection = ns3::Simulator::Now() + Delay;
+    ns3::Simulator::Schedule(Delay, &Governor::SelectVehicles, this);
+}
+
+/**
+ * Get the length of time until vehicles are next selected.
+ * @return The length of time until vehicles are next selected.
+ */
+ns3::Time Governor::GetTimeUntilSelection()
+{
+    return this->next_selection - ns3::Simulator::Now();
+}
+
+/**
+ * Get the state of the random generator so that the sequence of selections may later be resumed.
+ * @return State of the random generator in its textual form.
+ */
+std::string Governor::GetRandomState()
+{
+    std::ostringstream state;
+    state << this->random_generator;
+    return state.str();
+}
+
+/**
+ * Restore the state of the random generator.
+ * @param State State of the random generator as returned by GetRandomState.
+ */
+void Governor::SetRandomState(std::string State)
+{
+    std::istringstream state(State);
+    state >> this->random_generator;
+}
+
+/**
+ * Get the number of vehicles that were within SUMO during the last step.
+ * @return Number of vehicles that were within SUMO during the last step.
+ */
+uint64_t Governor::GetActiveVehicles()
+{
+    return this->active_vehicles;
+}
+
+/**
+ * Get the number of vehicles that had yet to reach their target lane during the last step.
+ * @return Number of vehicles that had yet to reach their target lane during the last step.
+ */
+uint64_t Governor::GetPendingNegotiations()
+{
+    return this->pending_negotiations;
+}
+
+/**
+ * Record the state of every vehicle present at each step to a trajectory.
+ * @param Recorder Recorder the state of the vehicles is added to.
+ */
+void Governor::SetTrajectoryRecorder(std::shared_ptr<TrajectoryRecorder> Recorder)
+{
+    this->recorder = Recorder;
+}
+
+/**
+ * Divide the vehicles with other processes, each of which owns a segment of the road.
+ * @param Road_Partition The segment of the road owned by this process.
+ */
+void Governor::SetPartition(std::shared_ptr<Partition> Road_Partition)
+{
+    this->partition = Road_Partition;
+}
+
+/**
+ * Select vehicles by drawing for every vehicle in turn, as earlier versions did, so that their runs may be reproduced.
+ * @param Legacy_Selection Whether the legacy selection is used.
+ */
+void Governor::SetLegacySelection(bool Legacy_Selection)
+{
+    this->legacy_selection = Legacy_Selection;
+}
+
+/**
+ * Set how often the nodes of vehicles that are not negotiating are moved to the positions reported by SUMO. Their
+ * attributes are still updated every step. Vehicles negotiating, or departing, are moved every step regardless.
+ * @param Stride Number of steps between each move of such a node, one to move every node every step.
+ */
+void Governor::SetMobilityStride(unsigned int Stride)
+{
+    this->mobility_stride = Stride;
+}
+
+/**
+ * Set the number of threads the per-vehicle work of each step is spread across. The threads are started upon the first
+ * step, after any replications have been forked.
+ * @param Step_Threads Number of threads including the simulator thread, 0 for one per core.
+ */
+void Governor::SetStepThreads(unsigned int Step_Threads)
+{
+    this->step_threads = Step_Threads;
+    this->worker_pool.reset();
+}
+
+/**
+ * Set the attributes of each vehicle that are subscribed to from SUMO, by default all of them. Those every vehicle
+ * needs to step are always subscribed to.
+ * @param Fields Fields of VehicleAttributes to be subscribed to.
+ */
+void Governor::SetSubscribedFields(uint32_t Fields)
+{
+    this->subscribed_fields = Fields;
+    this->UpdateVariables();
 }
+
+/**
+ * Set the number of lanes of each edge of the network, so that the outermost lanes of a narrower edge are known. Should
+ * every edge have the same number of lanes the lane count the governor was constructed with suffices, and the road of
+ * each vehicle is not subscribed to.
+ * @param Edge_Lane_Counts Number of lanes keyed by the identifier of the edge.
+ */
+void Governor::SetEdgeLaneCounts(const std::unordered_map<std::string, int>& Edge_Lane_Counts)
+{
+    this->edge_lane_counts.clear();
+    for(const auto& entry : Edge_Lane_Counts)
+    {
+        if(entry.second != Edge_Lane_Counts.begin()->second)
+        {
+            this->edge_lane_counts = Edge_Lane_Counts;
+            break;
+        }
+    }
+    this->UpdateVariables();
+}
+
+/**
+ * Determine the TraCI variables subscribed to upon departure and at each step from the fields requested, those every
+ * vehicle needs to step and, should the edges differ in their number of lanes, the road of each vehicle.
+ */
+void Governor::UpdateVariables()
+{
+    uint32_t fields = this->subscribed_fields | VehicleAttributes::Step_Fields;
+    if(this->edge_lane_counts.empty())
+        fields &= ~VehicleAttributes::Field_Road_ID;
+    else
+        fields |= VehicleAttributes::Field_Road_ID;
+    this->step_variables = VehicleAttributes::GetVariables(fields & ~VehicleAttributes::Static_Fields);
+    this->departure_variables = VehicleAttributes::GetVariables(fields);
+}
+
+/**
+ * Get the vehicles that were within SUMO during the last step.
+ * @return Unique identifiers of the vehicles that were within SUMO during the last step.
+ */
+const std::vector<std::string>& Governor::GetStepVehicleIDList()
+{
+    return this->step_id_list;
+}
\ No newline at end of file
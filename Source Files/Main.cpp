@@ -1,7 +1,21 @@
 #include "../Header Files/Experiment.h"
+#ifdef COSIMULATION_MPI
+#include <mpi.h>
+#endif
 
 int main(int argc, char** argv)
 {
+#ifdef COSIMULATION_MPI
+    MPI_Init(&argc, &argv);
+    int exit_status;
+    {
+        Experiment experiment(argc, argv);
+        exit_status = experiment.GetExitStatus();
+    }
+    MPI_Finalize();
+    return exit_status;
+#else
     Experiment experiment(argc, argv);
-    return 0;
-}
\ No newline at end of file
+    return experiment.GetExitStatus();
+#endif
+}
@@ -0,0 +1,282 @@
+#include "../Header Files/MemoryReport.h"
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+std::atomic<bool> MemoryReport::counting(false);
+std::array<std::atomic<uint64_t>, Profiler::Phase_Count + 1> MemoryReport::allocation_counts;
+std::array<std::atomic<uint64_t>, Profiler::Phase_Count + 1> MemoryReport::allocation_bytes;
+
+/**
+ * Allocations are counted by replacing the global operator new, the array and nothrow forms of which call upon it.
+ */
+void* operator new(size_t Size)
+{
+    MemoryReport::CountAllocation(Size);
+    void* pointer = std::malloc(Size == 0 ? 1 : Size);
+    if(pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* Pointer) noexcept
+{
+    std::free(Pointer);
+}
+
+/**
+ * Get the memory report shared by the whole simulation.
+ * @return Memory report shared by the whole simulation.
+ */
+MemoryReport& MemoryReport::Instance()
+{
+    static MemoryReport report;
+    return report;
+}
+
+/**
+ * Enable or disable the accounting of memory.
+ * @param Enabled True if memory should be accounted for.
+ * @param Count_Allocations True if every allocation should also be counted against the phase it was made within.
+ */
+void MemoryReport::Enable(bool Enabled, bool Count_Allocations)
+{
+    this->enabled = Enabled;
+    counting.store(Enabled && Count_Allocations, std::memory_order_relaxed);
+}
+
+/**
+ * Mark the heap in use before constructing a component, see Attribute.
+ * @return Bytes of heap in use, or zero if the report has not been enabled.
+ */
+uint64_t MemoryReport::Mark()
+{
+    return this->enabled ? GetHeapBytes() : 0;
+}
+
+/**
+ * Attribute the heap consumed since the last mark to a component of a vehicle.
+ * @param Component_Type Component that was constructed.
+ * @param Since Mark taken before the component was constructed.
+ * @return Mark to measure the next component from.
+ */
+uint64_t MemoryReport::Attribute(Component Component_Type, uint64_t Since)
+{
+    if(!this->enabled)
+        return 0;
+    uint64_t now = GetHeapBytes();
+    if(now > Since)
+        this->components[Component_Type] += now - Since;
+    return now;
+}
+
+/**
+ * Note that a vehicle has been constructed.
+ */
+void MemoryReport::AddVehicle()
+{
+    if(this->enabled)
+        this->vehicles++;
+}
+
+/**
+ * Sample the resident set size and heap in use. The first sample is the baseline growth per vehicle is measured from.
+ * @param Name Name of the point of the run.
+ * @param Time Simulation time in seconds.
+ */
+void MemoryReport::TakeSample(std::string Name, double Time)
+{
+    if(!this->enabled)
+        return;
+    Sample sample;
+    sample.Name = Name;
+    sample.Time = Time;
+    sample.Resident_Bytes = GetResidentBytes();
+    sample.Heap_Bytes = GetHeapBytes();
+    sample.Vehicles = this->vehicles;
+    this->samples.push_back(sample);
+}
+
+/**
+ * Set the estimate of memory that changes during the run, such as the waypoints queued upon each node.
+ * @param Estimate_Type What is estimated.
+ * @param Count Number of items held across every vehicle.
+ * @param Bytes_Each Approximate bytes consumed by each item.
+ */
+void MemoryReport::SetEstimate(Estimate Estimate_Type, uint64_t Count, uint64_t Bytes_Each)
+{
+    this->estimate_counts[Estimate_Type] = Count;
+    this->estimate_bytes[Estimate_Type] = Count * Bytes_Each;
+}
+
+/**
+ * Write the report as CSV and check the growth in resident memory per vehicle against the budget. Each line holds a
+ * section, the name of what it concerns, the simulation time where relevant, a count, bytes and bytes per vehicle.
+ * @param URL Name of the file the report will be written to.
+ * @param Budget Bytes of resident memory each vehicle may grow the simulation by, zero for no budget.
+ * @return False if the budget has been exceeded.
+ */
+bool MemoryReport::Report(std::string URL, double Budget)
+{
+    if(!this->enabled || URL.empty())
+        return true;
+    FILE* file = std::fopen(URL.c_str(), "w");
+    if(file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return true;
+    }
+    double vehicles = this->vehicles > 0 ? (double)this->vehicles : 1;
+    uint64_t baseline = this->samples.empty() ? 0 : this->samples.front().Resident_Bytes;
+    std::fprintf(file, "section,name,time,count,bytes,bytes_per_vehicle\n");
+    for(const auto& sample : this->samples)
+    {
+        std::fprintf(file, "resident,%s,%.3f,%llu,%llu,%.1f\n", sample.Name.c_str(), sample.Time,
+                     (unsigned long long)sample.Vehicles, (unsigned long long)sample.Resident_Bytes,
+                     sample.Vehicles > 0 ? (double)(sample.Resident_Bytes - baseline) / sample.Vehicles : 0);
+        std::fprintf(file, "heap,%s,%.3f,%llu,%llu,\n", sample.Name.c_str(), sample.Time,
+                     (unsigned long long)sample.Vehicles, (unsigned long long)sample.Heap_Bytes);
+    }
+    uint64_t peak = GetPeakResidentBytes();
+    double growth = peak > baseline ? (peak - baseline) / vehicles : 0;
+    std::fprintf(file, "peak,resident,,%llu,%llu,%.1f\n", (unsigned long long)this->vehicles,
+                 (unsigned long long)peak, growth);
+    for(int i = 0; i < Component_Count; i++)
+    {
+        std::fprintf(file, "component,%s,,%llu,%llu,%.1f\n", ComponentName((Component)i),
+                     (unsigned long long)this->vehicles, (unsigned long long)this->components[i],
+                     this->components[i] / vehicles);
+    }
+    for(int i = 0; i < Estimate_Count; i++)
+    {
+        std::fprintf(file, "estimate,%s,,%llu,%llu,%.1f\n", EstimateName((Estimate)i),
+                     (unsigned long long)this->estimate_counts[i], (unsigned long long)this->estimate_bytes[i],
+                     this->estimate_bytes[i] / vehicles);
+    }
+    if(counting.load(std::memory_order_relaxed))
+    {
+        for(int i = 0; i <= Profiler::Phase_Count; i++)
+        {
+            std::fprintf(file, "allocations,%s,,%llu,%llu,\n",
+                         i < Profiler::Phase_Count ? Profiler::PhaseName((Profiler::Phase)i) : "outside_phases",
+                         (unsigned long long)allocation_counts[i].load(std::memory_order_relaxed),
+                         (unsigned long long)allocation_bytes[i].load(std::memory_order_relaxed));
+        }
+    }
+    bool within = Budget <= 0 || growth <= Budget;
+    if(Budget > 0)
+        std::fprintf(file, "budget,resident,,%llu,%.0f,%.1f\n", (unsigned long long)this->vehicles, Budget, growth);
+    std::fclose(file);
+    if(!within)
+    {
+        std::fprintf(stderr, "Memory budget exceeded: %.0f bytes per vehicle against a budget of %.0f.\n",
+                     growth, Budget);
+    }
+    return within;
+}
+
+/**
+ * Get the resident set size of the process.
+ * @return Resident set size in bytes.
+ */
+uint64_t MemoryReport::GetResidentBytes()
+{
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    if(file != nullptr)
+    {
+        if(std::fscanf(file, "%llu %llu", &size, &resident) != 2)
+            resident = 0;
+        std::fclose(file);
+    }
+    return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Get the largest resident set size the process has reached.
+ * @return Peak resident set size in bytes.
+ */
+uint64_t MemoryReport::GetPeakResidentBytes()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_maxrss * 1024;
+}
+
+/**
+ * Get the bytes of heap allocated by the calling thread's allocator and not yet freed.
+ * @return Bytes of heap in use.
+ */
+uint64_t MemoryReport::GetHeapBytes()
+{
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+    return (uint64_t)mallinfo2().uordblks;
+#else
+    return (uint64_t)(unsigned int)mallinfo().uordblks;
+#endif
+}
+
+/**
+ * Count an allocation against the innermost phase of the calling thread, if allocations are being counted.
+ * @param Size Bytes requested.
+ */
+void MemoryReport::CountAllocation(size_t Size)
+{
+    if(!counting.load(std::memory_order_relaxed))
+        return;
+    int phase = Profiler::GetCurrentPhase();
+    allocation_counts[phase].fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes[phase].fetch_add(Size, std::memory_order_relaxed);
+}
+
+/**
+ * Get the number of allocations counted so far within every phase and outside of them.
+ * @return Number of allocations counted.
+ */
+uint64_t MemoryReport::GetAllocationCount()
+{
+    uint64_t count = 0;
+    for(const auto& phase_count : allocation_counts)
+        count += phase_count.load(std::memory_order_relaxed);
+    return count;
+}
+
+/**
+ * Get the name of a component as it appears within the report.
+ * @param Component_Type The component to name.
+ * @return Name of the component.
+ */
+const char* MemoryReport::ComponentName(Component Component_Type)
+{
+    switch(Component_Type)
+    {
+        case Node: return "node";
+        case Mobility: return "mobility";
+        case Devices: return "wave_devices";
+        case Internet_Stack: return "internet_stack";
+        case Addresses: return "ipv4_addresses";
+        case Attributes: return "vehicle_attributes";
+        case Vehicle_Object: return "vehicle";
+        case Application: return "application";
+        default: return "unknown";
+    }
+}
+
+/**
+ * Get the name of an estimate as it appears within the report.
+ * @param Estimate_Type The estimate to name.
+ * @return Name of the estimate.
+ */
+const char* MemoryReport::EstimateName(Estimate Estimate_Type)
+{
+    switch(Estimate_Type)
+    {
+        case Waypoints: return "waypoint_queues";
+        case Responses: return "response_lists";
+        default: return "unknown";
+    }
+}
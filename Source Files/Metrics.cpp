@@ -0,0 +1,260 @@
+#include "../Header Files/Metrics.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace
+{
+    const char Metrics_Magic[8] = {'C', 'O', 'S', 'I', 'M', 'T', 'R', 'C'};
+    // Version 1 divided each octave into eight buckets rather than thirty two.
+    const uint32_t Metrics_Version = 2;
+}
+
+/**
+ * Add a value to the histogram.
+ * @param Value Value to be added, negative values are counted as zero.
+ */
+void Histogram::Add(double Value)
+{
+    Value = std::max(Value, 0.0);
+    this->Minimum = this->Count == 0 ? Value : std::min(this->Minimum, Value);
+    this->Maximum = this->Count == 0 ? Value : std::max(this->Maximum, Value);
+    this->Count++;
+    this->Sum += Value;
+    this->Buckets.at(GetBucket(Value))++;
+}
+
+/**
+ * Add every value of another histogram to this one.
+ * @param Other Histogram to be merged into this one.
+ */
+void Histogram::Merge(const Histogram& Other)
+{
+    if(Other.Count == 0)
+        return;
+    this->Minimum = this->Count == 0 ? Other.Minimum : std::min(this->Minimum, Other.Minimum);
+    this->Maximum = this->Count == 0 ? Other.Maximum : std::max(this->Maximum, Other.Maximum);
+    this->Count += Other.Count;
+    this->Sum += Other.Sum;
+    for(int i = 0; i < Bucket_Count; i++)
+        this->Buckets.at(i) += Other.Buckets.at(i);
+}
+
+/**
+ * Get the value below which the given fraction of values lie.
+ * @param Fraction Fraction between zero and one.
+ * @return Upper bound of the bucket the percentile falls within, limited to the range of values added.
+ */
+double Histogram::GetPercentile(double Fraction) const
+{
+    if(this->Count == 0)
+        return 0;
+    uint64_t rank = (uint64_t)std::ceil(Fraction * this->Count);
+    uint64_t seen = 0;
+    for(int i = 0; i < Bucket_Count; i++)
+    {
+        seen += this->Buckets.at(i);
+        if(seen >= rank && seen > 0)
+            return std::max(this->Minimum, std::min(this->Maximum, GetBucketValue(i)));
+    }
+    return this->Maximum;
+}
+
+/**
+ * Get the bucket a value falls within. The first bucket holds values below 2^-10 and the last those of 2^30 or above.
+ * @param Value Non-negative value.
+ * @return Index of the bucket.
+ */
+int Histogram::GetBucket(double Value)
+{
+    int exponent;
+    double mantissa = std::frexp(Value, &exponent);
+    int octave = exponent - 1 - Octave_Minimum;
+    if(Value <= 0 || octave < 0)
+        return 0;
+    if(octave >= Octave_Count)
+        return Bucket_Count - 1;
+    return 1 + octave * Sub_Buckets + (int)((mantissa * 2 - 1) * Sub_Buckets);
+}
+
+/**
+ * Get the upper bound of a bucket. The first bucket is given as zero as it mostly holds values that are exactly zero,
+ * such as negotiations that needed no retries.
+ * @param Bucket Index of the bucket.
+ * @return Upper bound of the bucket.
+ */
+double Histogram::GetBucketValue(int Bucket)
+{
+    if(Bucket == 0)
+        return 0;
+    if(Bucket == Bucket_Count - 1)
+        return std::ldexp(1.0, Octave_Minimum + Octave_Count);
+    int octave = (Bucket - 1) / Sub_Buckets;
+    int sub_bucket = (Bucket - 1) % Sub_Buckets;
+    return std::ldexp(1.0 + (sub_bucket + 1) / (double)Sub_Buckets, Octave_Minimum + octave);
+}
+
+/**
+ * Get the metrics shared by the whole simulation.
+ * @return Metrics shared by the whole simulation.
+ */
+Metrics& Metrics::Instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+/**
+ * Enable or disable the collection of metrics.
+ * @param Enabled True if metrics should be collected.
+ */
+void Metrics::Enable(bool Enabled)
+{
+    this->enabled = Enabled;
+}
+
+/**
+ * Write the collected metrics. The summary will be written as CSV, with percentiles read from each histogram, if the
+ * file name ends with '.csv' otherwise the tallies and complete histograms are written in binary, see MetricsHeader.
+ * @param URL Name of the file the metrics will be written to.
+ */
+void Metrics::Write(std::string URL)
+{
+    if(!this->enabled || URL.empty())
+        return;
+    FILE* file = std::fopen(URL.c_str(), "wb");
+    if(file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return;
+    }
+    bool csv = URL.size() >= 4 && URL.compare(URL.size() - 4, 4, ".csv") == 0;
+    if(csv)
+    {
+        std::fprintf(file, "name,count,mean,min,p50,p90,p99,max\n");
+        for(int i = 0; i < Tally_Count; i++)
+            std::fprintf(file, "%s,%llu,,,,,,\n", TallyName((Tally)i), (unsigned long long)this->tallies[i]);
+        for(int i = 0; i < Distribution_Count; i++)
+        {
+            const Histogram& histogram = this->distributions[i];
+            std::fprintf(file, "%s,%llu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n", DistributionName((Distribution)i),
+                         (unsigned long long)histogram.Count, histogram.Count ? histogram.Sum / histogram.Count : 0,
+                         histogram.Minimum, histogram.GetPercentile(0.5), histogram.GetPercentile(0.9),
+                         histogram.GetPercentile(0.99), histogram.Maximum);
+        }
+    }
+    else
+    {
+        MetricsHeader header;
+        std::memset(&header, 0, sizeof(MetricsHeader));
+        std::memcpy(header.Magic, Metrics_Magic, sizeof(Metrics_Magic));
+        header.Version = Metrics_Version;
+        header.Tally_Count = Tally_Count;
+        header.Distribution_Count = Distribution_Count;
+        header.Bucket_Count = Histogram::Bucket_Count;
+        std::fwrite(&header, sizeof(MetricsHeader), 1, file);
+        std::fwrite(this->tallies.data(), sizeof(uint64_t), this->tallies.size(), file);
+        for(const auto& histogram : this->distributions)
+        {
+            MetricsDistribution distribution = {histogram.Count, histogram.Sum, histogram.Minimum, histogram.Maximum};
+            std::fwrite(&distribution, sizeof(MetricsDistribution), 1, file);
+            std::fwrite(histogram.Buckets.data(), sizeof(uint64_t), histogram.Buckets.size(), file);
+        }
+    }
+    std::fclose(file);
+}
+
+/**
+ * Read a binary metrics file in place of the metrics collected so far. Files of another version, or whose counts differ
+ * from those of this build, are rejected as their buckets cannot be interpreted.
+ * @param URL Name of the binary metrics file.
+ * @return True if the file was read.
+ */
+bool Metrics::Read(std::string URL)
+{
+    FILE* file = std::fopen(URL.c_str(), "rb");
+    if(file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    MetricsHeader header;
+    if(std::fread(&header, sizeof(MetricsHeader), 1, file) != 1 ||
+       std::memcmp(header.Magic, Metrics_Magic, sizeof(Metrics_Magic)) != 0)
+    {
+        std::fprintf(stderr, "%s is not a binary metrics file.\n", URL.c_str());
+        std::fclose(file);
+        return false;
+    }
+    if(header.Version != Metrics_Version || header.Tally_Count != Tally_Count ||
+       header.Distribution_Count != Distribution_Count || header.Bucket_Count != Histogram::Bucket_Count)
+    {
+        std::fprintf(stderr, "%s is version %u of the metrics file with %u tallies, %u distributions and %u buckets, "
+                     "expected version %u with %d, %d and %d.\n", URL.c_str(), header.Version, header.Tally_Count,
+                     header.Distribution_Count, header.Bucket_Count, Metrics_Version, (int)Tally_Count,
+                     (int)Distribution_Count, Histogram::Bucket_Count);
+        std::fclose(file);
+        return false;
+    }
+    std::array<uint64_t, Tally_Count> tallies;
+    std::array<Histogram, Distribution_Count> distributions;
+    bool complete = std::fread(tallies.data(), sizeof(uint64_t), tallies.size(), file) == tallies.size();
+    for(auto& histogram : distributions)
+    {
+        MetricsDistribution distribution;
+        complete = complete && std::fread(&distribution, sizeof(MetricsDistribution), 1, file) == 1 &&
+                   std::fread(histogram.Buckets.data(), sizeof(uint64_t), histogram.Buckets.size(), file) ==
+                   histogram.Buckets.size();
+        histogram.Count = distribution.Count;
+        histogram.Sum = distribution.Sum;
+        histogram.Minimum = distribution.Minimum;
+        histogram.Maximum = distribution.Maximum;
+    }
+    std::fclose(file);
+    if(!complete)
+    {
+        std::fprintf(stderr, "%s is truncated.\n", URL.c_str());
+        return false;
+    }
+    this->tallies = tallies;
+    this->distributions = distributions;
+    return true;
+}
+
+/**
+ * Get the name of a tally as it appears within the summary.
+ * @param Tally_Type The tally to name.
+ * @return Name of the tally.
+ */
+const char* Metrics::TallyName(Tally Tally_Type)
+{
+    switch(Tally_Type)
+    {
+        case Negotiations_Started: return "negotiations_started";
+        case Negotiations_Completed: return "negotiations_completed";
+        case Negotiations_Abandoned: return "negotiations_abandoned";
+        case Recommendations_Accepted: return "recommendations_accepted";
+        case Recommendations_Deferred: return "recommendations_deferred";
+        case Retries: return "retries";
+        case Trips_Completed: return "trips_completed";
+        default: return "unknown";
+    }
+}
+
+/**
+ * Get the name of a distribution as it appears within the summary.
+ * @param Distribution_Type The distribution to name.
+ * @return Name of the distribution.
+ */
+const char* Metrics::DistributionName(Distribution Distribution_Type)
+{
+    switch(Distribution_Type)
+    {
+        case Recommendation_Latency_MS: return "recommendation_latency_ms";
+        case Completion_Time_S: return "completion_time_s";
+        case Negotiation_Retries: return "negotiation_retries";
+        case Travel_Time_S: return "travel_time_s";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,49 @@
+#include "../Header Files/Telemetry.h"
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <signal.h>
+
+/**
+ * Attach to the telemetry segment published by a running simulation and display it until the simulation finishes.
+ * Usage: CosimulationMonitor <segment name> [refresh interval in seconds]
+ */
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <segment name> [refresh interval in seconds]\n", argv[0]);
+        return 1;
+    }
+    double interval = argc > 2 ? std::stod(argv[2]) : 1.0;
+    Telemetry telemetry;
+    while(!telemetry.Attach(argv[1]))
+    {
+        std::fprintf(stderr, "Waiting for %s...\n", Telemetry::SegmentName(argv[1]).c_str());
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    TelemetrySnapshot snapshot;
+    std::printf("%10s %12s %10s %10s %10s %12s %10s\n", "Steps", "Sim Time (s)", "Steps/s", "Vehicles",
+                "Pending", "Queue Depth", "RSS (MiB)");
+    while(true)
+    {
+        if(telemetry.Read(snapshot))
+        {
+            std::printf("%10llu %12.1f %10.2f %10llu %10llu %12llu %10.1f\n", (unsigned long long)snapshot.Steps,
+                        snapshot.Simulated_Time, snapshot.Steps_Per_Second,
+                        (unsigned long long)snapshot.Active_Vehicles, (unsigned long long)snapshot.Pending_Negotiations,
+                        (unsigned long long)snapshot.Queue_Depth, snapshot.Resident_Set_Bytes / (1024.0 * 1024.0));
+            std::fflush(stdout);
+            if(snapshot.Finished)
+                break;
+            if(kill((pid_t)snapshot.Process_ID, 0) == -1)
+            {
+                std::fprintf(stderr, "Simulation %lld is no longer running.\n", (long long)snapshot.Process_ID);
+                return 1;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "../Header Files/NetworkAbstraction.h"
+#include <cmath>
+#include <algorithm>
+#include <ns3/ipv4.h>
+#include <ns3/mobility-model.h>
+#include <ns3/inet-socket-address.h>
+#include "../Header Files/VehicleApplication.h"
+
+using namespace ns3;
+
+/**
+ * Construct a new network abstraction.
+ * @param Enabled Whether the abstraction stands in for the network.
+ * @param Range Distance in metres at which half of all exchanges succeed.
+ * @param Fade_Width Distance in metres over which the probability of success falls away around the range.
+ * @param Latency Latency of an exchange between two vehicles at no distance from one another in milliseconds.
+ * @param Latency_Per_Metre Latency added to an exchange per metre between the two vehicles in milliseconds.
+ * @param Seed The random generator will be seeded with this value.
+ * @param Calibration_URL Name of the file the outcome of each exchange over the full network is written to, if any.
+ */
+NetworkAbstraction::NetworkAbstraction(bool Enabled, double Range, double Fade_Width, double Latency,
+                                       double Latency_Per_Metre, int Seed, std::string Calibration_URL)
+{
+    this->enabled = Enabled;
+    this->range = Range;
+    this->fade_width = Fade_Width;
+    this->latency_ms = Latency;
+    this->latency_per_metre_ms = Latency_Per_Metre;
+    this->random_generator = std::mt19937(Seed);
+    if(!Enabled && !Calibration_URL.empty())
+    {
+        this->observations.open(Calibration_URL);
+        this->observations << "distance,delivered,latency_ms\n";
+    }
+}
+
+/**
+ * Determine if the abstraction stands in for the network.
+ * @return True if the abstraction stands in for the network.
+ */
+bool NetworkAbstraction::IsEnabled()
+{
+    return this->enabled;
+}
+
+/**
+ * Determine if the outcome of each exchange over the full network is being recorded.
+ * @return True if exchanges are being recorded.
+ */
+bool NetworkAbstraction::IsObserving()
+{
+    return this->observations.is_open();
+}
+
+/**
+ * Register an application so that it may be reached by others.
+ * @param Application Application installed upon a vehicle with an address already assigned.
+ * @return Address packets from the application would be received from.
+ */
+Address NetworkAbstraction::Register(Ptr<VehicleApplication> Application)
+{
+    Ipv4Address local = Application->GetNode()->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+    Address address = InetSocketAddress(local, 80);
+    this->address_indices[address] = this->applications.size();
+    this->applications.push_back(Application);
+    this->addresses.push_back(address);
+    return address;
+}
+
+/**
+ * Get every vehicle present within the simulation that is close enough to the sender to have any real chance of
+ * hearing it.
+ * @param Sender Node of the sending vehicle.
+ * @return Neighbours of the sender.
+ */
+std::vector<AbstractNeighbour> NetworkAbstraction::GetNeighbours(Ptr<Node> Sender)
+{
+    std::vector<AbstractNeighbour> neighbours;
+    double cutoff = this->range + 8 * this->fade_width;
+    for(size_t i = 0; i < this->applications.size(); i++)
+    {
+        Ptr<Node> node = this->applications.at(i)->GetNode();
+        if(node == Sender || node->GetObject<MobilityModel>()->GetPosition().z == 10000)
+            continue;
+        double distance = this->GetDistance(Sender, node);
+        if(distance <= cutoff)
+            neighbours.push_back({this->applications.at(i), this->addresses.at(i), distance});
+    }
+    return neighbours;
+}
+
+/**
+ * Get the application registered at the given address.
+ * @param Recipient Address of the application.
+ * @return Application registered at the address or a null pointer if there is none.
+ */
+Ptr<VehicleApplication> NetworkAbstraction::GetApplication(const Address& Recipient)
+{
+    auto iterator = this->address_indices.find(Recipient);
+    if(iterator == this->address_indices.end())
+        return nullptr;
+    return this->applications.at(iterator->second);
+}
+
+/**
+ * Get the distance between two nodes.
+ * @param Sender First node.
+ * @param Recipient Second node.
+ * @return Distance between the two nodes in metres.
+ */
+double NetworkAbstraction::GetDistance(Ptr<Node> Sender, Ptr<Node> Recipient)
+{
+    return Sender->GetObject<MobilityModel>()->GetDistanceFrom(Recipient->GetObject<MobilityModel>());
+}
+
+/**
+ * Get the probability that an exchange between two vehicles succeeds.
+ * @param Distance Distance between the two vehicles in metres.
+ * @return Probability that the exchange succeeds.
+ */
+double NetworkAbstraction::GetDeliveryProbability(double Distance)
+{
+    return 1.0 / (1.0 + std::exp((Distance - this->range) / this->fade_width));
+}
+
+/**
+ * Draw whether an exchange between two vehicles succeeds.
+ * @param Distance Distance between the two vehicles in metres.
+ * @return True if the exchange succeeds.
+ */
+bool NetworkAbstraction::IsDelivered(double Distance)
+{
+    return this->distribution(this->random_generator) < this->GetDeliveryProbability(Distance);
+}
+
+/**
+ * Get the latency of an exchange between two vehicles.
+ * @param Distance Distance between the two vehicles in metres.
+ * @return Latency of the exchange, a fit that falls below zero at short distances being held at zero.
+ */
+Time NetworkAbstraction::GetLatency(double Distance)
+{
+    double latency_ms = std::max(0.0, this->latency_ms + this->latency_per_metre_ms * Distance);
+    return MicroSeconds((uint64_t)(latency_ms * 1000));
+}
+
+/**
+ * Record the outcome of an exchange carried out over the full network.
+ * @param Distance Distance between the two vehicles in metres.
+ * @param Delivered Whether a response was received.
+ * @param Latency Time between the request being made and the response being received.
+ */
+void NetworkAbstraction::Observe(double Distance, bool Delivered, Time Latency)
+{
+    this->observations << Distance << "," << Delivered << "," << (Delivered ? Latency.GetSeconds() * 1000 : 0) << "\n";
+}
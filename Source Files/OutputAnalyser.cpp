@@ -0,0 +1,264 @@
+#include "../Header Files/OutputAnalyser.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    /**
+     * Find the first occurrence of a string within a range, returning the end of the range if there is none.
+     */
+    const char* Find(const char* Begin, const char* End, const char* Needle)
+    {
+        size_t length = std::strlen(Needle);
+        while(Begin + length <= End)
+        {
+            const char* match = (const char*)std::memchr(Begin, Needle[0], End - Begin - length + 1);
+            if(match == nullptr)
+                break;
+            if(std::memcmp(match, Needle, length) == 0)
+                return match;
+            Begin = match + 1;
+        }
+        return End;
+    }
+
+    bool IsSpace(char Character)
+    {
+        return Character == ' ' || Character == '\t' || Character == '\n' || Character == '\r';
+    }
+
+    bool Equals(const char* Begin, const char* End, const char* Name)
+    {
+        size_t length = std::strlen(Name);
+        return (size_t)(End - Begin) == length && std::memcmp(Begin, Name, length) == 0;
+    }
+
+    /**
+     * An attribute of an element as a range of the file.
+     */
+    struct Attribute
+    {
+        const char* Name;
+        const char* Name_End;
+        const char* Value;
+        const char* Value_End;
+    };
+
+    /**
+     * Read the next attribute of an element, leaving the position at the character following it.
+     * @return False once the end of the element has been reached.
+     */
+    bool NextAttribute(const char*& Position, const char* End, Attribute& Next)
+    {
+        while(Position < End && IsSpace(*Position))
+            Position++;
+        if(Position >= End || *Position == '/' || *Position == '>')
+            return false;
+        Next.Name = Position;
+        while(Position < End && *Position != '=' && !IsSpace(*Position))
+            Position++;
+        Next.Name_End = Position;
+        while(Position < End && *Position != '"' && *Position != '\'')
+            Position++;
+        if(Position >= End)
+            return false;
+        char quote = *Position++;
+        Next.Value = Position;
+        const char* value_end = (const char*)std::memchr(Position, quote, End - Position);
+        Next.Value_End = value_end == nullptr ? End : value_end;
+        Position = Next.Value_End + 1;
+        return true;
+    }
+}
+
+/**
+ * Give a name its index, adding it to the table should it be new.
+ * @param Name Beginning of the name.
+ * @param Length Length of the name.
+ * @return Index of the name.
+ */
+int NameTable::Intern(const char* Name, size_t Length)
+{
+    for(size_t i = 0; i < this->Names.size(); i++)
+    {
+        if(this->Names.at(i).size() == Length && std::memcmp(this->Names.at(i).data(), Name, Length) == 0)
+            return (int)i;
+    }
+    this->Names.emplace_back(Name, Length);
+    return (int)this->Names.size() - 1;
+}
+
+/**
+ * Add the statistics of another summary to this one. Names are matched by value as each summary numbers its own.
+ * @param Other Summary to be merged into this one.
+ */
+void OutputSummary::Merge(const OutputSummary& Other)
+{
+    this->Files += Other.Files;
+    this->Trips += Other.Trips;
+    this->Lane_Changes += Other.Lane_Changes;
+    this->Travel_Time.Merge(Other.Travel_Time);
+    this->Time_Loss.Merge(Other.Time_Loss);
+    this->Depart_Delay.Merge(Other.Depart_Delay);
+    for(const auto& pair : Other.Lane_Pairs)
+    {
+        const std::string& from = Other.Lanes.Names.at(pair.first.first);
+        const std::string& to = Other.Lanes.Names.at(pair.first.second);
+        std::pair<int, int> key(this->Lanes.Intern(from.data(), from.size()), this->Lanes.Intern(to.data(), to.size()));
+        this->Lane_Pairs[key] += pair.second;
+    }
+    for(size_t i = 0; i < Other.Reason_Counts.size(); i++)
+    {
+        const std::string& reason = Other.Reasons.Names.at(i);
+        size_t index = (size_t)this->Reasons.Intern(reason.data(), reason.size());
+        if(index >= this->Reason_Counts.size())
+            this->Reason_Counts.resize(index + 1, 0);
+        this->Reason_Counts.at(index) += Other.Reason_Counts.at(i);
+    }
+}
+
+/**
+ * Memory map a file and add its statistics to the summary.
+ * @param URL Name of the file.
+ * @param Summary Summary the statistics of the file are added to.
+ * @return Type of output the file held, Unknown if it was neither or could not be read.
+ */
+OutputAnalyser::Output OutputAnalyser::Analyse(std::string URL, OutputSummary& Summary)
+{
+    int descriptor = open(URL.c_str(), O_RDONLY);
+    if(descriptor == -1)
+    {
+        std::perror(URL.c_str());
+        return Unknown;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) == -1 || status.st_size == 0)
+    {
+        close(descriptor);
+        return Unknown;
+    }
+    void* mapping = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+    {
+        std::perror(URL.c_str());
+        return Unknown;
+    }
+    madvise(mapping, (size_t)status.st_size, MADV_SEQUENTIAL);
+    const char* begin = (const char*)mapping;
+    Output output = Scan(begin, begin + status.st_size, Summary);
+    munmap(mapping, (size_t)status.st_size);
+    if(output != Unknown)
+        Summary.Files++;
+    return output;
+}
+
+/**
+ * Scan the contents of a trip info or lane change output in a single pass.
+ * 1. Skip the XML declaration, comments (SUMO writes its configuration within one) and closing tags.
+ * 2. Determine the type of output from the root element, giving up if it is neither.
+ * 3. Read the duration, time loss and depart delay of each tripinfo element.
+ * 4. Read the lanes and reason of each change element.
+ * @param Begin Beginning of the contents.
+ * @param End End of the contents.
+ * @param Summary Summary the statistics of the output are added to.
+ * @return Type of output scanned.
+ */
+OutputAnalyser::Output OutputAnalyser::Scan(const char* Begin, const char* End, OutputSummary& Summary)
+{
+    Output output = Unknown;
+    const char* position = Begin;
+    while(position < End)
+    {
+        position = (const char*)std::memchr(position, '<', End - position);
+        if(position == nullptr)
+            break;
+        position++;
+        if(End - position >= 3 && std::memcmp(position, "!--", 3) == 0)
+        {
+            position = Find(position + 3, End, "-->");
+            continue;
+        }
+        if(position < End && (*position == '?' || *position == '!' || *position == '/'))
+            continue;
+        const char* name = position;
+        while(position < End && !IsSpace(*position) && *position != '/' && *position != '>')
+            position++;
+        if(output == Unknown)
+        {
+            if(Equals(name, position, "tripinfos"))
+                output = Trip_Info;
+            else if(Equals(name, position, "lanechanges"))
+                output = Lane_Change;
+            else
+                return Unknown;
+            continue;
+        }
+        Attribute attribute;
+        if(output == Trip_Info && Equals(name, position, "tripinfo"))
+        {
+            while(NextAttribute(position, End, attribute))
+            {
+                if(Equals(attribute.Name, attribute.Name_End, "duration"))
+                    Summary.Travel_Time.Add(ParseDecimal(attribute.Value, attribute.Value_End));
+                else if(Equals(attribute.Name, attribute.Name_End, "timeLoss"))
+                    Summary.Time_Loss.Add(ParseDecimal(attribute.Value, attribute.Value_End));
+                else if(Equals(attribute.Name, attribute.Name_End, "departDelay"))
+                    Summary.Depart_Delay.Add(ParseDecimal(attribute.Value, attribute.Value_End));
+            }
+            Summary.Trips++;
+        }
+        else if(output == Lane_Change && Equals(name, position, "change"))
+        {
+            int from = -1, to = -1, reason = -1;
+            while(NextAttribute(position, End, attribute))
+            {
+                size_t length = attribute.Value_End - attribute.Value;
+                if(Equals(attribute.Name, attribute.Name_End, "from"))
+                    from = Summary.Lanes.Intern(attribute.Value, length);
+                else if(Equals(attribute.Name, attribute.Name_End, "to"))
+                    to = Summary.Lanes.Intern(attribute.Value, length);
+                else if(Equals(attribute.Name, attribute.Name_End, "reason"))
+                    reason = Summary.Reasons.Intern(attribute.Value, length);
+            }
+            Summary.Lane_Changes++;
+            if(from != -1 && to != -1)
+                Summary.Lane_Pairs[std::pair<int, int>(from, to)]++;
+            if(reason != -1)
+            {
+                if((size_t)reason >= Summary.Reason_Counts.size())
+                    Summary.Reason_Counts.resize(reason + 1, 0);
+                Summary.Reason_Counts.at(reason)++;
+            }
+        }
+    }
+    return output;
+}
+
+/**
+ * Parse a decimal number such as those written by SUMO, without the need for it to be followed by a terminator.
+ * @param Begin Beginning of the number.
+ * @param End End of the number.
+ * @return Value of the number, zero if it is not a number.
+ */
+double OutputAnalyser::ParseDecimal(const char* Begin, const char* End)
+{
+    bool negative = Begin < End && *Begin == '-';
+    if(negative)
+        Begin++;
+    double value = 0;
+    while(Begin < End && *Begin >= '0' && *Begin <= '9')
+        value = value * 10 + (*Begin++ - '0');
+    if(Begin < End && *Begin == '.')
+    {
+        double scale = 0.1;
+        for(Begin++; Begin < End && *Begin >= '0' && *Begin <= '9'; Begin++, scale *= 0.1)
+            value += (*Begin - '0') * scale;
+    }
+    return negative ? -value : value;
+}
@@ -0,0 +1,195 @@
+#include "../Header Files/PacketTrace.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <ns3/simulator.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-net-device.h>
+
+using namespace ns3;
+
+namespace
+{
+    const char Trace_Magic[8] = {'C', 'O', 'S', 'I', 'P', 'K', 'T', 0};
+    const uint32_t Trace_Version = 1;
+
+    /**
+     * Record a packet seen by a device of the given node, bound to each trace source of the MAC and PHY.
+     */
+    template<PacketTrace::Outcome Point>
+    void RecordDevice(uint32_t Node, Ptr<const Packet> Packet)
+    {
+        PacketTrace::Instance().Record(Point, Simulator::Now().GetNanoSeconds(), Node, PacketTrace::Unknown_Context,
+                                       Packet->GetSize());
+    }
+
+    /**
+     * Write the whole of a buffer to a file descriptor using only calls that are safe within a signal handler.
+     */
+    bool WriteFully(int File, const char* Buffer, size_t Length)
+    {
+        while(Length > 0)
+        {
+            ssize_t written = write(File, Buffer, Length);
+            if(written <= 0)
+                return false;
+            Buffer += written;
+            Length -= (size_t)written;
+        }
+        return true;
+    }
+}
+
+/**
+ * Get the packet trace shared by the whole run.
+ * @return The packet trace.
+ */
+PacketTrace& PacketTrace::Instance()
+{
+    static PacketTrace instance;
+    return instance;
+}
+
+/**
+ * Enable the trace, allocating its ring buffer and installing the handler of SIGUSR1. Without a URL the trace is
+ * disabled.
+ * @param URL Name of the file the trace is written to.
+ * @param Capacity Number of records held, rounded up to a power of two.
+ * @param Node_Stride Only nodes whose identifier is a multiple of this are traced.
+ * @param Start Simulation time in seconds the trace begins at.
+ * @param Stop Simulation time in seconds the trace ends at, or zero to trace until the end of the run.
+ */
+void PacketTrace::Enable(std::string URL, size_t Capacity, uint32_t Node_Stride, double Start, double Stop)
+{
+    this->enabled = !URL.empty() && URL.size() < sizeof(this->url);
+    if(!this->enabled)
+        return;
+    std::strcpy(this->url, URL.c_str());
+    size_t capacity = 1;
+    while(capacity < Capacity)
+        capacity <<= 1;
+    this->records.assign(capacity, PacketRecord());
+    this->mask = capacity - 1;
+    this->next.store(0);
+    this->node_stride = Node_Stride > 0 ? Node_Stride : 1;
+    this->start_ns = (int64_t)std::llround(Start * 1e9);
+    this->stop_ns = Stop > 0 ? (int64_t)std::llround(Stop * 1e9) : INT64_MAX;
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = Dump;
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, nullptr);
+}
+
+/**
+ * Connect to the trace sources of the MAC and PHY of each WAVE device of a node, if the node is sampled.
+ * @param Node Node the devices belong to.
+ * @param Devices Devices installed upon the node.
+ */
+void PacketTrace::Attach(Ptr<Node> Node, const NetDeviceContainer& Devices)
+{
+    uint32_t node = Node->GetId();
+    if(!this->IsSampled(node))
+        return;
+    for(uint32_t i = 0; i < Devices.GetN(); i++)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(Devices.Get(i));
+        if(!device)
+            continue;
+        Ptr<WifiMac> mac = device->GetMac();
+        mac->TraceConnectWithoutContext("MacTx", MakeBoundCallback(&RecordDevice<MAC_Sent>, node));
+        mac->TraceConnectWithoutContext("MacRx", MakeBoundCallback(&RecordDevice<MAC_Received>, node));
+        mac->TraceConnectWithoutContext("MacTxDrop", MakeBoundCallback(&RecordDevice<MAC_Dropped>, node));
+        mac->TraceConnectWithoutContext("MacRxDrop", MakeBoundCallback(&RecordDevice<MAC_Dropped>, node));
+        Ptr<WifiPhy> phy = device->GetPhy();
+        phy->TraceConnectWithoutContext("PhyTxBegin", MakeBoundCallback(&RecordDevice<PHY_Sent>, node));
+        phy->TraceConnectWithoutContext("PhyRxEnd", MakeBoundCallback(&RecordDevice<PHY_Received>, node));
+        phy->TraceConnectWithoutContext("PhyRxDrop", MakeBoundCallback(&RecordDevice<PHY_Dropped>, node));
+    }
+}
+
+/**
+ * Write the records held by the ring buffer, oldest first, if the trace has been enabled. Only calls that are safe
+ * within a signal handler are made so that the trace may be written upon SIGUSR1.
+ * @return True if the trace was written or there was nothing to write.
+ */
+bool PacketTrace::Write()
+{
+    if(!this->enabled)
+        return true;
+    uint64_t next = this->next.load();
+    uint64_t capacity = this->mask + 1;
+    PacketTraceHeader header;
+    std::memset(&header, 0, sizeof(PacketTraceHeader));
+    std::memcpy(header.Magic, Trace_Magic, sizeof(Trace_Magic));
+    header.Version = Trace_Version;
+    header.Record_Size = sizeof(PacketRecord);
+    header.Record_Count = next < capacity ? next : capacity;
+    header.Overwritten = next - header.Record_Count;
+    int file = open(this->url, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(file == -1)
+        return false;
+    // The oldest record lies just after the newest once the buffer has wrapped.
+    uint64_t first = header.Overwritten & this->mask;
+    const char* records = (const char*)this->records.data();
+    bool written = WriteFully(file, (const char*)&header, sizeof(PacketTraceHeader)) &&
+                   WriteFully(file, records + first * sizeof(PacketRecord),
+                              (header.Record_Count - (header.Overwritten ? first : 0)) * sizeof(PacketRecord)) &&
+                   (header.Overwritten == 0 || WriteFully(file, records, first * sizeof(PacketRecord)));
+    return close(file) == 0 && written;
+}
+
+/**
+ * Write the trace upon SIGUSR1.
+ * @param Signal The signal received.
+ */
+void PacketTrace::Dump(int Signal)
+{
+    Instance().Write();
+}
+
+/**
+ * Read a packet trace written by Write.
+ * @param URL Name of the trace file.
+ * @param Records Records of the trace, oldest first.
+ * @param Overwritten Number of records lost to the ring buffer wrapping.
+ * @return True if the trace could be read.
+ */
+bool PacketTrace::Read(std::string URL, std::vector<PacketRecord>& Records, uint64_t& Overwritten)
+{
+    std::ifstream file(URL, std::ios::binary);
+    PacketTraceHeader header;
+    if(!file.read((char*)&header, sizeof(PacketTraceHeader)) ||
+       std::memcmp(header.Magic, Trace_Magic, sizeof(Trace_Magic)) != 0 || header.Version != Trace_Version ||
+       header.Record_Size != sizeof(PacketRecord))
+    {
+        std::fprintf(stderr, "%s is not a packet trace.\n", URL.c_str());
+        return false;
+    }
+    Records.resize(header.Record_Count);
+    Overwritten = header.Overwritten;
+    if(!file.read((char*)Records.data(), Records.size() * sizeof(PacketRecord)))
+    {
+        std::fprintf(stderr, "%s is incomplete.\n", URL.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Get the name of a point at which packets are traced, as written by CosimulationPacketTrace.
+ * @param Point The point.
+ * @return Name of the point.
+ */
+const char* PacketTrace::OutcomeName(Outcome Point)
+{
+    static const char* const names[Outcome_Count] = {"application_sent", "application_received", "mac_sent",
+                                                     "mac_received", "mac_dropped", "phy_sent", "phy_received",
+                                                     "phy_dropped"};
+    return Point < Outcome_Count ? names[Point] : "unknown";
+}
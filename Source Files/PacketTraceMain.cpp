@@ -0,0 +1,31 @@
+#include "../Header Files/PacketTrace.h"
+#include <cstdio>
+
+/**
+ * Print a packet trace as CSV, one record per line with the time in nanoseconds, the node, the context of the packet
+ * (or unknown beneath the application), its size in bytes and the point at which it was seen.
+ * Usage: CosimulationPacketTrace <packet trace>
+ */
+int main(int argc, char** argv)
+{
+    if(argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <packet trace>\n", argv[0]);
+        return 1;
+    }
+    std::vector<PacketRecord> records;
+    uint64_t overwritten = 0;
+    if(!PacketTrace::Read(argv[1], records, overwritten))
+        return 1;
+    if(overwritten > 0)
+        std::fprintf(stderr, "%llu earlier records were overwritten.\n", (unsigned long long)overwritten);
+    static const char* const contexts[] = {"get", "response", "command"};
+    std::printf("time_ns,node,context,size,outcome\n");
+    for(const auto& record : records)
+    {
+        std::printf("%lld,%u,%s,%u,%s\n", (long long)record.Time_NS, record.Node,
+                    record.Context < 3 ? contexts[record.Context] : "unknown", (unsigned)record.Size,
+                    PacketTrace::OutcomeName((PacketTrace::Outcome)record.Outcome));
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "../Header Files/Partition.h"
+#include <algorithm>
+
+/**
+ * Construct the partition of the road belonging to a single process.
+ * @param Rank Index of the process.
+ * @param Size Number of processes.
+ * @param Road_Length Length of the road along the x axis in metres.
+ * @param Halo_Width Distance beyond either end of the segment within which vehicles are also simulated in metres.
+ */
+Partition::Partition(int Rank, int Size, double Road_Length, double Halo_Width)
+{
+    this->rank = Rank;
+    this->size = Size;
+    this->segment_length = Road_Length / Size;
+    this->halo_width = Halo_Width;
+}
+
+/**
+ * Get the process that owns the segment containing the given position. Positions beyond either end of the road belong
+ * to the first or last segment.
+ * @param X Position along the road in metres.
+ * @return Index of the process owning the position.
+ */
+int Partition::GetOwner(double X)
+{
+    return std::min(std::max((int)(X / this->segment_length), 0), this->size - 1);
+}
+
+/**
+ * Determine if this process owns the segment containing the given position.
+ * @param X Position along the road in metres.
+ * @return True if this process owns the position.
+ */
+bool Partition::Owns(double X)
+{
+    return this->GetOwner(X) == this->rank;
+}
+
+/**
+ * Determine if the given position lies within the segment of this process or its halo.
+ * @param X Position along the road in metres.
+ * @return True if vehicles at the position are simulated by this process.
+ */
+bool Partition::IsVisible(double X)
+{
+    if(this->Owns(X))
+        return true;
+    double start = this->rank * this->segment_length;
+    double end = start + this->segment_length;
+    return (this->rank == 0 || X >= start - this->halo_width) &&
+           (this->rank == this->size - 1 || X < end + this->halo_width);
+}
@@ -0,0 +1,216 @@
+#include "../Header Files/Profiler.h"
+#include "../Header Files/DeadlineMonitor.h"
+#include <cstdio>
+#include <algorithm>
+
+namespace
+{
+    thread_local Profiler::Phase current_phase = Profiler::Phase_Count;
+}
+
+/**
+ * Start timing a phase if the profiler, or the accounting of step deadlines, has been enabled.
+ * @param Phase_Type The phase the enclosing block belongs to.
+ */
+Profiler::Scope::Scope(Phase Phase_Type)
+{
+    this->phase = Phase_Type;
+    this->previous = current_phase;
+    current_phase = Phase_Type;
+    this->active = Profiler::Instance().IsEnabled() || DeadlineMonitor::Instance().IsEnabled();
+    if(this->active)
+        this->start = Clock::now();
+}
+
+/**
+ * Stop timing the phase and record the elapsed time against it.
+ */
+Profiler::Scope::~Scope()
+{
+    current_phase = this->previous;
+    if(this->active)
+        Profiler::Instance().Record(this->phase, Clock::now() - this->start);
+}
+
+/**
+ * Get the profiler shared by the whole simulation.
+ * @return Profiler shared by the whole simulation.
+ */
+Profiler& Profiler::Instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+/**
+ * Enable or disable the recording of timings and counters.
+ * @param Enabled True if instrumentation should be recorded.
+ */
+void Profiler::Enable(bool Enabled)
+{
+    this->enabled = Enabled;
+    this->run_start = Clock::now();
+    this->last_step = Clock::time_point();
+}
+
+/**
+ * Attribute an amount of elapsed wall time to a phase, and to the current step of the deadline monitor.
+ * @param Phase_Type The phase that has been carried out.
+ * @param Elapsed The wall time spent within the phase.
+ */
+void Profiler::Record(Phase Phase_Type, Clock::duration Elapsed)
+{
+    DeadlineMonitor::Instance().AddPhase(Phase_Type, Elapsed);
+    if(!this->enabled)
+        return;
+    this->phase_calls[Phase_Type]++;
+    this->phase_totals[Phase_Type] += Elapsed;
+}
+
+/**
+ * Mark the beginning of a new co-simulation step. The wall time between consecutive marks is recorded as the time taken
+ * by a step, which includes both the SUMO side and all of the NS-3 events processed in between.
+ */
+void Profiler::MarkStep()
+{
+    if(!this->enabled)
+        return;
+    Clock::time_point now = Clock::now();
+    if(this->last_step != Clock::time_point())
+        this->step_times.push_back(std::chrono::duration<double, std::milli>(now - this->last_step).count());
+    this->last_step = now;
+}
+
+/**
+ * Get the innermost phase the calling thread is within.
+ * @return The innermost phase or Phase_Count if the thread is not within any phase.
+ */
+Profiler::Phase Profiler::GetCurrentPhase()
+{
+    return current_phase;
+}
+
+/**
+ * Write a report of the recorded instrumentation. The report will be written as CSV if the file name ends with '.csv'
+ * otherwise JSON will be used.
+ * 1. Sort the step times so that percentiles may be read from them directly.
+ * 2. Write the per-phase totals.
+ * 3. Write the step time summary.
+ * 4. Write each of the counters.
+ * @param URL Name of the file the report will be written to.
+ */
+void Profiler::Report(std::string URL)
+{
+    if(!this->enabled || URL.empty())
+        return;
+    FILE* file = std::fopen(URL.c_str(), "w");
+    if(file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return;
+    }
+    std::vector<double> sorted = this->step_times;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double Fraction) -> double
+    {
+        if(sorted.empty())
+            return 0;
+        return sorted.at(std::min(sorted.size() - 1, (size_t)(Fraction * (sorted.size() - 1) + 0.5)));
+    };
+    double mean = 0;
+    for(double step_time : sorted)
+        mean += step_time;
+    mean = sorted.empty() ? 0 : mean / sorted.size();
+    double wall_time = std::chrono::duration<double>(Clock::now() - this->run_start).count();
+    const double fractions[] = {0.5, 0.9, 0.99, 1.0};
+    const char* fraction_names[] = {"p50", "p90", "p99", "max"};
+    bool csv = URL.size() >= 4 && URL.compare(URL.size() - 4, 4, ".csv") == 0;
+    if(csv)
+    {
+        std::fprintf(file, "section,name,calls,value\n");
+        std::fprintf(file, "run,wall_seconds,,%.6f\n", wall_time);
+        for(int i = 0; i < Phase_Count; i++)
+        {
+            std::fprintf(file, "phase,%s,%llu,%.6f\n", PhaseName((Phase)i), (unsigned long long)this->phase_calls[i],
+                         std::chrono::duration<double>(this->phase_totals[i]).count());
+        }
+        std::fprintf(file, "step_ms,mean,%zu,%.6f\n", sorted.size(), mean);
+        for(int i = 0; i < 4; i++)
+            std::fprintf(file, "step_ms,%s,%zu,%.6f\n", fraction_names[i], sorted.size(), percentile(fractions[i]));
+        for(int i = 0; i < Counter_Count; i++)
+            std::fprintf(file, "counter,%s,,%llu\n", CounterName((Counter)i), (unsigned long long)this->counters[i]);
+    }
+    else
+    {
+        std::fprintf(file, "{\n  \"wall_seconds\": %.6f,\n  \"phases\": {\n", wall_time);
+        for(int i = 0; i < Phase_Count; i++)
+        {
+            std::fprintf(file, "    \"%s\": {\"calls\": %llu, \"total_seconds\": %.6f}%s\n", PhaseName((Phase)i),
+                         (unsigned long long)this->phase_calls[i],
+                         std::chrono::duration<double>(this->phase_totals[i]).count(), i + 1 < Phase_Count ? "," : "");
+        }
+        std::fprintf(file, "  },\n  \"step_ms\": {\"steps\": %zu, \"mean\": %.6f", sorted.size(), mean);
+        for(int i = 0; i < 4; i++)
+            std::fprintf(file, ", \"%s\": %.6f", fraction_names[i], percentile(fractions[i]));
+        std::fprintf(file, "},\n  \"counters\": {\n");
+        for(int i = 0; i < Counter_Count; i++)
+        {
+            std::fprintf(file, "    \"%s\": %llu%s\n", CounterName((Counter)i), (unsigned long long)this->counters[i],
+                         i + 1 < Counter_Count ? "," : "");
+        }
+        std::fprintf(file, "  }\n}\n");
+    }
+    std::fclose(file);
+}
+
+/**
+ * Get the name of a phase as it appears within the report.
+ * @param Phase_Type The phase to name.
+ * @return Name of the phase.
+ */
+const char* Profiler::PhaseName(Phase Phase_Type)
+{
+    switch(Phase_Type)
+    {
+        case SUMO_Step: return "sumo_step";
+        case Subscription_Decode: return "subscription_decode";
+        case Governor_Step: return "governor_step";
+        case Mobility_Update: return "mobility_update";
+        case Select_Vehicles: return "select_vehicles";
+        case Packet_Processing: return "packet_processing";
+        case Run_Algorithm: return "run_algorithm";
+        default: return "unknown";
+    }
+}
+
+/**
+ * Get the name of a counter as it appears within the report.
+ * @param Counter_Type The counter to name.
+ * @return Name of the counter.
+ */
+const char* Profiler::CounterName(Counter Counter_Type)
+{
+    switch(Counter_Type)
+    {
+        case TraCI_Simulation_Step: return "traci_simulation_step";
+        case TraCI_Get_ID_List: return "traci_get_id_list";
+        case TraCI_Get_Min_Expected_Number: return "traci_get_min_expected_number";
+        case TraCI_Get_Current_Time: return "traci_get_current_time";
+        case TraCI_Subscribe: return "traci_subscribe";
+        case TraCI_Slow_Down: return "traci_slow_down";
+        case TraCI_Change_Lane: return "traci_change_lane";
+        case TraCI_Set_Lane_Change_Mode: return "traci_set_lane_change_mode";
+        case TraCI_Set_Lane_Speed_Limit: return "traci_set_lane_speed_limit";
+        case TraCI_Load: return "traci_load";
+        case Get_Sent: return "get_sent";
+        case Get_Received: return "get_received";
+        case Response_Sent: return "response_sent";
+        case Response_Received: return "response_received";
+        case Command_Sent: return "command_sent";
+        case Command_Received: return "command_received";
+        case Recommendation_Issued: return "recommendation_issued";
+        case Recommendation_Deferred: return "recommendation_deferred";
+        case Negotiation_Timers_Removed: return "negotiation_timers_removed";
+        default: return "unknown";
+    }
+}
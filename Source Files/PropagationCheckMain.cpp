@@ -0,0 +1,111 @@
+#include "../Header Files/CachedPropagationLossModel.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <ns3/core-module.h>
+#include <ns3/constant-position-mobility-model.h>
+
+using namespace ns3;
+
+namespace
+{
+    /**
+     * Place a node at random upon a road of the given length, a tenth of the nodes being placed at the same position
+     * as another so that distances within the reference distance are covered too.
+     */
+    Vector RandomPosition(std::mt19937_64& Generator, const std::vector<Ptr<MobilityModel>>& Placed, double Length)
+    {
+        std::uniform_real_distribution<double> along(0, Length);
+        std::uniform_real_distribution<double> across(-8, 8);
+        std::uniform_real_distribution<double> chance(0, 1);
+        if(!Placed.empty() && chance(Generator) < 0.1)
+        {
+            Vector near = Placed.at(Generator() % Placed.size())->GetPosition();
+            return Vector(near.x + chance(Generator) * 0.5, near.y, near.z);
+        }
+        return Vector(along(Generator), across(Generator), 0);
+    }
+}
+
+/**
+ * Check that CachedLogDistancePropagationLossModel gives the same received power as the stock
+ * ns3::LogDistancePropagationLossModel with the same parameters. Nodes are placed at random upon a road and the power
+ * received is compared for every ordered pair of nodes. Between rounds a third of the nodes are moved, which exercises
+ * the reading of positions upon a change of course. Without a tolerance every power must be bit-identical, which holds
+ * only when both were built with the same floating-point contraction, see CachedPropagationLossModel.h.
+ * Usage: CosimulationPropagationCheck [--nodes=N] [--rounds=N] [--length=M] [--seed=N] [--tolerance=dB]
+ */
+int main(int argc, char** argv)
+{
+    size_t nodes = 500;
+    int rounds = 4;
+    double length = 2000;
+    uint64_t seed = 1;
+    double tolerance = 0;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if(argument.compare(0, 8, "--nodes=") == 0)
+            nodes = std::stoul(argument.substr(8));
+        else if(argument.compare(0, 9, "--rounds=") == 0)
+            rounds = std::stoi(argument.substr(9));
+        else if(argument.compare(0, 9, "--length=") == 0)
+            length = std::stod(argument.substr(9));
+        else if(argument.compare(0, 7, "--seed=") == 0)
+            seed = std::stoull(argument.substr(7));
+        else if(argument.compare(0, 12, "--tolerance=") == 0)
+            tolerance = std::stod(argument.substr(12));
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--nodes=N] [--rounds=N] [--length=M] [--seed=N] [--tolerance=dB]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    Ptr<LogDistancePropagationLossModel> stock = CreateObject<LogDistancePropagationLossModel>();
+    Ptr<CachedLogDistancePropagationLossModel> cached = CreateObject<CachedLogDistancePropagationLossModel>();
+    std::mt19937_64 generator(seed);
+    std::vector<Ptr<MobilityModel>> mobilities;
+    for(size_t i = 0; i < nodes; i++)
+    {
+        Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(RandomPosition(generator, mobilities, length));
+        mobilities.push_back(mobility);
+    }
+    const double tx_power_dbm = 20;
+    uint64_t pairs = 0;
+    uint64_t differing = 0;
+    double worst = 0;
+    for(int round = 0; round < rounds; round++)
+    {
+        for(size_t sender = 0; sender < nodes; sender++)
+        {
+            for(size_t receiver = 0; receiver < nodes; receiver++)
+            {
+                if(sender == receiver)
+                    continue;
+                double expected = stock->CalcRxPower(tx_power_dbm, mobilities[sender], mobilities[receiver]);
+                double actual = cached->CalcRxPower(tx_power_dbm, mobilities[sender], mobilities[receiver]);
+                double difference = std::fabs(actual - expected);
+                if(std::memcmp(&expected, &actual, sizeof(double)) != 0 && difference > tolerance)
+                {
+                    if(differing == 0)
+                        std::printf("First difference in round %d from node %zu to %zu: stock %.17g, cached %.17g\n",
+                                    round, sender, receiver, expected, actual);
+                    differing++;
+                }
+                worst = std::max(worst, difference);
+                pairs++;
+            }
+        }
+        for(size_t i = 0; i < nodes; i += 3)
+            mobilities[i]->SetPosition(RandomPosition(generator, mobilities, length));
+    }
+    std::printf("%llu pairs compared, %llu differ, largest difference %.3g dB\n", (unsigned long long)pairs,
+                (unsigned long long)differing, worst);
+    return differing == 0 ? 0 : 1;
+}
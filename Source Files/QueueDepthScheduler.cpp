@@ -0,0 +1,59 @@
+#include "../Header Files/QueueDepthScheduler.h"
+
+using namespace ns3;
+
+NS_OBJECT_ENSURE_REGISTERED(QueueDepthScheduler);
+
+uint64_t QueueDepthScheduler::depth = 0;
+
+/**
+ * Get the type identifier used to select this scheduler via an ObjectFactory.
+ * @return Type identifier of this scheduler.
+ */
+TypeId QueueDepthScheduler::GetTypeId()
+{
+    static TypeId type_id = TypeId("QueueDepthScheduler")
+            .SetParent<MapScheduler>()
+            .SetGroupName("Cosimulation")
+            .AddConstructor<QueueDepthScheduler>();
+    return type_id;
+}
+
+/**
+ * Insert an event into the queue.
+ * @param Event Event to be inserted.
+ */
+void QueueDepthScheduler::Insert(const Scheduler::Event& Event)
+{
+    MapScheduler::Insert(Event);
+    depth++;
+}
+
+/**
+ * Remove the next event to be executed from the queue.
+ * @return Event that has been removed.
+ */
+Scheduler::Event QueueDepthScheduler::RemoveNext()
+{
+    depth--;
+    return MapScheduler::RemoveNext();
+}
+
+/**
+ * Remove a cancelled event from the queue.
+ * @param Event Event to be removed.
+ */
+void QueueDepthScheduler::Remove(const Scheduler::Event& Event)
+{
+    MapScheduler::Remove(Event);
+    depth--;
+}
+
+/**
+ * Get the number of events currently pending within the queue.
+ * @return Number of events currently pending within the queue.
+ */
+uint64_t QueueDepthScheduler::GetDepth()
+{
+    return depth;
+}
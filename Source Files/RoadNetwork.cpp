@@ -0,0 +1,127 @@
+#include "../Header Files/RoadNetwork.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+namespace
+{
+    /**
+     * Read the value of an attribute of the tag beginning at the given position, up to the end of that tag.
+     */
+    bool GetAttribute(const std::string& Text, size_t Tag, const std::string& Name, std::string& Value)
+    {
+        size_t end = Text.find('>', Tag);
+        std::string needle = " " + Name + "=\"";
+        size_t start = Text.find(needle, Tag);
+        if(start == std::string::npos || start > end)
+            return false;
+        start += needle.size();
+        Value = Text.substr(start, Text.find('"', start) - start);
+        return true;
+    }
+
+    /**
+     * Read the whole of a file.
+     */
+    bool ReadFile(const std::string& URL, std::string& Text)
+    {
+        std::ifstream file(URL, std::ios::binary);
+        if(!file)
+            return false;
+        Text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+/**
+ * Read the lanes of every normal edge within a SUMO network file.
+ * @param URL Name of the network file.
+ * @return True if the file was read and holds at least one lane.
+ */
+bool RoadNetwork::Read(std::string URL)
+{
+    std::string text;
+    if(!ReadFile(URL, text))
+    {
+        std::fprintf(stderr, "Unable to read the network %s.\n", URL.c_str());
+        return false;
+    }
+    this->lanes.clear();
+    this->lane_count = 0;
+    this->edge_lane_counts.clear();
+    std::string value;
+    for(size_t edge = text.find("<edge "); edge != std::string::npos; edge = text.find("<edge ", edge + 1))
+    {
+        size_t edge_end = text.find("</edge>", edge);
+        std::string edge_id;
+        if(GetAttribute(text, edge, "function", value) || !GetAttribute(text, edge, "id", edge_id))
+            continue;
+        for(size_t lane = text.find("<lane ", edge); lane < edge_end; lane = text.find("<lane ", lane + 1))
+        {
+            RoadLane road_lane;
+            road_lane.Edge_ID = edge_id;
+            GetAttribute(text, lane, "id", road_lane.ID);
+            road_lane.Index = GetAttribute(text, lane, "index", value) ? std::stoi(value) : 0;
+            road_lane.Speed = GetAttribute(text, lane, "speed", value) ? std::stod(value) : 0;
+            road_lane.Length = GetAttribute(text, lane, "length", value) ? std::stod(value) : 0;
+            this->lane_count = std::max(this->lane_count, road_lane.Index + 1);
+            int& edge_lane_count = this->edge_lane_counts[edge_id];
+            edge_lane_count = std::max(edge_lane_count, road_lane.Index + 1);
+            this->lanes.push_back(road_lane);
+        }
+    }
+    if(this->lanes.empty())
+    {
+        std::fprintf(stderr, "The network %s has no lanes.\n", URL.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Get the lanes of every normal edge within the network.
+ * @return Lanes of the network in the order they appear within the file.
+ */
+const std::vector<RoadLane>& RoadNetwork::GetLanes() const
+{
+    return this->lanes;
+}
+
+/**
+ * Get the number of lanes of the widest edge within the network.
+ * @return Number of lanes, zero if the network has not been read.
+ */
+int RoadNetwork::GetLaneCount() const
+{
+    return this->lane_count;
+}
+
+/**
+ * Get the number of lanes of each normal edge within the network.
+ * @return Number of lanes keyed by the identifier of the edge, empty if the network has not been read.
+ */
+const std::unordered_map<std::string, int>& RoadNetwork::GetEdgeLaneCounts() const
+{
+    return this->edge_lane_counts;
+}
+
+/**
+ * Find the network file named by a SUMO configuration, relative to the directory of the configuration.
+ * @param SUMO_URL Name of the SUMO configuration.
+ * @return Name of the network file, or empty if the configuration names none.
+ */
+std::string RoadNetwork::FindNetwork(std::string SUMO_URL)
+{
+    std::string text;
+    if(!ReadFile(SUMO_URL, text))
+        return "";
+    size_t tag = text.find("<net-file ");
+    std::string network;
+    if(tag == std::string::npos || !GetAttribute(text, tag, "value", network))
+        return "";
+    size_t slash = SUMO_URL.rfind('/');
+    if(network.empty() || network.at(0) == '/' || slash == std::string::npos)
+        return network;
+    return SUMO_URL.substr(0, slash + 1) + network;
+}
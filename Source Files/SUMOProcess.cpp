@@ -0,0 +1,226 @@
+#include "../Header Files/SUMOProcess.h"
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/**
+ * Terminate SUMO should it still be running.
+ */
+SUMOProcess::~SUMOProcess()
+{
+    this->Terminate();
+}
+
+/**
+ * Launch SUMO upon a free port and wait for it to begin listening. Another process may claim the port between it being
+ * allocated and SUMO binding to it, in which case SUMO exits and is launched again upon a new port.
+ * @param Binary SUMO executable.
+ * @param Arguments Arguments passed to SUMO in addition to the remote port.
+ * @param Log_URL Name of the file SUMO's output is written to.
+ * @param CPUs CPUs SUMO is pinned to, or none to leave it upon any.
+ * @return True if SUMO is listening, false if it exited or did not listen within ten seconds.
+ */
+bool SUMOProcess::Start(std::string Binary, const std::vector<std::string>& Arguments, std::string Log_URL,
+                        const std::vector<int>& CPUs)
+{
+    this->log_url = Log_URL;
+    for(int attempt = 0; attempt < 3; attempt++)
+    {
+        this->port = AllocatePort();
+        std::vector<std::string> arguments = {Binary, "--remote-port", std::to_string(this->port)};
+        arguments.insert(arguments.end(), Arguments.begin(), Arguments.end());
+        this->process_id = Spawn(arguments, Log_URL, CPUs);
+        this->exit_status = -1;
+        for(int i = 0; i < 200 && this->IsRunning(); i++)
+        {
+            if(IsListening(this->port))
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        if(this->IsRunning())
+            break;
+    }
+    this->Terminate();
+    return false;
+}
+
+/**
+ * Get the port SUMO is listening upon.
+ * @return Port SUMO is listening upon.
+ */
+int SUMOProcess::GetPort()
+{
+    return this->port;
+}
+
+/**
+ * Determine if SUMO is still running, collecting its exit status if it is not.
+ * @return True if SUMO is running.
+ */
+bool SUMOProcess::IsRunning()
+{
+    if(this->process_id == -1)
+        return false;
+    int status = 0;
+    if(waitpid(this->process_id, &status, WNOHANG) != this->process_id)
+        return true;
+    this->process_id = -1;
+    this->exit_status = status;
+    return false;
+}
+
+/**
+ * Describe how SUMO exited, for reporting once the connection to it has been lost.
+ * @return Description of the exit of SUMO, or an empty string if it is running or was never launched.
+ */
+std::string SUMOProcess::DescribeExit()
+{
+    if(this->IsRunning() || this->exit_status == -1)
+        return "";
+    if(WIFSIGNALED(this->exit_status))
+    {
+        return "SUMO was killed by signal " + std::to_string(WTERMSIG(this->exit_status)) + " (" +
+               strsignal(WTERMSIG(this->exit_status)) + "), see " + this->log_url;
+    }
+    return "SUMO exited with status " + std::to_string(WEXITSTATUS(this->exit_status)) + ", see " + this->log_url;
+}
+
+/**
+ * Wait for SUMO to exit, as it does once the TraCI connection has been closed.
+ * @return Exit status of SUMO as reported by waitpid or -1 if it was not running.
+ */
+int SUMOProcess::Wait()
+{
+    if(this->process_id == -1)
+        return -1;
+    int status = -1;
+    waitpid(this->process_id, &status, 0);
+    this->process_id = -1;
+    this->exit_status = status;
+    return status;
+}
+
+/**
+ * Terminate SUMO and wait for it to exit.
+ */
+void SUMOProcess::Terminate()
+{
+    if(this->process_id == -1)
+        return;
+    kill(this->process_id, SIGTERM);
+    this->Wait();
+}
+
+/**
+ * Launch a process with its output and error streams redirected to a log file. The process is placed within its own
+ * process group so that it is only terminated by its parent.
+ * @param Arguments Executable followed by its arguments.
+ * @param Log_URL Name of the log file.
+ * @param CPUs CPUs the process is pinned to, or none to leave it upon any.
+ * @return Process that was launched.
+ */
+pid_t SUMOProcess::Spawn(const std::vector<std::string>& Arguments, std::string Log_URL, const std::vector<int>& CPUs)
+{
+    pid_t child = fork();
+    if(child != 0)
+        return child;
+    setpgid(0, 0);
+    if(!CPUs.empty())
+        SetAffinity(CPUs, false);
+    int log = open(Log_URL.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(log != -1)
+    {
+        dup2(log, STDOUT_FILENO);
+        dup2(log, STDERR_FILENO);
+        close(log);
+    }
+    std::vector<char*> argv;
+    for(const auto& argument : Arguments)
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+    execvp(argv.front(), argv.data());
+    std::perror(argv.front());
+    _exit(127);
+}
+
+/**
+ * Pin the calling thread, and the threads it goes on to create, to the given CPUs or to every CPU it may run upon but
+ * those given. The affinity is left untouched should no CPU remain.
+ * @param CPUs CPUs to be pinned to or excluded.
+ * @param Exclude Whether the CPUs are excluded rather than pinned to.
+ * @return True if the affinity was set.
+ */
+bool SUMOProcess::SetAffinity(const std::vector<int>& CPUs, bool Exclude)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(Exclude && sched_getaffinity(0, sizeof(set), &set) != 0)
+        return false;
+    for(int cpu : CPUs)
+    {
+        if(cpu < 0 || cpu >= CPU_SETSIZE)
+            continue;
+        if(Exclude)
+            CPU_CLR(cpu, &set);
+        else
+            CPU_SET(cpu, &set);
+    }
+    return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+/**
+ * Allocate a free port by asking the kernel for one.
+ * @return A free port.
+ */
+int SUMOProcess::AllocatePort()
+{
+    int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = 0;
+    socklen_t length = sizeof(local);
+    bind(descriptor, (sockaddr*)&local, sizeof(local));
+    getsockname(descriptor, (sockaddr*)&local, &length);
+    close(descriptor);
+    return ntohs(local.sin_port);
+}
+
+/**
+ * Determine if any socket is listening upon the given TCP port by consulting the kernel's socket tables. Probing the
+ * port by connecting to it would consume the single connection SUMO accepts.
+ * @param Port Port to be checked.
+ * @return True if a socket is listening upon the port.
+ */
+bool SUMOProcess::IsListening(int Port)
+{
+    for(const char* table : {"/proc/net/tcp", "/proc/net/tcp6"})
+    {
+        std::ifstream file(table);
+        std::string line;
+        std::getline(file, line);
+        while(std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            std::string slot, local_address, remote_address, state;
+            fields >> slot >> local_address >> remote_address >> state;
+            size_t colon = local_address.rfind(':');
+            if(colon != std::string::npos && state == "0A" &&
+               std::stoi(local_address.substr(colon + 1), nullptr, 16) == Port)
+                return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace
+{
+    /**
+     * Describes the road and traffic of the scenarios to be generated.
+     */
+    struct ScenarioOptions
+    {
+        std::string Name = "scenario";
+        int Lanes = 5;
+        int Edges = 1;
+        double Length = 2000;
+        double Speed = 26.82;
+        double Period = 1;
+        std::vector<unsigned long> Vehicles = {50000, 100000, 250000, 500000};
+    };
+
+    /**
+     * Open a file for writing, reporting the failure if it cannot be.
+     */
+    FILE* OpenFile(const std::string& URL)
+    {
+        FILE* file = std::fopen(URL.c_str(), "w");
+        if(file == nullptr)
+            std::perror(URL.c_str());
+        return file;
+    }
+
+    /**
+     * Write the nodes, edges and netconvert configuration of a straight road of the given number of edges, each with
+     * the same number of lanes, that netconvert turns into the network of the scenario.
+     */
+    bool WriteNetwork(const std::string& Directory, const ScenarioOptions& Options)
+    {
+        FILE* nodes = OpenFile(Directory + "/" + Options.Name + ".nod.xml");
+        FILE* edges = OpenFile(Directory + "/" + Options.Name + ".edg.xml");
+        FILE* configuration = OpenFile(Directory + "/" + Options.Name + ".netccfg");
+        if(nodes == nullptr || edges == nullptr || configuration == nullptr)
+            return false;
+        std::fprintf(nodes, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<nodes>\n");
+        std::fprintf(edges, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<edges>\n");
+        for(int i = 0; i <= Options.Edges; i++)
+        {
+            std::fprintf(nodes, "    <node id=\"J%d\" x=\"%.2f\" y=\"0.00\" type=\"%s\"/>\n", i,
+                         Options.Length * i / Options.Edges,
+                         i == 0 || i == Options.Edges ? "dead_end" : "priority");
+            if(i < Options.Edges)
+            {
+                std::fprintf(edges, "    <edge id=\"E%d\" from=\"J%d\" to=\"J%d\" numLanes=\"%d\" speed=\"%.2f\"/>\n",
+                             i, i, i + 1, Options.Lanes, Options.Speed);
+            }
+        }
+        std::fprintf(nodes, "</nodes>\n");
+        std::fprintf(edges, "</edges>\n");
+        std::fprintf(configuration,
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<configuration>\n"
+                     "    <input>\n"
+                     "        <node-files value=\"%s.nod.xml\"/>\n"
+                     "        <edge-files value=\"%s.edg.xml\"/>\n"
+                     "    </input>\n"
+                     "    <output>\n"
+                     "        <output-file value=\"%s.net.xml\"/>\n"
+                     "    </output>\n"
+                     "    <processing>\n"
+                     "        <no-internal-links value=\"true\"/>\n"
+                     "        <no-turnarounds value=\"true\"/>\n"
+                     "        <offset.disable-normalization value=\"true\"/>\n"
+                     "    </processing>\n"
+                     "</configuration>\n", Options.Name.c_str(), Options.Name.c_str(), Options.Name.c_str());
+        bool written = std::fclose(nodes) == 0;
+        written = std::fclose(edges) == 0 && written;
+        return std::fclose(configuration) == 0 && written;
+    }
+
+    /**
+     * Stream the trips of the given number of vehicles, each departing a period after the last upon a random lane of
+     * the first edge and travelling to the end of the last, followed by the SUMO configuration that runs them.
+     */
+    bool WriteTrips(const std::string& Directory, const ScenarioOptions& Options, unsigned long Vehicles)
+    {
+        std::string name = std::to_string(Vehicles) + "v";
+        FILE* trips = OpenFile(Directory + "/" + name + "-trips.trips.xml");
+        FILE* configuration = OpenFile(Directory + "/" + name + ".sumocfg");
+        if(trips == nullptr || configuration == nullptr)
+            return false;
+        std::vector<char> buffer(1 << 20);
+        std::setvbuf(trips, buffer.data(), _IOFBF, buffer.size());
+        std::fprintf(trips, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<routes>\n");
+        for(unsigned long i = 0; i < Vehicles; i++)
+        {
+            std::fprintf(trips, "    <trip id=\"%lu\" depart=\"%.2f\" from=\"E0\" to=\"E%d\" departLane=\"random\"/>\n",
+                         i, i * Options.Period, Options.Edges - 1);
+        }
+        std::fprintf(trips, "</routes>\n");
+        std::fprintf(configuration,
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<configuration>\n"
+                     "    <input>\n"
+                     "        <net-file value=\"%s.net.xml\"/>\n"
+                     "        <route-files value=\"%s-trips.trips.xml\"/>\n"
+                     "    </input>\n"
+                     "    <processing>\n"
+                     "        <ignore-route-errors value=\"true\"/>\n"
+                     "    </processing>\n"
+                     "    <report>\n"
+                     "        <duration-log.statistics value=\"true\"/>\n"
+                     "        <no-step-log value=\"true\"/>\n"
+                     "    </report>\n"
+                     "</configuration>\n", Options.Name.c_str(), name.c_str());
+        bool written = std::fclose(trips) == 0;
+        return std::fclose(configuration) == 0 && written;
+    }
+}
+
+/**
+ * Generate large scenarios upon a straight road for stress testing. The nodes and edges of the road are written along
+ * with a netconvert configuration that produces <name>.net.xml, after which the trips and SUMO configuration of each
+ * number of vehicles are streamed to <N>v-trips.trips.xml and <N>v.sumocfg as in Resources/FiveLanes.
+ * Usage: CosimulationScenario <directory> [--name=scenario] [--lanes=5] [--edges=1] [--length=2000] [--speed=26.82]
+ *        [--period=1] [--vehicles=50000,100000,250000,500000]
+ */
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <directory> [--name=scenario] [--lanes=5] [--edges=1] [--length=2000] "
+                             "[--speed=26.82] [--period=1] [--vehicles=50000,100000,250000,500000]\n", argv[0]);
+        return 1;
+    }
+    ScenarioOptions options;
+    for(int i = 2; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        size_t equals = argument.find('=');
+        std::string option = argument.substr(0, equals);
+        std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+        if(option == "--name")
+            options.Name = value;
+        else if(option == "--lanes")
+            options.Lanes = std::stoi(value);
+        else if(option == "--edges")
+            options.Edges = std::stoi(value);
+        else if(option == "--length")
+            options.Length = std::stod(value);
+        else if(option == "--speed")
+            options.Speed = std::stod(value);
+        else if(option == "--period")
+            options.Period = std::stod(value);
+        else if(option == "--vehicles")
+        {
+            options.Vehicles.clear();
+            std::stringstream stream(value);
+            std::string vehicles;
+            while(std::getline(stream, vehicles, ','))
+                options.Vehicles.push_back(std::stoul(vehicles));
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if(options.Lanes < 1 || options.Edges < 1 || options.Length <= 0)
+    {
+        std::fprintf(stderr, "A scenario needs at least one lane, one edge and a positive length.\n");
+        return 1;
+    }
+    std::string directory = argv[1];
+    mkdir(directory.c_str(), 0755);
+    if(!WriteNetwork(directory, options))
+        return 1;
+    for(unsigned long vehicles : options.Vehicles)
+    {
+        if(!WriteTrips(directory, options, vehicles))
+            return 1;
+        std::printf("%luv written\n", vehicles);
+    }
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include "../Header Files/Sweep.h"
+#include "../Header Files/SUMOProcess.h"
+#include <thread>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+namespace
+{
+    volatile sig_atomic_t Interrupted = 0;
+
+    void Interrupt(int)
+    {
+        Interrupted = 1;
+    }
+
+    std::string Trim(const std::string& Value)
+    {
+        size_t begin = Value.find_first_not_of(" \t\r\n");
+        if(begin == std::string::npos)
+            return "";
+        size_t end = Value.find_last_not_of(" \t\r\n");
+        return Value.substr(begin, end - begin + 1);
+    }
+
+    std::string ReadFile(const std::string& URL)
+    {
+        std::ifstream file(URL);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+}
+
+/**
+ * Construct a sweep.
+ * @param Results_URL Directory the results of every run are written to.
+ * @param SUMO_Binary SUMO executable to be launched for each run.
+ * @param Cosimulation_Binary Cosimulation executable to be launched for each run.
+ * @param Jobs Number of runs that may execute at once.
+ */
+Sweep::Sweep(std::string Results_URL, std::string SUMO_Binary, std::string Cosimulation_Binary, unsigned int Jobs)
+{
+    this->results_url = Results_URL;
+    this->sumo_binary = SUMO_Binary;
+    this->cosimulation_binary = Cosimulation_Binary;
+    this->jobs = Jobs > 0 ? Jobs : 1;
+}
+
+/**
+ * Read the grid specification.
+ * @param Grid_URL Name of the grid specification.
+ * @return True if the specification could be read.
+ */
+bool Sweep::Load(std::string Grid_URL)
+{
+    std::ifstream file(Grid_URL);
+    if(!file)
+    {
+        std::perror(Grid_URL.c_str());
+        return false;
+    }
+    std::string line;
+    int line_number = 0;
+    while(std::getline(file, line))
+    {
+        line_number++;
+        line = Trim(line);
+        if(line.empty() || line.front() == '#')
+            continue;
+        size_t equals = line.find('=');
+        if(equals == std::string::npos)
+        {
+            std::fprintf(stderr, "%s:%d: expected 'name = value | value | ...'.\n", Grid_URL.c_str(), line_number);
+            return false;
+        }
+        std::vector<std::string> values;
+        std::istringstream alternatives(line.substr(equals + 1));
+        std::string value;
+        while(std::getline(alternatives, value, '|'))
+            values.push_back(Trim(value));
+        this->grid.push_back(std::make_pair(Trim(line.substr(0, equals)), values));
+    }
+    return true;
+}
+
+/**
+ * Record an event digest for every run within its directory.
+ * @param Digest Whether a digest is recorded.
+ */
+void Sweep::SetDigest(bool Digest)
+{
+    this->digest = Digest;
+}
+
+/**
+ * Expand the grid into a run for every combination of its values. The last parameter varies fastest so that the index
+ * of each run, and therefore its directory, is stable for a given specification. Runs that have already been completed
+ * with the same parameters are marked as done.
+ */
+void Sweep::Expand()
+{
+    size_t total = 1;
+    for(const auto& parameter : this->grid)
+        total *= parameter.second.size();
+    this->runs.resize(total);
+    for(size_t i = 0; i < total; i++)
+    {
+        SweepRun& run = this->runs.at(i);
+        run.Index = i;
+        size_t remainder = i;
+        run.Parameters.resize(this->grid.size());
+        for(size_t j = this->grid.size(); j-- > 0;)
+        {
+            const auto& values = this->grid.at(j).second;
+            run.Parameters.at(j) = std::make_pair(this->grid.at(j).first, values.at(remainder % values.size()));
+            remainder /= values.size();
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "/run-%06zu", i);
+        run.Directory = this->results_url + name;
+        std::string parameters;
+        for(const auto& parameter : run.Parameters)
+            parameters += parameter.first + " = " + parameter.second + "\n";
+        if(access((run.Directory + "/done").c_str(), F_OK) == 0 &&
+           ReadFile(run.Directory + "/parameters.txt") == parameters)
+            run.Status = SweepRun::Done;
+    }
+}
+
+/**
+ * Execute every run that has not yet been completed, keeping up to the given number of runs executing at once.
+ * @return Zero if every run completed successfully.
+ */
+int Sweep::Run()
+{
+    mkdir(this->results_url.c_str(), 0755);
+    this->Expand();
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = Interrupt;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    size_t next = 0;
+    size_t running = 0;
+    while(!Interrupted)
+    {
+        for(; next < this->runs.size() && running < this->jobs; next++)
+        {
+            if(this->runs.at(next).Status != SweepRun::Pending)
+                continue;
+            this->Start(this->runs.at(next));
+            if(this->runs.at(next).Status == SweepRun::Running)
+                running++;
+        }
+        if(running == 0)
+            break;
+        int status = 0;
+        pid_t process_id = waitpid(-1, &status, 0);
+        if(process_id == -1)
+            continue;
+        this->Reap(process_id, status);
+        running = 0;
+        for(const auto& run : this->runs)
+            running += run.Status == SweepRun::Running;
+    }
+    if(Interrupted)
+        this->Terminate();
+    this->WriteIndex();
+    size_t done = 0;
+    for(const auto& run : this->runs)
+        done += run.Status == SweepRun::Done;
+    std::printf("%zu of %zu runs done.\n", done, this->runs.size());
+    return Interrupted ? 130 : (done == this->runs.size() ? 0 : 1);
+}
+
+/**
+ * Start a run by launching SUMO upon a free port and, once it is listening, a Cosimulation connected to it.
+ * @param Run The run to be started.
+ */
+void Sweep::Start(SweepRun& Run)
+{
+    mkdir(Run.Directory.c_str(), 0755);
+    unlink((Run.Directory + "/done").c_str());
+    std::ofstream parameters(Run.Directory + "/parameters.txt");
+    for(const auto& parameter : Run.Parameters)
+        parameters << parameter.first << " = " << parameter.second << "\n";
+    parameters.close();
+    Run.Port = this->AllocatePort();
+    std::vector<std::string> sumo_arguments = {this->sumo_binary, "-c", this->GetParameter(Run, "sumo-url"),
+                                               "--remote-port", std::to_string(Run.Port)};
+    if(!this->GetParameter(Run, "step-length").empty())
+    {
+        sumo_arguments.push_back("--step-length");
+        sumo_arguments.push_back(this->GetParameter(Run, "step-length"));
+    }
+    Run.SUMO_PID = SUMOProcess::Spawn(sumo_arguments, Run.Directory + "/sumo.log");
+    if(!this->WaitForListener(Run.SUMO_PID, Run.Port))
+    {
+        std::fprintf(stderr, "run-%06zu: SUMO did not start, see %s/sumo.log\n", Run.Index, Run.Directory.c_str());
+        if(Run.SUMO_PID != -1)
+        {
+            kill(Run.SUMO_PID, SIGKILL);
+            waitpid(Run.SUMO_PID, nullptr, 0);
+        }
+        Run.SUMO_PID = -1;
+        Run.Status = SweepRun::Failed;
+        this->ports.erase(Run.Port);
+        return;
+    }
+    std::vector<std::string> cosimulation_arguments = {this->cosimulation_binary};
+    for(const auto& parameter : Run.Parameters)
+        cosimulation_arguments.push_back("--" + parameter.first + "=" + parameter.second);
+    cosimulation_arguments.push_back("--remote-port=" + std::to_string(Run.Port));
+    cosimulation_arguments.push_back("--lane-change-output=" + Run.Directory + "/lane-change.xml");
+    cosimulation_arguments.push_back("--trip-info-output=" + Run.Directory + "/trip-info.xml");
+    if(this->digest)
+        cosimulation_arguments.push_back("--digest=" + Run.Directory + "/digest.txt");
+    Run.Cosimulation_PID = SUMOProcess::Spawn(cosimulation_arguments, Run.Directory + "/cosimulation.log");
+    Run.Status = SweepRun::Running;
+}
+
+/**
+ * Handle the exit of a process belonging to a run. Should either process of a pair fail the other is terminated.
+ * @param Process_ID Process that has exited.
+ * @param Status Exit status of the process as reported by waitpid.
+ */
+void Sweep::Reap(pid_t Process_ID, int Status)
+{
+    for(auto& run : this->runs)
+    {
+        if(run.Status != SweepRun::Running)
+            continue;
+        bool failed = !WIFEXITED(Status) || WEXITSTATUS(Status) != 0;
+        if(run.Cosimulation_PID == Process_ID)
+        {
+            run.Cosimulation_PID = -1;
+            run.Cosimulation_Status = Status;
+            if(failed && run.SUMO_PID != -1)
+                kill(run.SUMO_PID, SIGTERM);
+        }
+        else if(run.SUMO_PID == Process_ID)
+        {
+            run.SUMO_PID = -1;
+            if(failed && run.Cosimulation_PID != -1)
+                kill(run.Cosimulation_PID, SIGTERM);
+        }
+        else
+            continue;
+        if(run.SUMO_PID == -1 && run.Cosimulation_PID == -1)
+            this->Complete(run);
+        return;
+    }
+}
+
+/**
+ * Record the outcome of a run once both of its processes have exited.
+ * @param Run The run that has finished.
+ */
+void Sweep::Complete(SweepRun& Run)
+{
+    this->ports.erase(Run.Port);
+    if(WIFEXITED(Run.Cosimulation_Status) && WEXITSTATUS(Run.Cosimulation_Status) == 0)
+    {
+        Run.Status = SweepRun::Done;
+        std::ofstream(Run.Directory + "/done");
+    }
+    else
+        Run.Status = SweepRun::Failed;
+    std::printf("run-%06zu %s\n", Run.Index, Run.Status == SweepRun::Done ? "done" : "failed");
+    std::fflush(stdout);
+    this->WriteIndex();
+}
+
+/**
+ * Terminate every run that is executing. Such runs are left pending so that they are started again upon resumption.
+ */
+void Sweep::Terminate()
+{
+    for(auto& run : this->runs)
+    {
+        if(run.Status != SweepRun::Running)
+            continue;
+        for(pid_t process_id : {run.SUMO_PID, run.Cosimulation_PID})
+        {
+            if(process_id == -1)
+                continue;
+            kill(process_id, SIGTERM);
+            waitpid(process_id, nullptr, 0);
+        }
+        run.SUMO_PID = -1;
+        run.Cosimulation_PID = -1;
+        run.Status = SweepRun::Pending;
+    }
+}
+
+/**
+ * Write the index of every run, its status and parameters to index.csv within the results directory. The index is
+ * written to a temporary file and renamed so that it is always complete.
+ */
+void Sweep::WriteIndex()
+{
+    const char* names[] = {"pending", "running", "done", "failed"};
+    std::string url = this->results_url + "/index.csv";
+    std::ofstream index(url + ".tmp");
+    index << "run,status";
+    for(const auto& parameter : this->grid)
+        index << "," << parameter.first;
+    index << "\n";
+    for(const auto& run : this->runs)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "run-%06zu", run.Index);
+        index << name << "," << names[run.Status];
+        for(const auto& parameter : run.Parameters)
+        {
+            if(parameter.second.find_first_of(",\"") == std::string::npos)
+                index << "," << parameter.second;
+            else
+            {
+                std::string value = parameter.second;
+                for(size_t i = value.find('"'); i != std::string::npos; i = value.find('"', i + 2))
+                    value.insert(i, "\"");
+                index << ",\"" << value << "\"";
+            }
+        }
+        index << "\n";
+    }
+    index.close();
+    std::rename((url + ".tmp").c_str(), url.c_str());
+}
+
+/**
+ * Get the value of a parameter for the given run.
+ * @param Run The run whose parameter is required.
+ * @param Name Name of the parameter.
+ * @return Value of the parameter or empty if it is not part of the grid.
+ */
+std::string Sweep::GetParameter(const SweepRun& Run, std::string Name)
+{
+    for(const auto& parameter : Run.Parameters)
+    {
+        if(parameter.first == Name)
+            return parameter.second;
+    }
+    return "";
+}
+
+/**
+ * Allocate a free port by asking the kernel for one. Ports handed to runs that are still executing are never reused.
+ * @return A free port.
+ */
+int Sweep::AllocatePort()
+{
+    while(true)
+    {
+        int port = SUMOProcess::AllocatePort();
+        if(port != 0 && this->ports.insert(port).second)
+            return port;
+    }
+}
+
+/**
+ * Wait for SUMO to begin listening upon its port.
+ * @param Process_ID SUMO process.
+ * @param Port Port SUMO was asked to listen upon.
+ * @return True if SUMO is listening, false if it exited or did not listen within ten seconds.
+ */
+bool Sweep::WaitForListener(pid_t Process_ID, int Port)
+{
+    for(int i = 0; i < 200; i++)
+    {
+        if(SUMOProcess::IsListening(Port))
+            return true;
+        if(waitpid(Process_ID, nullptr, WNOHANG) == Process_ID)
+        {
+            for(auto& run : this->runs)
+            {
+                if(run.SUMO_PID == Process_ID)
+                    run.SUMO_PID = -1;
+            }
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
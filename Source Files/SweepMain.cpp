@@ -0,0 +1,48 @@
+#include "../Header Files/Sweep.h"
+#include <thread>
+#include <cstdio>
+#include <string>
+
+/**
+ * Execute every combination of a grid specification, see Sweep for its format. By default one run is executed per core
+ * and the Cosimulation executable is expected alongside this one. With --digest each run records an event digest.
+ * Usage: CosimulationSweep <grid> <results directory> [--jobs=N] [--sumo=sumo] [--cosimulation=Cosimulation]
+ *        [--digest]
+ */
+int main(int argc, char** argv)
+{
+    if(argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <grid> <results directory> [--jobs=N] [--sumo=sumo] "
+                             "[--cosimulation=Cosimulation] [--digest]\n", argv[0]);
+        return 1;
+    }
+    std::string program = argv[0];
+    size_t slash = program.rfind('/');
+    std::string cosimulation = (slash == std::string::npos ? "." : program.substr(0, slash)) + "/Cosimulation";
+    std::string sumo = "sumo";
+    unsigned int jobs = std::thread::hardware_concurrency();
+    bool digest = false;
+    for(int i = 3; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if(argument.compare(0, 7, "--jobs=") == 0)
+            jobs = (unsigned int)std::stoul(argument.substr(7));
+        else if(argument.compare(0, 7, "--sumo=") == 0)
+            sumo = argument.substr(7);
+        else if(argument.compare(0, 15, "--cosimulation=") == 0)
+            cosimulation = argument.substr(15);
+        else if(argument == "--digest")
+            digest = true;
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    Sweep sweep(argv[2], sumo, cosimulation, jobs);
+    sweep.SetDigest(digest);
+    if(!sweep.Load(argv[1]))
+        return 1;
+    return sweep.Run();
+}
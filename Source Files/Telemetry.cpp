@@ -0,0 +1,247 @@
+#include "../Header Files/Telemetry.h"
+#include <new>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    /**
+     * Determine if a segment of that name was left behind by a simulation that is no longer running, in which case it
+     * may be replaced. A segment not yet holding a TelemetryBlock is taken to be in use, as its creator may be filling
+     * it in.
+     */
+    bool IsStale(const std::string& Name)
+    {
+        int descriptor = shm_open(Name.c_str(), O_RDONLY, 0);
+        if(descriptor == -1)
+            return errno == ENOENT;
+        struct stat status;
+        void* memory = MAP_FAILED;
+        if(fstat(descriptor, &status) == 0 && (size_t)status.st_size >= sizeof(TelemetryBlock))
+            memory = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, descriptor, 0);
+        close(descriptor);
+        if(memory == MAP_FAILED)
+            return false;
+        const TelemetryBlock* block = (const TelemetryBlock*)memory;
+        bool stale = block->Magic.load(std::memory_order_acquire) == TelemetryBlock::Magic_Number &&
+                     kill((pid_t)block->Process_ID.load(), 0) == -1 && errno == ESRCH;
+        munmap(memory, sizeof(TelemetryBlock));
+        return stale;
+    }
+}
+
+/**
+ * Release the shared memory segment. The segment is removed once the simulation that created it has finished.
+ */
+Telemetry::~Telemetry()
+{
+    if(this->block != nullptr)
+    {
+        munmap(this->block, sizeof(TelemetryBlock));
+        if(this->owner)
+            shm_unlink(this->name.c_str());
+    }
+}
+
+/**
+ * Create the shared memory segment that statistics will be published to. A segment of the same name is only replaced
+ * if the simulation that created it is no longer running, so that two simulations never publish to the same segment.
+ * @param Name Name of the segment. A leading '/' will be added if missing.
+ * @return True if the segment could be created.
+ */
+bool Telemetry::Create(std::string Name)
+{
+    this->name = SegmentName(Name);
+    int descriptor = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(descriptor == -1 && errno == EEXIST && IsStale(this->name))
+    {
+        shm_unlink(this->name.c_str());
+        descriptor = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if(descriptor == -1)
+    {
+        if(errno == EEXIST)
+            std::fprintf(stderr, "%s is in use by another simulation.\n", this->name.c_str());
+        else
+            std::perror(this->name.c_str());
+        return false;
+    }
+    if(ftruncate(descriptor, sizeof(TelemetryBlock)) == -1)
+    {
+        std::perror(this->name.c_str());
+        close(descriptor);
+        return false;
+    }
+    void* memory = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(memory == MAP_FAILED)
+    {
+        std::perror(this->name.c_str());
+        return false;
+    }
+    this->block = new(memory) TelemetryBlock();
+    this->owner = true;
+    this->block->Finished.store(0);
+    this->block->Sequence.store(0);
+    this->block->Process_ID.store(getpid());
+    this->block->Steps.store(0);
+    this->block->Simulated_Time.store(0);
+    this->block->Steps_Per_Second.store(0);
+    this->block->Active_Vehicles.store(0);
+    this->block->Pending_Negotiations.store(0);
+    this->block->Queue_Depth.store(0);
+    this->block->Resident_Set_Bytes.store(GetResidentSetSize());
+    this->block->Magic.store(TelemetryBlock::Magic_Number, std::memory_order_release);
+    this->window_start = std::chrono::steady_clock::now();
+    return true;
+}
+
+/**
+ * Attach to a segment created by a running simulation in order to read from it.
+ * @param Name Name of the segment. A leading '/' will be added if missing.
+ * @return True if the segment exists and holds a TelemetryBlock.
+ */
+bool Telemetry::Attach(std::string Name)
+{
+    this->name = SegmentName(Name);
+    int descriptor = shm_open(this->name.c_str(), O_RDWR, 0);
+    if(descriptor == -1)
+        return false;
+    struct stat status;
+    if(fstat(descriptor, &status) == -1 || (size_t)status.st_size < sizeof(TelemetryBlock))
+    {
+        close(descriptor);
+        return false;
+    }
+    void* memory = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(memory == MAP_FAILED)
+        return false;
+    if(((TelemetryBlock*)memory)->Magic.load(std::memory_order_acquire) != TelemetryBlock::Magic_Number)
+    {
+        munmap(memory, sizeof(TelemetryBlock));
+        return false;
+    }
+    this->block = (TelemetryBlock*)memory;
+    this->owner = false;
+    return true;
+}
+
+/**
+ * Determine if a segment is currently mapped.
+ * @return True if a segment is currently mapped.
+ */
+bool Telemetry::IsOpen()
+{
+    return this->block != nullptr;
+}
+
+/**
+ * Publish the statistics for the step that has just been taken.
+ * 1. Mark the block as being written by making the sequence odd.
+ * 2. Store the values supplied by the simulation.
+ * 3. If a wall second has passed, refresh the step rate and resident set size.
+ * 4. Mark the block as consistent by making the sequence even again.
+ * @param Simulated_Time Current simulation time in seconds.
+ * @param Active_Vehicles Number of vehicles currently within SUMO.
+ * @param Pending_Negotiations Number of vehicles still trying to reach their target lane.
+ * @param Queue_Depth Number of events pending within the NS-3 scheduler.
+ */
+void Telemetry::Publish(double Simulated_Time, uint64_t Active_Vehicles, uint64_t Pending_Negotiations,
+                        uint64_t Queue_Depth)
+{
+    if(this->block == nullptr)
+        return;
+    uint64_t sequence = this->block->Sequence.load(std::memory_order_relaxed);
+    this->block->Sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->block->Steps.store(this->block->Steps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    this->block->Simulated_Time.store(Simulated_Time, std::memory_order_relaxed);
+    this->block->Active_Vehicles.store(Active_Vehicles, std::memory_order_relaxed);
+    this->block->Pending_Negotiations.store(Pending_Negotiations, std::memory_order_relaxed);
+    this->block->Queue_Depth.store(Queue_Depth, std::memory_order_relaxed);
+    this->window_steps++;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - this->window_start).count();
+    if(elapsed >= 1.0)
+    {
+        this->block->Steps_Per_Second.store(this->window_steps / elapsed, std::memory_order_relaxed);
+        this->block->Resident_Set_Bytes.store(GetResidentSetSize(), std::memory_order_relaxed);
+        this->window_start = now;
+        this->window_steps = 0;
+    }
+    this->block->Sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * Mark the simulation as finished so that any attached monitor may stop.
+ */
+void Telemetry::Finish()
+{
+    if(this->block != nullptr)
+        this->block->Finished.store(1, std::memory_order_release);
+}
+
+/**
+ * Take a consistent snapshot of the published statistics. Retry whenever the writer was part way through an update.
+ * @param Snapshot Container the statistics are copied into.
+ * @return True if a snapshot could be taken.
+ */
+bool Telemetry::Read(TelemetrySnapshot& Snapshot)
+{
+    if(this->block == nullptr)
+        return false;
+    for(int attempt = 0; attempt < 1000; attempt++)
+    {
+        uint64_t before = this->block->Sequence.load(std::memory_order_acquire);
+        if(before % 2 != 0)
+            continue;
+        Snapshot.Finished = this->block->Finished.load(std::memory_order_relaxed) != 0;
+        Snapshot.Process_ID = this->block->Process_ID.load(std::memory_order_relaxed);
+        Snapshot.Steps = this->block->Steps.load(std::memory_order_relaxed);
+        Snapshot.Simulated_Time = this->block->Simulated_Time.load(std::memory_order_relaxed);
+        Snapshot.Steps_Per_Second = this->block->Steps_Per_Second.load(std::memory_order_relaxed);
+        Snapshot.Active_Vehicles = this->block->Active_Vehicles.load(std::memory_order_relaxed);
+        Snapshot.Pending_Negotiations = this->block->Pending_Negotiations.load(std::memory_order_relaxed);
+        Snapshot.Queue_Depth = this->block->Queue_Depth.load(std::memory_order_relaxed);
+        Snapshot.Resident_Set_Bytes = this->block->Resident_Set_Bytes.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(this->block->Sequence.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Get the name of a shared memory segment as expected by shm_open.
+ * @param Name Name of the segment.
+ * @return Name of the segment beginning with '/'.
+ */
+std::string Telemetry::SegmentName(std::string Name)
+{
+    if(Name.empty() || Name.at(0) != '/')
+        Name.insert(0, "/");
+    return Name;
+}
+
+/**
+ * Get the resident set size of the calling process.
+ * @return Resident set size in bytes or zero if it could not be read.
+ */
+uint64_t Telemetry::GetResidentSetSize()
+{
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if(file == nullptr)
+        return 0;
+    if(std::fscanf(file, "%llu %llu", &size, &resident) != 2)
+        resident = 0;
+    std::fclose(file);
+    return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
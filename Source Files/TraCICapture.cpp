@@ -0,0 +1,254 @@
+#include "../Header Files/TraCICapture.h"
+#include <cstring>
+#include <netdb.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace
+{
+    const char Capture_Magic[8] = {'C', 'O', 'S', 'I', 'T', 'R', 'C', 'I'};
+
+    bool ReadExact(int Socket, uint8_t* Buffer, size_t Size)
+    {
+        while(Size > 0)
+        {
+            ssize_t received = recv(Socket, Buffer, Size, 0);
+            if(received <= 0)
+                return false;
+            Buffer += received;
+            Size -= (size_t)received;
+        }
+        return true;
+    }
+}
+
+/**
+ * Wait for the relay to finish and release the sockets and the capture file.
+ */
+TraCICapture::~TraCICapture()
+{
+    if(this->relay.joinable())
+        this->relay.join();
+    if(this->listener != -1)
+        close(this->listener);
+    if(this->client_side != -1)
+        close(this->client_side);
+    if(this->sumo_side != -1)
+        close(this->sumo_side);
+    if(this->file != nullptr)
+        std::fclose(this->file);
+}
+
+/**
+ * Connect to SUMO and begin relaying messages from a local port to it.
+ * @param URL Name of the capture file.
+ * @param Address Address of the TraCI server.
+ * @param Port Port of the TraCI server.
+ * @return Local port the TraCIClient should connect to.
+ */
+int TraCICapture::Start(std::string URL, std::string Address, int Port)
+{
+    this->file = std::fopen(URL.c_str(), "wb");
+    if(this->file == nullptr)
+        throw std::runtime_error("Unable to create TraCI capture " + URL);
+    std::fwrite(Capture_Magic, 1, sizeof(Capture_Magic), this->file);
+    this->sumo_side = Connect(Address, Port);
+    this->listener = Listen(0);
+    sockaddr_in local;
+    socklen_t length = sizeof(local);
+    getsockname(this->listener, (sockaddr*)&local, &length);
+    this->start = std::chrono::steady_clock::now();
+    this->relay = std::thread(&TraCICapture::Relay, this);
+    return ntohs(local.sin_port);
+}
+
+/**
+ * Relay messages between the TraCIClient and SUMO until either side closes its connection. TraCI is strictly request
+ * and response therefore a single thread alternating between the two sides is sufficient.
+ */
+void TraCICapture::Relay()
+{
+    this->client_side = accept(this->listener, nullptr, nullptr);
+    if(this->client_side == -1)
+        return;
+    int enable = 1;
+    setsockopt(this->client_side, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    std::vector<uint8_t> message;
+    while(ReadMessage(this->client_side, message))
+    {
+        this->Write(Request, message);
+        if(!WriteMessage(this->sumo_side, message) || !ReadMessage(this->sumo_side, message))
+            break;
+        this->Write(Reply, message);
+        if(!WriteMessage(this->client_side, message))
+            break;
+    }
+    std::fflush(this->file);
+    shutdown(this->client_side, SHUT_RDWR);
+}
+
+/**
+ * Append a message to the capture file.
+ * @param Direction Whether the message was a request or a reply.
+ * @param Message The message including its length prefix.
+ */
+void TraCICapture::Write(uint8_t Direction, const std::vector<uint8_t>& Message)
+{
+    int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - this->start).count();
+    uint32_t size = (uint32_t)Message.size();
+    std::fwrite(&Direction, sizeof(Direction), 1, this->file);
+    std::fwrite(&timestamp, sizeof(timestamp), 1, this->file);
+    std::fwrite(&size, sizeof(size), 1, this->file);
+    std::fwrite(Message.data(), 1, Message.size(), this->file);
+}
+
+/**
+ * Open a TCP connection with Nagle's algorithm disabled.
+ * @param Address Address to connect to. Loopback is used if empty.
+ * @param Port Port to connect to.
+ * @return Connected socket.
+ */
+int TraCICapture::Connect(std::string Address, int Port)
+{
+    addrinfo hints;
+    addrinfo* result = nullptr;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if(getaddrinfo(Address.empty() ? "127.0.0.1" : Address.c_str(), std::to_string(Port).c_str(),
+                   &hints, &result) != 0)
+        throw std::runtime_error("Unable to resolve " + Address);
+    int descriptor = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if(descriptor == -1 || connect(descriptor, result->ai_addr, result->ai_addrlen) == -1)
+    {
+        freeaddrinfo(result);
+        if(descriptor != -1)
+            close(descriptor);
+        throw std::runtime_error("Unable to connect to " + Address + ":" + std::to_string(Port));
+    }
+    freeaddrinfo(result);
+    int enable = 1;
+    setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    return descriptor;
+}
+
+/**
+ * Listen for a single connection upon the loopback interface.
+ * @param Port Port to listen upon or zero for any free port.
+ * @return Listening socket.
+ */
+int TraCICapture::Listen(int Port)
+{
+    int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+    if(descriptor == -1)
+        throw std::runtime_error("Unable to listen upon port " + std::to_string(Port));
+    int enable = 1;
+    setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = htons((uint16_t)Port);
+    if(bind(descriptor, (sockaddr*)&local, sizeof(local)) == -1 || listen(descriptor, 1) == -1)
+    {
+        close(descriptor);
+        throw std::runtime_error("Unable to listen upon port " + std::to_string(Port));
+    }
+    return descriptor;
+}
+
+/**
+ * Read a complete TraCI message. Each message begins with its total length as a four byte big endian integer.
+ * @param Socket Socket to read from.
+ * @param Message Container the message, including its length prefix, is read into.
+ * @return True if a complete message was read.
+ */
+bool TraCICapture::ReadMessage(int Socket, std::vector<uint8_t>& Message)
+{
+    uint8_t prefix[4];
+    if(!ReadExact(Socket, prefix, sizeof(prefix)))
+        return false;
+    uint32_t length = ((uint32_t)prefix[0] << 24) | ((uint32_t)prefix[1] << 16) |
+                      ((uint32_t)prefix[2] << 8) | (uint32_t)prefix[3];
+    if(length < sizeof(prefix))
+        return false;
+    Message.resize(length);
+    std::memcpy(Message.data(), prefix, sizeof(prefix));
+    return ReadExact(Socket, Message.data() + sizeof(prefix), length - sizeof(prefix));
+}
+
+/**
+ * Write a complete TraCI message.
+ * @param Socket Socket to write to.
+ * @param Message The message including its length prefix.
+ * @return True if the message was written.
+ */
+bool TraCICapture::WriteMessage(int Socket, const std::vector<uint8_t>& Message)
+{
+    size_t sent = 0;
+    while(sent < Message.size())
+    {
+        ssize_t result = send(Socket, Message.data() + sent, Message.size() - sent, MSG_NOSIGNAL);
+        if(result <= 0)
+            return false;
+        sent += (size_t)result;
+    }
+    return true;
+}
+
+/**
+ * Read and validate the header of a capture file.
+ * @param File Capture file positioned at its start.
+ * @return True if the file is a capture.
+ */
+bool TraCICapture::ReadHeader(FILE* File)
+{
+    char magic[sizeof(Capture_Magic)];
+    return std::fread(magic, 1, sizeof(magic), File) == sizeof(magic) &&
+           std::memcmp(magic, Capture_Magic, sizeof(magic)) == 0;
+}
+
+/**
+ * Read the next record from a capture file.
+ * @param File Capture file.
+ * @param Record Container the record is read into.
+ * @return True if a complete record was read.
+ */
+bool TraCICapture::ReadRecord(FILE* File, TraCIRecord& Record)
+{
+    uint32_t size = 0;
+    if(std::fread(&Record.Direction, sizeof(Record.Direction), 1, File) != 1 ||
+       std::fread(&Record.Timestamp_NS, sizeof(Record.Timestamp_NS), 1, File) != 1 ||
+       std::fread(&size, sizeof(size), 1, File) != 1)
+        return false;
+    Record.Message.resize(size);
+    return std::fread(Record.Message.data(), 1, size, File) == size;
+}
+
+/**
+ * Get the identifier of the first command within a message. Commands begin with a single byte length, or a zero
+ * followed by a four byte length, before their identifier. Get, set and subscription commands are followed by the
+ * variable they refer to.
+ * @param Message The message including its length prefix.
+ * @param Variable Assigned the variable the command refers to or -1 if it has none.
+ * @return Identifier of the first command or -1 if the message holds none.
+ */
+int TraCICapture::GetCommandID(const std::vector<uint8_t>& Message, int& Variable)
+{
+    Variable = -1;
+    size_t position = 4;
+    if(Message.size() <= position + 1)
+        return -1;
+    position += Message.at(position) == 0 ? 5 : 1;
+    if(Message.size() <= position)
+        return -1;
+    int command = Message.at(position);
+    if(command >= 0xa0 && command <= 0xdf && Message.size() > position + 1)
+        Variable = Message.at(position + 1);
+    return command;
+}
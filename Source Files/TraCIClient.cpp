@@ -1,4 +1,5 @@
 #include "../Header Files/TraCIClient.h"
+#include "../Header Files/Profiler.h"
 
 /**
  * Specify a new lane change mode for a given vehicle within the SUMO simulation.
@@ -8,9 +9,16 @@
  */
 void TraCIClient::SetLaneChangeMode(std::string Vehicle_ID, int Mode)
 {
+    if(this->detached)
+    {
+        if(this->forwarding)
+            this->forwarded_commands.push_back({TraCICommand::Set_Lane_Change_Mode, Vehicle_ID, Mode, 0, 0});
+        return;
+    }
     tcpip::Storage storage;
     storage.writeUnsignedByte(TYPE_INTEGER);
     storage.writeInt(Mode);
+    Profiler::Instance().Increment(Profiler::TraCI_Set_Lane_Change_Mode);
     this->send_commandSetValue(CMD_SET_VEHICLE_VARIABLE, VAR_LANECHANGE_MODE, Vehicle_ID, storage);
     tcpip::Storage message;
     this->check_resultState(message, CMD_SET_VEHICLE_VARIABLE);
@@ -25,6 +33,12 @@ void TraCIClient::SetLaneChangeMode(std::string Vehicle_ID, int Mode)
  */
 void TraCIClient::ChangeLane(std::string Vehicle_ID, int Lane_Index, SUMOTime Duration)
 {
+    if(this->detached)
+    {
+        if(this->forwarding)
+            this->forwarded_commands.push_back({TraCICommand::Change_Lane, Vehicle_ID, Lane_Index, 0, Duration});
+        return;
+    }
     tcpip::Storage storage;
     storage.writeUnsignedByte(TYPE_COMPOUND);
     storage.writeInt(2);
@@ -32,6 +46,7 @@ void TraCIClient::ChangeLane(std::string Vehicle_ID, int Lane_Index, SUMOTime Du
     storage.writeByte(Lane_Index);
     storage.writeUnsignedByte(TYPE_INTEGER);
     storage.writeInt((int)Duration);
+    Profiler::Instance().Increment(Profiler::TraCI_Change_Lane);
     this->send_commandSetValue(CMD_SET_VEHICLE_VARIABLE, CMD_CHANGELANE, Vehicle_ID, storage);
     tcpip::Storage message;
     this->check_resultState(message, CMD_SET_VEHICLE_VARIABLE);
@@ -44,10 +59,232 @@ void TraCIClient::ChangeLane(std::string Vehicle_ID, int Lane_Index, SUMOTime Du
  */
 void TraCIClient::ChangeLaneSpeedLimit(std::string Lane_ID, double New_Speed)
 {
+    if(this->detached)
+    {
+        if(this->forwarding)
+            this->forwarded_commands.push_back({TraCICommand::Change_Lane_Speed_Limit, Lane_ID, 0, New_Speed, 0});
+        return;
+    }
     tcpip::Storage storage;
     storage.writeUnsignedByte(TYPE_DOUBLE);
     storage.writeDouble(New_Speed);
+    Profiler::Instance().Increment(Profiler::TraCI_Set_Lane_Speed_Limit);
     this->send_commandSetValue(CMD_SET_LANE_VARIABLE, VAR_MAXSPEED, Lane_ID, storage);
     tcpip::Storage message;
     this->check_resultState(message, CMD_SET_LANE_VARIABLE);
 }
+
+/**
+ * Instruct the vehicle to change its speed to the given value over the given duration.
+ * @param Vehicle_ID Unique identifier of the vehicle to slow down.
+ * @param Speed The speed the vehicle should reach.
+ * @param Duration The number of milliseconds over which the vehicle should reach the speed.
+ */
+void TraCIClient::SlowDown(std::string Vehicle_ID, double Speed, int Duration)
+{
+    if(this->detached)
+    {
+        if(this->forwarding)
+            this->forwarded_commands.push_back({TraCICommand::Slow_Down, Vehicle_ID, 0, Speed, Duration});
+        return;
+    }
+    Profiler::Instance().Increment(Profiler::TraCI_Slow_Down);
+    this->vehicle.slowDown(Vehicle_ID, Speed, Duration);
+}
+
+/**
+ * Subscribe to the given variables of a vehicle for the current time step. Results can then be obtained from
+ * getSubscriptionResults.
+ * @param Vehicle_ID Unique identifier of the vehicle to subscribe to.
+ * @param Variables The variables that should be reported.
+ */
+void TraCIClient::Subscribe(std::string Vehicle_ID, const std::vector<int>& Variables)
+{
+    if(this->detached)
+        return;
+    SUMOTime current_time = this->GetCurrentTime();
+    Profiler::Instance().Increment(Profiler::TraCI_Subscribe);
+    this->simulation.subscribe(CMD_SUBSCRIBE_VEHICLE_VARIABLE, Vehicle_ID, current_time, current_time + 1, Variables);
+}
+
+/**
+ * Get the unique identifiers of all vehicles currently within the SUMO simulation.
+ * @return Unique identifiers of all vehicles currently within the SUMO simulation.
+ */
+std::vector<std::string> TraCIClient::GetVehicleIDList()
+{
+    if(this->detached)
+        return this->detached_vehicle_ids;
+    Profiler::Instance().Increment(Profiler::TraCI_Get_ID_List);
+    return this->vehicle.getIDList();
+}
+
+/**
+ * Get the number of vehicles that are within the SUMO simulation or are still waiting to enter it.
+ * @return Number of vehicles that are within the SUMO simulation or are still waiting to enter it.
+ */
+int TraCIClient::GetMinExpectedNumber()
+{
+    if(this->detached)
+        return this->detached_expected_number;
+    Profiler::Instance().Increment(Profiler::TraCI_Get_Min_Expected_Number);
+    return this->simulation.getMinExpectedNumber();
+}
+
+/**
+ * Get the current time of the SUMO simulation.
+ * @return Current time of the SUMO simulation in milliseconds.
+ */
+SUMOTime TraCIClient::GetCurrentTime()
+{
+    Profiler::Instance().Increment(Profiler::TraCI_Get_Current_Time);
+    return this->simulation.getCurrentTime();
+}
+
+/**
+ * Connect to SUMO. If a capture file is given the connection is made through a TraCICapture relay which records every
+ * request and response exchanged with SUMO.
+ * @param Address Address of the TraCI server.
+ * @param Port Port of the TraCI server.
+ * @param Capture_URL Name of the capture file or empty if the session should not be captured.
+ */
+void TraCIClient::Connect(std::string Address, int Port, std::string Capture_URL)
+{
+    if(Capture_URL.empty())
+    {
+        this->connect(Address, Port);
+        return;
+    }
+    this->capture.reset(new TraCICapture());
+    int relay_port = this->capture->Start(Capture_URL, Address, Port);
+    this->connect("127.0.0.1", relay_port);
+}
+
+/**
+ * Advance the SUMO simulation by a single step.
+ */
+void TraCIClient::Step()
+{
+    if(this->detached)
+        return;
+    Profiler::Scope scope(Profiler::SUMO_Step);
+    Profiler::Instance().Increment(Profiler::TraCI_Simulation_Step);
+    this->simulationStep();
+}
+
+/**
+ * Reload the SUMO simulation with the given arguments.
+ * @param Arguments Command line arguments SUMO should be reloaded with.
+ */
+void TraCIClient::Load(const std::vector<std::string>& Arguments)
+{
+    if(this->detached)
+        return;
+    Profiler::Instance().Increment(Profiler::TraCI_Load);
+    this->load(Arguments);
+}
+
+/**
+ * Instruct SUMO to save the state of its simulation so that a new instance may be started from it with --load-state.
+ * Older TraCI headers do not define the command, in which case it is defined within TraCIClient.h.
+ * @param URL Name of the state file. This is interpreted by SUMO and so should be an absolute path.
+ * http://sumo.dlr.de/wiki/TraCI/Change_Simulation_State#save_state_.280x95.29
+ */
+void TraCIClient::SaveState(std::string URL)
+{
+    if(this->detached)
+        return;
+    tcpip::Storage storage;
+    storage.writeUnsignedByte(TYPE_STRING);
+    storage.writeString(URL);
+    this->send_commandSetValue(CMD_SET_SIM_VARIABLE, CMD_SAVE_SIMSTATE, "", storage);
+    tcpip::Storage message;
+    this->check_resultState(message, CMD_SET_SIM_VARIABLE);
+}
+
+/**
+ * Close the connection to SUMO, informing it that the simulation has finished. Any capture is completed once the relay
+ * has seen the connection close.
+ */
+void TraCIClient::Close()
+{
+    if(!this->detached)
+        this->close();
+    this->capture.reset();
+}
+
+/**
+ * Detach the client from SUMO. From this point forward the client will answer queries from the state supplied via
+ * SetDetachedState and all commands will be discarded.
+ */
+void TraCIClient::Detach()
+{
+    this->detached = true;
+}
+
+/**
+ * Determine if this client has been detached from SUMO.
+ * @return True if this client has been detached from SUMO.
+ */
+bool TraCIClient::IsDetached()
+{
+    return this->detached;
+}
+
+/**
+ * Supply the state that queries made to a detached client are answered with.
+ * @param Vehicle_IDs Unique identifiers of the vehicles that are present.
+ * @param Expected_Number Number of vehicles that are present or are still expected to be.
+ */
+void TraCIClient::SetDetachedState(const std::vector<std::string>& Vehicle_IDs, int Expected_Number)
+{
+    this->detached_vehicle_ids = Vehicle_IDs;
+    this->detached_expected_number = Expected_Number;
+}
+
+
+/**
+ * Hold the commands issued to this client while it is detached so that they may be forwarded to SUMO by another client,
+ * rather than discarding them.
+ * @param Forwarding Whether commands should be held.
+ */
+void TraCIClient::SetForwarding(bool Forwarding)
+{
+    this->forwarding = Forwarding;
+}
+
+/**
+ * Take the commands that have been held since they were last taken.
+ * @return Commands in the order they were issued.
+ */
+std::vector<TraCICommand> TraCIClient::TakeForwardedCommands()
+{
+    std::vector<TraCICommand> commands;
+    commands.swap(this->forwarded_commands);
+    return commands;
+}
+
+/**
+ * Execute a command that was forwarded from another client.
+ * @param Command The command to be executed.
+ */
+void TraCIClient::Execute(const TraCICommand& Command)
+{
+    switch(Command.Command_Type)
+    {
+        case TraCICommand::Set_Lane_Change_Mode:
+            this->SetLaneChangeMode(Command.ID, Command.Integer);
+            break;
+        case TraCICommand::Change_Lane:
+            this->ChangeLane(Command.ID, Command.Integer, Command.Duration);
+            break;
+        case TraCICommand::Change_Lane_Speed_Limit:
+            this->ChangeLaneSpeedLimit(Command.ID, Command.Real);
+            break;
+        case TraCICommand::Slow_Down:
+            this->SlowDown(Command.ID, Command.Real, (int)Command.Duration);
+            break;
+        default:
+            break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "../Header Files/TraCICapture.h"
+#include <map>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <utility>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace
+{
+    const int Bucket_Count = 32;
+
+    /**
+     * Histogram of the latency observed for a single command, in power of two buckets of microseconds.
+     */
+    struct LatencyHistogram
+    {
+        uint64_t Count = 0;
+        double Total_US = 0;
+        double Max_US = 0;
+        uint64_t Buckets[Bucket_Count] = {};
+    };
+
+    const char* GetCommandName(int Command)
+    {
+        switch(Command)
+        {
+            case 0x00: return "getVersion";
+            case 0x01: return "load";
+            case 0x02: return "simulationStep";
+            case 0x7f: return "close";
+            case 0xa3: return "getLaneVariable";
+            case 0xa4: return "getVehicleVariable";
+            case 0xab: return "getSimulationVariable";
+            case 0xc3: return "setLaneVariable";
+            case 0xc4: return "setVehicleVariable";
+            case 0xd4: return "subscribeVehicleVariable";
+            default: return "unknown";
+        }
+    }
+
+    double GetPercentile(const LatencyHistogram& Histogram, double Percentile)
+    {
+        uint64_t target = (uint64_t)(Percentile * Histogram.Count);
+        uint64_t seen = 0;
+        for(int i = 0; i < Bucket_Count; i++)
+        {
+            seen += Histogram.Buckets[i];
+            if(seen > target)
+                return std::min((double)(1ull << i), Histogram.Max_US);
+        }
+        return Histogram.Max_US;
+    }
+
+    /**
+     * Print the latency of every command within the capture, measured from the request being relayed to SUMO until the
+     * response was received. Percentiles are reported as the upper bound of the bucket they fall within.
+     */
+    int ReportLatency(FILE* Capture)
+    {
+        std::map<std::pair<int, int>, LatencyHistogram> histograms;
+        TraCIRecord record;
+        TraCIRecord request;
+        bool awaiting_reply = false;
+        while(TraCICapture::ReadRecord(Capture, record))
+        {
+            if(record.Direction == TraCICapture::Request)
+            {
+                request = record;
+                awaiting_reply = true;
+                continue;
+            }
+            if(!awaiting_reply)
+                continue;
+            awaiting_reply = false;
+            int variable = -1;
+            int command = TraCICapture::GetCommandID(request.Message, variable);
+            LatencyHistogram& histogram = histograms[std::make_pair(command, variable)];
+            double latency = (record.Timestamp_NS - request.Timestamp_NS) / 1000.0;
+            int bucket = 0;
+            while(bucket < Bucket_Count - 1 && (double)(1ull << bucket) < latency)
+                bucket++;
+            histogram.Count++;
+            histogram.Total_US += latency;
+            histogram.Max_US = std::max(histogram.Max_US, latency);
+            histogram.Buckets[bucket]++;
+        }
+        std::printf("%-26s %8s %10s %12s %12s %12s %12s\n", "Command", "Variable", "Count", "Mean (us)",
+                    "P50 (us)", "P99 (us)", "Max (us)");
+        for(const auto& entry : histograms)
+        {
+            const LatencyHistogram& histogram = entry.second;
+            char variable[8] = "-";
+            if(entry.first.second != -1)
+                std::snprintf(variable, sizeof(variable), "0x%02x", entry.first.second);
+            std::printf("%-26s %8s %10llu %12.1f %12.0f %12.0f %12.1f\n", GetCommandName(entry.first.first), variable,
+                        (unsigned long long)histogram.Count, histogram.Total_US / histogram.Count,
+                        GetPercentile(histogram, 0.5), GetPercentile(histogram, 0.99), histogram.Max_US);
+        }
+        return 0;
+    }
+
+    /**
+     * Report the first point at which the request of the client differs from the request that was recorded.
+     */
+    void ReportDivergence(uint64_t Index, const std::vector<uint8_t>& Expected, const std::vector<uint8_t>& Received)
+    {
+        size_t offset = 0;
+        while(offset < Expected.size() && offset < Received.size() && Expected.at(offset) == Received.at(offset))
+            offset++;
+        int expected_variable = -1;
+        int received_variable = -1;
+        int expected_command = TraCICapture::GetCommandID(Expected, expected_variable);
+        int received_command = TraCICapture::GetCommandID(Received, received_variable);
+        std::fprintf(stderr, "Divergence at request %llu, byte %zu.\n", (unsigned long long)Index, offset);
+        std::fprintf(stderr, "  Expected %s (0x%02x/%d) of %zu bytes.\n", GetCommandName(expected_command),
+                     expected_command, expected_variable, Expected.size());
+        std::fprintf(stderr, "  Received %s (0x%02x/%d) of %zu bytes.\n", GetCommandName(received_command),
+                     received_command, received_variable, Received.size());
+    }
+}
+
+/**
+ * Serve a capture produced with --traci-capture in place of SUMO. Each request received from the client is compared
+ * against the recorded request and, if identical, answered with the recorded response. With --pace the recorded latency
+ * of SUMO is reproduced, otherwise responses are returned immediately. With --latency the per-command latency
+ * histograms of the capture are printed and no server is started.
+ * Usage: CosimulationTraCIReplay <capture> <port> [--pace]
+ *        CosimulationTraCIReplay <capture> --latency
+ */
+int main(int argc, char** argv)
+{
+    if(argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <capture> <port> [--pace]\n       %s <capture> --latency\n", argv[0], argv[0]);
+        return 1;
+    }
+    FILE* capture = std::fopen(argv[1], "rb");
+    if(capture == nullptr || !TraCICapture::ReadHeader(capture))
+    {
+        std::fprintf(stderr, "%s is not a TraCI capture.\n", argv[1]);
+        return 1;
+    }
+    if(std::strcmp(argv[2], "--latency") == 0)
+        return ReportLatency(capture);
+    bool pace = argc > 3 && std::strcmp(argv[3], "--pace") == 0;
+    int listener = TraCICapture::Listen(std::stoi(argv[2]));
+    int client = accept(listener, nullptr, nullptr);
+    close(listener);
+    if(client == -1)
+    {
+        std::perror("accept");
+        return 1;
+    }
+    TraCIRecord record;
+    TraCIRecord request;
+    std::vector<uint8_t> message;
+    uint64_t index = 0;
+    int status = 0;
+    while(TraCICapture::ReadRecord(capture, record))
+    {
+        if(record.Direction == TraCICapture::Request)
+        {
+            request = record;
+            if(!TraCICapture::ReadMessage(client, message))
+            {
+                std::fprintf(stderr, "Client disconnected before request %llu.\n", (unsigned long long)index);
+                status = 1;
+                break;
+            }
+            if(message != record.Message)
+            {
+                ReportDivergence(index, record.Message, message);
+                status = 2;
+                break;
+            }
+            index++;
+            continue;
+        }
+        if(pace)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(record.Timestamp_NS - request.Timestamp_NS));
+        if(!TraCICapture::WriteMessage(client, record.Message))
+        {
+            status = 1;
+            break;
+        }
+    }
+    if(status == 0 && TraCICapture::ReadMessage(client, message))
+    {
+        std::fprintf(stderr, "Divergence at request %llu, the capture has been exhausted.\n",
+                     (unsigned long long)index);
+        status = 2;
+    }
+    if(status == 0)
+        std::printf("Replayed %llu requests without divergence.\n", (unsigned long long)index);
+    close(client);
+    std::fclose(capture);
+    return status;
+}
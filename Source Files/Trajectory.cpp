@@ -0,0 +1,289 @@
+#include "../Header Files/Trajectory.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    const char Trajectory_Magic[8] = {'C', 'O', 'S', 'I', 'T', 'R', 'A', 'J'};
+    const uint32_t Trajectory_Version = 1;
+    const size_t Release_Interval = 64 * 1024 * 1024;
+
+    size_t Padding(size_t Size)
+    {
+        return (8 - Size % 8) % 8;
+    }
+}
+
+/**
+ * Ensure the trajectory has been completed before it is destroyed.
+ */
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    this->Close();
+}
+
+/**
+ * Create the trajectory file and write a placeholder header that is completed when the recorder is closed.
+ * @param URL Name of the trajectory file.
+ * @param Step_Length The interval of time between each step in seconds.
+ * @return True if the file could be created.
+ */
+bool TrajectoryRecorder::Open(std::string URL, double Step_Length)
+{
+    this->file = std::fopen(URL.c_str(), "wb");
+    if(this->file == nullptr)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    std::setvbuf(this->file, nullptr, _IOFBF, 1 << 20);
+    std::memset(&this->header, 0, sizeof(TrajectoryHeader));
+    std::memcpy(this->header.Magic, Trajectory_Magic, sizeof(Trajectory_Magic));
+    this->header.Version = Trajectory_Version;
+    this->header.Step_Length = Step_Length;
+    this->offset = 0;
+    this->Write(&this->header, sizeof(TrajectoryHeader));
+    return true;
+}
+
+/**
+ * Begin collecting the state of the vehicles for a new step.
+ * @param Time Simulation time of the step in seconds.
+ */
+void TrajectoryRecorder::BeginStep(double Time)
+{
+    this->step_time = Time;
+    this->vehicle_index_column.clear();
+    this->x_column.clear();
+    this->y_column.clear();
+    this->speed_column.clear();
+    this->lane_column.clear();
+}
+
+/**
+ * Add the state of a vehicle to the current step. Vehicles are assigned an index the first time they are seen at which
+ * point their static attributes are stored within the vehicle table.
+ * @param Vehicle_ID Unique identifier of the vehicle.
+ * @param Attributes Attributes of the vehicle during this step.
+ */
+void TrajectoryRecorder::Add(const std::string& Vehicle_ID, const VehicleAttributes& Attributes)
+{
+    if(this->file == nullptr)
+        return;
+    auto iterator = this->vehicle_indices.find(Vehicle_ID);
+    if(iterator == this->vehicle_indices.end())
+    {
+        TrajectoryVehicle vehicle;
+        vehicle.ID_Offset = (uint32_t)this->vehicle_ids.size();
+        vehicle.ID_Length = (uint32_t)Vehicle_ID.size();
+        vehicle.Length = (float)Attributes.Length;
+        vehicle.Max_Speed = (float)Attributes.Max_Speed;
+        vehicle.Acceleration = (float)Attributes.Acceleration;
+        vehicle.Deceleration = (float)Attributes.Deceleration;
+        vehicle.Max_Legal_Speed = (float)Attributes.Max_Legal_Speed;
+        vehicle.Reserved = 0;
+        this->vehicle_ids.append(Vehicle_ID);
+        this->vehicles.push_back(vehicle);
+        iterator = this->vehicle_indices.insert(std::make_pair(Vehicle_ID, (uint32_t)this->vehicles.size() - 1)).first;
+    }
+    this->vehicle_index_column.push_back(iterator->second);
+    this->x_column.push_back((float)Attributes.Position.x);
+    this->y_column.push_back((float)Attributes.Position.y);
+    this->speed_column.push_back((float)Attributes.Speed);
+    this->lane_column.push_back((int8_t)Attributes.Lane_Index);
+}
+
+/**
+ * Append the collected step to the file as a block of columns.
+ */
+void TrajectoryRecorder::EndStep()
+{
+    if(this->file == nullptr)
+        return;
+    TrajectoryStepHeader step_header;
+    step_header.Time = this->step_time;
+    step_header.Count = (uint32_t)this->vehicle_index_column.size();
+    step_header.Reserved = 0;
+    this->step_offsets.push_back(this->offset);
+    this->Write(&step_header, sizeof(TrajectoryStepHeader));
+    this->Write(this->vehicle_index_column.data(), this->vehicle_index_column.size() * sizeof(uint32_t));
+    this->Write(this->x_column.data(), this->x_column.size() * sizeof(float));
+    this->Write(this->y_column.data(), this->y_column.size() * sizeof(float));
+    this->Write(this->speed_column.data(), this->speed_column.size() * sizeof(float));
+    this->Write(this->lane_column.data(), this->lane_column.size());
+    const uint64_t padding = 0;
+    this->Write(&padding, Padding(this->lane_column.size()));
+}
+
+/**
+ * Complete the trajectory by writing the vehicle and step tables and then rewriting the header to refer to them.
+ */
+void TrajectoryRecorder::Close()
+{
+    if(this->file == nullptr)
+        return;
+    const uint64_t padding = 0;
+    this->header.Vehicle_Count = (uint32_t)this->vehicles.size();
+    this->header.Step_Count = this->step_offsets.size();
+    this->header.Vehicle_Table_Offset = this->offset;
+    this->Write(this->vehicles.data(), this->vehicles.size() * sizeof(TrajectoryVehicle));
+    this->Write(this->vehicle_ids.data(), this->vehicle_ids.size());
+    this->Write(&padding, Padding(this->vehicle_ids.size()));
+    this->header.Step_Table_Offset = this->offset;
+    this->Write(this->step_offsets.data(), this->step_offsets.size() * sizeof(uint64_t));
+    std::fseek(this->file, 0, SEEK_SET);
+    std::fwrite(&this->header, sizeof(TrajectoryHeader), 1, this->file);
+    std::fclose(this->file);
+    this->file = nullptr;
+}
+
+/**
+ * Write data to the end of the trajectory file.
+ * @param Data Data to be written.
+ * @param Size Number of bytes to be written.
+ */
+void TrajectoryRecorder::Write(const void* Data, size_t Size)
+{
+    if(Size > 0)
+        std::fwrite(Data, 1, Size, this->file);
+    this->offset += Size;
+}
+
+/**
+ * Unmap the trajectory file.
+ */
+TrajectoryReader::~TrajectoryReader()
+{
+    if(this->data != nullptr)
+        munmap((void*)this->data, this->size);
+}
+
+/**
+ * Map a trajectory file so that it may be replayed.
+ * @param URL Name of the trajectory file.
+ * @return True if the file could be mapped and is a complete trajectory.
+ */
+bool TrajectoryReader::Open(std::string URL)
+{
+    int descriptor = open(URL.c_str(), O_RDONLY);
+    if(descriptor == -1)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) == -1 || (size_t)status.st_size < sizeof(TrajectoryHeader))
+    {
+        close(descriptor);
+        return false;
+    }
+    this->size = (size_t)status.st_size;
+    void* memory = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if(memory == MAP_FAILED)
+    {
+        std::perror(URL.c_str());
+        return false;
+    }
+    madvise(memory, this->size, MADV_SEQUENTIAL);
+    this->data = (const uint8_t*)memory;
+    this->header = (const TrajectoryHeader*)this->data;
+    if(std::memcmp(this->header->Magic, Trajectory_Magic, sizeof(Trajectory_Magic)) != 0 ||
+       this->header->Version != Trajectory_Version || this->header->Step_Table_Offset == 0 ||
+       this->header->Step_Table_Offset + this->header->Step_Count * sizeof(uint64_t) > this->size)
+    {
+        std::fprintf(stderr, "%s is not a complete trajectory.\n", URL.c_str());
+        return false;
+    }
+    this->vehicles = (const TrajectoryVehicle*)(this->data + this->header->Vehicle_Table_Offset);
+    this->vehicle_ids = (const char*)(this->vehicles + this->header->Vehicle_Count);
+    this->position = sizeof(TrajectoryHeader);
+    this->released = 0;
+    this->step = 0;
+    return true;
+}
+
+/**
+ * Get the interval of time between each step of the recorded simulation.
+ * @return Interval of time between each step in seconds.
+ */
+double TrajectoryReader::GetStepLength()
+{
+    return this->header->Step_Length;
+}
+
+/**
+ * Get the number of vehicles that appear within the trajectory.
+ * @return Number of vehicles that appear within the trajectory.
+ */
+uint32_t TrajectoryReader::GetVehicleCount()
+{
+    return this->header->Vehicle_Count;
+}
+
+/**
+ * Get the unique identifier of a vehicle within the trajectory.
+ * @param Index Index of the vehicle within the trajectory.
+ * @return Unique identifier of the vehicle.
+ */
+std::string TrajectoryReader::GetVehicleID(uint32_t Index)
+{
+    const TrajectoryVehicle& vehicle = this->vehicles[Index];
+    return std::string(this->vehicle_ids + vehicle.ID_Offset, vehicle.ID_Length);
+}
+
+/**
+ * Assign the static attributes recorded for a vehicle.
+ * @param Index Index of the vehicle within the trajectory.
+ * @param Attributes Attributes to be assigned.
+ */
+void TrajectoryReader::GetStaticAttributes(uint32_t Index, VehicleAttributes& Attributes)
+{
+    const TrajectoryVehicle& vehicle = this->vehicles[Index];
+    Attributes.Length = vehicle.Length;
+    Attributes.Max_Speed = vehicle.Max_Speed;
+    Attributes.Acceleration = vehicle.Acceleration;
+    Attributes.Deceleration = vehicle.Deceleration;
+    Attributes.Max_Legal_Speed = vehicle.Max_Legal_Speed;
+}
+
+/**
+ * Read the next step of the trajectory. Pages lying well behind the current position are released from memory.
+ * @param Step View of the step that is assigned on success.
+ * @return True if a step was read, false once the trajectory has been exhausted.
+ */
+bool TrajectoryReader::Next(TrajectoryStep& Step)
+{
+    if(!this->HasNext())
+        return false;
+    const TrajectoryStepHeader* step_header = (const TrajectoryStepHeader*)(this->data + this->position);
+    const uint8_t* columns = this->data + this->position + sizeof(TrajectoryStepHeader);
+    Step.Time = step_header->Time;
+    Step.Count = step_header->Count;
+    Step.Vehicle_Index = (const uint32_t*)columns;
+    Step.X = (const float*)(columns + Step.Count * sizeof(uint32_t));
+    Step.Y = Step.X + Step.Count;
+    Step.Speed = Step.Y + Step.Count;
+    Step.Lane_Index = (const int8_t*)(Step.Speed + Step.Count);
+    this->position += sizeof(TrajectoryStepHeader) + Step.Count * (sizeof(uint32_t) + 3 * sizeof(float)) +
+                      Step.Count + Padding(Step.Count);
+    this->step++;
+    if(this->position - this->released > 2 * Release_Interval)
+    {
+        madvise((void*)(this->data + this->released), Release_Interval, MADV_DONTNEED);
+        this->released += Release_Interval;
+    }
+    return true;
+}
+
+/**
+ * Determine if there are any steps left to be read.
+ * @return True if there are steps left to be read.
+ */
+bool TrajectoryReader::HasNext()
+{
+    return this->data != nullptr && this->step < this->header->Step_Count;
+}
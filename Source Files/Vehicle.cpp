@@ -3,6 +3,9 @@
 #include <ns3/ipv4.h>
 #include <ns3/core-module.h>
 #include <ns3/waypoint-mobility-model.h>
+#include "../Header Files/Metrics.h"
+#include "../Header Files/Profiler.h"
+#include "../Header Files/EventDigest.h"
 #include "../Header Files/VehicleApplication.h"
 
 using namespace ns3;
@@ -24,76 +27,212 @@ Vehicle::Vehicle(Ptr<Node> Vehicle_Node, NetDeviceContainer Vehicle_Devices,
 }
 
 /**
- * Update the vehicle at the current step within the simulation. Collect and assign attributes and make any required
- * decisions before progressing into the next time step.
+ * Subscribe to the attributes of this vehicle for the current step, collecting the results for Decode. The static
+ * attributes are only subscribed to the first time, as the vehicle departs. If the client has been detached from SUMO
+ * the attributes are expected to have already been assigned by the caller.
+ * @param Client TraCIClient that enable communication to SUMO.
+ * @param Step_Variables Variables subscribed to every step.
+ * @param Departure_Variables Variables subscribed to as the vehicle departs, including the static variables.
+ * @param Results Container the results of the subscription are written to.
+ */
+void Vehicle::Subscribe(std::shared_ptr<TraCIClient> Client, const std::vector<int>& Step_Variables,
+                        const std::vector<int>& Departure_Variables, TraCIAPI::TraCIValues& Results)
+{
+    if(Client->IsDetached())
+        return;
+    Client->Subscribe(this->GetID(), this->departed ? Step_Variables : Departure_Variables);
+    Results = Client->simulation.getSubscriptionResults(this->GetID());
+    this->departed = true;
+}
+
+/**
+ * Assign the attributes of this vehicle, and the road it is upon if subscribed to, from the results of its
+ * subscription. This touches nothing but the vehicle itself and so may be carried out for many vehicles concurrently.
+ * @param Results Results of the subscription.
+ */
+void Vehicle::Decode(const TraCIAPI::TraCIValues& Results)
+{
+    this->GetAttributes()->Update(Results);
+    auto road = Results.find(VAR_ROAD_ID);
+    if(road != Results.end())
+        this->road_id = road->second.string;
+}
+
+/**
+ * Update the vehicle at the current step within the simulation using the attributes assigned by Decode and make any
+ * required decisions before progressing into the next time step. Only the owner of a vehicle asks its application to
+ * change lane and only visible vehicles are moved, see Partition.
  * @param Client TraCIClient that enable communication to SUMO.
  */
 void Vehicle::Step(std::shared_ptr<TraCIClient> Client)
 {
-    Client->simulation.subscribe(CMD_SUBSCRIBE_VEHICLE_VARIABLE, this->GetID(),
-                                 Client->simulation.getCurrentTime(), Client->simulation.getCurrentTime() + 1,
-                                 this->GetAttributes()->Attribute_Names);
-    this->GetAttributes()->Update(Client->simulation.getSubscriptionResults(this->GetID()));
-    Ptr<WaypointMobilityModel> mobility = this->GetNode()->GetObject<WaypointMobilityModel>();
-    Vector position = Vector(this->GetAttributes()->Position.x, this->GetAttributes()->Position.y, 0);
-    mobility->AddWaypoint(Waypoint(Simulator::Now(), position));
+    this->Apply(this->Plan(), Client);
+}
+
+/**
+ * Determine what the vehicle must do this step with regards to its target. This touches nothing but the vehicle itself
+ * and so may be carried out for many vehicles concurrently, with the result later handed to Apply.
+ * @return Action the vehicle must carry out.
+ */
+Vehicle::StepAction Vehicle::Plan()
+{
     int current_lane = this->GetAttributes()->Lane_Index;
-    if(this->HasTarget())
+    if(!this->HasTarget())
+        return Step_None;
+    // Vehicle has a target currently set. Lets ensure that we haven't already reached it.
+    if(this->target_lane == current_lane)
+        return Step_Reached;
+    // We are still moving towards are target lane. Lets send a request to change lane if we haven't already.
+    return this->previous_lane != current_lane ? Step_Request : Step_None;
+}
+
+/**
+ * Carry out the action determined by Plan, moving the node of the vehicle and calling upon its application. Must be
+ * called from the simulator thread.
+ * @param Action Action the vehicle must carry out.
+ * @param Client TraCIClient that enable communication to SUMO.
+ * @param Move Whether the node is moved to the position of the vehicle, which it always is upon departure.
+ */
+void Vehicle::Apply(StepAction Action, std::shared_ptr<TraCIClient> Client, bool Move)
+{
+    bool departing = this->depart_time.IsNegative();
+    if(departing)
+        this->depart_time = Simulator::Now();
+    if(this->visible && (Move || departing))
     {
-        // Vehicle has a target currently set. Lets ensure that we haven't already reached it.
-        if(this->target_lane != current_lane)
+        Profiler::Scope scope(Profiler::Mobility_Update);
+        Ptr<WaypointMobilityModel> mobility = this->GetNode()->GetObject<WaypointMobilityModel>();
+        Vector position = Vector(this->GetAttributes()->Position.x, this->GetAttributes()->Position.y, 0);
+        mobility->AddWaypoint(Waypoint(Simulator::Now(), position));
+        // Reach the waypoint now rather than when the position is next read, so that the change of course is reported
+        // to the propagation loss model before anything is transmitted.
+        mobility->GetPosition();
+    }
+    int current_lane = this->GetAttributes()->Lane_Index;
+    if(this->observed_lane != -1 && this->observed_lane != current_lane)
+    {
+        EventDigest::Instance().Record(EventDigest::Lane_Change, Simulator::Now().GetMicroSeconds(), this->GetID(),
+                                       this->observed_lane, current_lane);
+    }
+    this->observed_lane = current_lane;
+    if(Action == Step_Request)
+    {
+        // Only the owner of the vehicle makes the request, other processes simply keep track of it.
+        if(this->owned)
         {
-            // We are still moving towards are target lane. Lets send a request to change lane if we haven't already.
-            if(this->previous_lane != current_lane)
+            // A new request supersedes any verification or retry still pending from the last.
+            this->RemoveNegotiationTimer();
+            this->negotiation_state = Negotiation_Requested;
+            // Need to determine if the target lane is above or below the current lane.
+            if(this->target_lane > current_lane)
             {
-                Ptr<VehicleApplication> vehicle_application =
-                        this->GetNode()->GetApplication(0)->GetObject<VehicleApplication>();
-                // Need to determine if the target lane is above or below the current lane.
-                if(this->target_lane > current_lane)
-                {
-                    vehicle_application->ChangeLane(current_lane + 1);
-                }
-                else
-                {
-                    vehicle_application->ChangeLane(current_lane - 1);
-                }
-                this->previous_lane = current_lane; // Set previous lane so we don't call upon the application again.
+                this->application->ChangeLane(current_lane + 1);
+            }
+            else
+            {
+                this->application->ChangeLane(current_lane - 1);
             }
         }
-        else
-        {
-            this->SetTarget(-1); // We have reached our target so lets reset and wait for another target from Governor.
-        }
+        this->previous_lane = current_lane; // Set previous lane so we don't call upon the application again.
+    }
+    else if(Action == Step_Reached)
+    {
+        Metrics::Instance().Increment(Metrics::Negotiations_Completed);
+        Metrics::Instance().Add(Metrics::Completion_Time_S, (Simulator::Now() - this->negotiation_start).GetSeconds());
+        Metrics::Instance().Add(Metrics::Negotiation_Retries, this->retries);
+        this->RemoveNegotiationTimer();
+        this->negotiation_state = Negotiation_Done;
+        this->SetTarget(-1); // We have reached our target so lets reset and wait for another target from Governor.
     }
 }
 
+/**
+ * Ask the application to change lane again should the vehicle not have reached the lane it was recommended to change
+ * to. Only called if the negotiation has not been completed since the recommendation.
+ * @param Lane_Index Index of the lane the vehicle was recommended to change to.
+ */
 void Vehicle::VerifyLaneChange(int Lane_Index)
 {
-    Ptr<VehicleApplication> vehicle_application =
-            this->GetNode()->GetApplication(0)->GetObject<VehicleApplication>();
     if(this->GetAttributes()->Lane_Index != Lane_Index)
-        vehicle_application->ChangeLane(Lane_Index);
+        this->RetryLaneChange(Lane_Index);
 }
 
+/**
+ * Ask the application to change lane again after a recommendation was deferred or did not take effect.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ */
+void Vehicle::RetryLaneChange(int Lane_Index)
+{
+    this->retries++;
+    Metrics::Instance().Increment(Metrics::Retries);
+    this->negotiation_state = Negotiation_Requested;
+    this->application->ChangeLane(Lane_Index);
+}
+
+/**
+ * Remove the timer of the negotiation from the event queue, if one is pending.
+ */
+void Vehicle::RemoveNegotiationTimer()
+{
+    if(!this->negotiation_timer.IsExpired())
+    {
+        Simulator::Remove(this->negotiation_timer);
+        Profiler::Instance().Increment(Profiler::Negotiation_Timers_Removed);
+    }
+}
+
+/**
+ * Act upon the recommendation of the application. An accepted recommendation is passed onto SUMO and verified ten
+ * seconds later, while a deferred one is retried ten seconds later. Recommendations arriving once the negotiation is
+ * done, the target having been reached or the vehicle having left SUMO, are ignored.
+ * @param Recommendation True if the vehicle should change lane now.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ * @param Client TraCIClient that enable communication to SUMO.
+ */
 void Vehicle::RecommendLaneChange(bool Recommendation, int Lane_Index, std::shared_ptr<TraCIClient> Client)
 {
-    std::vector<std::string> id_list = Client->vehicle.getIDList();
-    if(std::find(id_list.begin(), id_list.end(), this->GetID()) != id_list.end())
+    if(this->negotiation_state == Negotiation_Done || this->arrived)
+        return;
+    Profiler::Instance().Increment(Recommendation ? Profiler::Recommendation_Issued
+                                                  : Profiler::Recommendation_Deferred);
+    Metrics::Instance().Increment(Recommendation ? Metrics::Recommendations_Accepted
+                                                 : Metrics::Recommendations_Deferred);
+    EventDigest::Instance().Record(EventDigest::Recommendation, Simulator::Now().GetMicroSeconds(), this->GetID(),
+                                   Recommendation, Lane_Index);
+    if(!this->request_start.IsNegative())
     {
-        if(Recommendation)
-        {
-            Client->ChangeLane(this->GetID(), Lane_Index, 0);
-            Simulator::Schedule(Seconds(10), &Vehicle::VerifyLaneChange, this, Lane_Index);
-        }
-        else
-        {
-            Ptr<VehicleApplication> vehicle_application =
-                    this->GetNode()->GetApplication(0)->GetObject<VehicleApplication>();
-            Simulator::Schedule(Seconds(10), &VehicleApplication::ChangeLane, vehicle_application, Lane_Index);
-        }
+        Metrics::Instance().Add(Metrics::Recommendation_Latency_MS,
+                                (Simulator::Now() - this->request_start).GetSeconds() * 1000);
+        this->request_start = Time(-1);
+    }
+    this->RemoveNegotiationTimer();
+    if(Recommendation)
+    {
+        Client->ChangeLane(this->GetID(), Lane_Index, 0);
+        this->negotiation_state = Negotiation_Recommended;
+        this->negotiation_timer = Simulator::Schedule(Seconds(10), &Vehicle::VerifyLaneChange, this, Lane_Index);
+    }
+    else
+    {
+        this->negotiation_state = Negotiation_Deferred;
+        this->negotiation_timer = Simulator::Schedule(Seconds(10), &Vehicle::RetryLaneChange, this, Lane_Index);
     }
 }
 
+/**
+ * Recommend the lane change after a delay, such as once a partner has been asked to make room, unless the negotiation
+ * is done by then.
+ * @param Delay Length of time until the recommendation is made.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ * @param Client TraCIClient that enable communication to SUMO.
+ */
+void Vehicle::DeferLaneChange(Time Delay, int Lane_Index, std::shared_ptr<TraCIClient> Client)
+{
+    this->RemoveNegotiationTimer();
+    this->negotiation_state = Negotiation_Deferred;
+    this->negotiation_timer = Simulator::Schedule(Delay, &Vehicle::RecommendLaneChange, this, true, Lane_Index, Client);
+}
+
 /**
  * Get the network node associated with this vehicle.
  * @return Network node associated with this vehicle.
@@ -130,6 +269,34 @@ std::string Vehicle::GetID()
     return this->vehicle_id;
 }
 
+/**
+ * Get the road the vehicle was upon during the last step, which is only known when subscribed to, see Governor.
+ * @return Identifier of the edge or internal lane the vehicle is upon, empty if unknown.
+ */
+const std::string& Vehicle::GetRoadID()
+{
+    return this->road_id;
+}
+
+/**
+ * Get the number of lanes of the edge the vehicle is upon as resolved by the first process of a distributed simulation,
+ * the only process to know the road of each vehicle, see Distributor.
+ * @return Number of lanes, -1 if not resolved by another process.
+ */
+int Vehicle::GetLaneCount()
+{
+    return this->lane_count;
+}
+
+/**
+ * Set the number of lanes of the edge the vehicle is upon as resolved by the first process of a distributed simulation.
+ * @param Lane_Count Number of lanes, zero should the vehicle be within a junction.
+ */
+void Vehicle::SetLaneCount(int Lane_Count)
+{
+    this->lane_count = Lane_Count;
+}
+
 /**
  * Get the IP address assigned to the network devices attached to this vehicle.
  * 1.  Obtain the IPV4 address assigned to the network node on board this vehicle.
@@ -157,6 +324,12 @@ std::string Vehicle::GetIPAddress()
 
 void Vehicle::SetTarget(int Target_Lane)
 {
+    if(Target_Lane != -1 && Target_Lane != this->target_lane)
+    {
+        this->negotiation_start = Simulator::Now();
+        this->retries = 0;
+        Metrics::Instance().Increment(Metrics::Negotiations_Started);
+    }
     this->target_lane = Target_Lane;
 }
 
@@ -165,6 +338,120 @@ bool Vehicle::HasTarget()
     return this->target_lane != -1;
 }
 
+/**
+ * Note that the application has requested information on behalf of this vehicle, from which the latency of the next
+ * recommendation is measured.
+ */
+void Vehicle::BeginRequest()
+{
+    this->request_start = Simulator::Now();
+    this->negotiation_state = Negotiation_Collecting;
+}
+
+/**
+ * Get the state of the negotiation of this vehicle.
+ * @return State of the negotiation, done if there is none under way.
+ */
+Vehicle::NegotiationState Vehicle::GetNegotiationState()
+{
+    return this->negotiation_state;
+}
+
+/**
+ * Note that the vehicle has left SUMO, recording its travel time and abandoning any negotiation under way. Only the
+ * first call after the vehicle has departed has any effect.
+ */
+void Vehicle::Arrive()
+{
+    if(this->depart_time.IsNegative() || this->arrived)
+        return;
+    this->arrived = true;
+    Metrics::Instance().Increment(Metrics::Trips_Completed);
+    Metrics::Instance().Add(Metrics::Travel_Time_S, (Simulator::Now() - this->depart_time).GetSeconds());
+    EventDigest::Instance().Record(EventDigest::Arrival, Simulator::Now().GetMicroSeconds(), this->GetID(),
+                                   (Simulator::Now() - this->depart_time).GetMilliSeconds());
+    if(this->HasTarget())
+        Metrics::Instance().Increment(Metrics::Negotiations_Abandoned);
+    this->RemoveNegotiationTimer();
+    this->negotiation_state = Negotiation_Done;
+}
+
+/**
+ * Get the lane this vehicle is currently moving towards.
+ * @return Index of the target lane or -1 if there is none.
+ */
+int Vehicle::GetTarget()
+{
+    return this->target_lane;
+}
+
+/**
+ * Get the lane the vehicle was within when it last asked its application to change lane.
+ * @return Index of the lane or -1 if the application has not been asked for the current target.
+ */
+int Vehicle::GetPreviousLane()
+{
+    return this->previous_lane;
+}
+
+/**
+ * Set the lane the vehicle was within when it last asked its application to change lane. Setting this to -1 causes the
+ * application to be asked again upon the next step.
+ * @param Lane_Index Index of the lane.
+ */
+void Vehicle::SetPreviousLane(int Lane_Index)
+{
+    this->previous_lane = Lane_Index;
+}
+
+/**
+ * Set whether this process owns the vehicle and whether it is simulated by this process at all.
+ * @param Owned Whether this process may begin negotiations on behalf of the vehicle.
+ * @param Visible Whether the vehicle is positioned within the network of this process.
+ */
+void Vehicle::SetOwnership(bool Owned, bool Visible)
+{
+    this->owned = Owned;
+    this->visible = Visible;
+}
+
+/**
+ * Determine if this process may begin negotiations on behalf of the vehicle.
+ * @return True if this process owns the vehicle.
+ */
+bool Vehicle::IsOwned()
+{
+    return this->owned;
+}
+
+/**
+ * Determine if the vehicle is positioned within the network of this process.
+ * @return True if the vehicle is visible to this process.
+ */
+bool Vehicle::IsVisible()
+{
+    return this->visible;
+}
+
+/**
+ * Set the application installed upon the vehicle, which is kept so that it need not be looked up on the node whenever
+ * the vehicle asks it to change lane. The node owns the application.
+ * @param Application Application installed upon the vehicle.
+ */
+void Vehicle::SetApplication(VehicleApplication* Application)
+{
+    this->application = Application;
+}
+
+/**
+ * Get the application installed upon the vehicle.
+ * @return Application installed upon the vehicle, or null if none has been installed.
+ */
+VehicleApplication* Vehicle::GetApplication()
+{
+    return this->application;
+}
+
 /**
  * Get the current state of this vehicle as a string.
  * @return Current state of this vehicle as a string.
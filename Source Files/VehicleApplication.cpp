@@ -1,10 +1,41 @@
 #include "../Header Files/VehicleApplication.h"
+#include <cstring>
 #include <algorithm>
 #include <ns3/ipv4.h>
 #include <ns3/core-module.h>
+#include "../Header Files/Profiler.h"
+#include "../Header Files/EventDigest.h"
+#include "../Header Files/PacketTrace.h"
 
 using namespace ns3;
 
+namespace
+{
+    /**
+     * Find the entry of a list ordered by address belonging to the given address, or the entry it would precede.
+     */
+    template<typename T>
+    typename std::vector<std::pair<Address, T>>::iterator FindAddress(std::vector<std::pair<Address, T>>& List,
+                                                                     const Address& Key)
+    {
+        return std::lower_bound(List.begin(), List.end(), Key, [](const std::pair<Address, T>& Entry, const Address& A)
+                                {
+                                    return Entry.first < A;
+                                });
+    }
+
+    /**
+     * Insert an entry into a list ordered by address unless the address is already present, as std::map::insert does.
+     */
+    template<typename T>
+    void InsertAddress(std::vector<std::pair<Address, T>>& List, const Address& Key, const T& Value)
+    {
+        auto position = FindAddress(List, Key);
+        if(position == List.end() || Key < position->first)
+            List.insert(position, std::pair<Address, T>(Key, Value));
+    }
+}
+
 /**
  * Start the application. This will where any initialisation takes place.
  */
@@ -36,63 +67,282 @@ void VehicleApplication::ChangeLane(int Lane_Index) { }
 void VehicleApplication::RunAlgorithm(int Lane_Index) { }
 
 /**
- * Construct and send a packet to a either a specified recipient or all vehicles within the communication range.
+ * Construct and send a packet to a either a specified recipient or all vehicles within the communication range. The
+ * message is built within a buffer kept by the application so that, once it has grown, only the packet is allocated.
+ * With the network abstraction the content is instead copied into a message buffer of the recipient, see
+ * DeliverMessage, so that only the event delivering it is allocated.
  * @param Action The action recipients must carryout upon them receiving the packet.
  * @param Content Content of the packet containing instructions or information.
  * @param Recipient If the packet is to be sent to an individual vehicle then the address can be specified.
  */
-void VehicleApplication::Send(Context Action, std::string Content, Address Recipient)
+void VehicleApplication::Send(Context Action, const std::string& Content, Address Recipient)
 {
-    char buffer[Content.size() + 16];
-    std::string action_name = Action == Get ? "Get" : Action == Response ? "Response" : "Command";
-    std::sprintf(buffer, "%s/%s", action_name.c_str(), Content.c_str());
-    std::string message = std::string(buffer);
-    Ptr<Packet> packet = Create<Packet>((uint8_t*)message.c_str(), message.size() + 1);
-    if(Action == Get)
+    this->send_buffer.assign(Action == Get ? "Get" : Action == Response ? "Response" : "Command");
+    this->send_buffer.append(1, '/').append(Content);
+    uint32_t size = (uint32_t)this->send_buffer.size() + 1;
+    Profiler::Instance().Increment(Action == Get ? Profiler::Get_Sent :
+                                   Action == Response ? Profiler::Response_Sent : Profiler::Command_Sent);
+    EventDigest::Instance().Record(EventDigest::Packet_Sent, Simulator::Now().GetMicroSeconds(), this->GetVehicleID(),
+                                   Action);
+    PacketTrace::Instance().Record(PacketTrace::Application_Sent, Simulator::Now().GetNanoSeconds(),
+                                   this->GetNode()->GetId(), Action, size);
+    if(this->network_abstraction && this->network_abstraction->IsEnabled())
     {
+        // Requests are answered by Request itself, therefore only messages to an individual vehicle remain.
+        Ptr<VehicleApplication> recipient = this->network_abstraction->GetApplication(Recipient);
+        if(Action == Get || !recipient)
+            return;
+        double distance = this->network_abstraction->GetDistance(this->GetNode(), recipient->GetNode());
+        if(this->network_abstraction->IsDelivered(distance))
+        {
+            size_t slot;
+            recipient->BeginMessage(slot).assign(Content);
+            Simulator::Schedule(this->network_abstraction->GetLatency(distance) / 2,
+                                &VehicleApplication::DeliverMessage, recipient, Action, slot, this->local_address);
+        }
+        return;
+    }
+    Ptr<Packet> packet = Create<Packet>((const uint8_t*)this->send_buffer.c_str(), size);
+    if(Action == Get)
         this->socket->Send(packet);
+    else
+        this->socket->SendTo(packet, 0, Recipient);
+}
+
+/**
+ * Get a message buffer kept by the application, empty and reserved until released, for content that is to be sent
+ * later. Buffers are reused from one message to the next so that, once as many have grown as are ever pending at once,
+ * preparing a message allocates nothing.
+ * @param Slot Index of the buffer, to be handed to ScheduleMessage or ReleaseMessage.
+ * @return The buffer.
+ */
+std::string& VehicleApplication::BeginMessage(size_t& Slot)
+{
+    if(this->free_messages.empty())
+    {
+        Slot = this->messages.size();
+        this->messages.emplace_back();
+        this->free_messages.reserve(this->messages.size());
     }
     else
     {
-        this->socket->SendTo(packet, 0, Recipient);
+        Slot = this->free_messages.back();
+        this->free_messages.pop_back();
     }
+    this->messages[Slot].clear();
+    return this->messages[Slot];
+}
+
+/**
+ * Return a message buffer to the application to be reused, keeping the memory it has grown to.
+ * @param Slot Index of the buffer.
+ */
+void VehicleApplication::ReleaseMessage(size_t Slot)
+{
+    this->free_messages.push_back(Slot);
+}
+
+/**
+ * Send the content of a message buffer once the delay has passed, releasing the buffer once sent. Only the event
+ * itself is allocated, the content staying within the buffer rather than being copied into the event.
+ * @param Delay Time until the message is sent.
+ * @param Action The action recipients must carryout upon them receiving the packet.
+ * @param Slot Index of the buffer holding the content, see BeginMessage.
+ * @param Recipient If the packet is to be sent to an individual vehicle then the address can be specified.
+ */
+void VehicleApplication::ScheduleMessage(Time Delay, Context Action, size_t Slot, Address Recipient)
+{
+    Simulator::Schedule(Delay, &VehicleApplication::SendMessage, this, Action, Slot, Recipient);
+}
+
+/**
+ * Send the content of a message buffer and release the buffer.
+ * @param Action The action recipients must carryout upon them receiving the packet.
+ * @param Slot Index of the buffer holding the content.
+ * @param Recipient If the packet is to be sent to an individual vehicle then the address can be specified.
+ */
+void VehicleApplication::SendMessage(Context Action, size_t Slot, Address Recipient)
+{
+    this->Send(Action, this->messages[Slot], Recipient);
+    this->ReleaseMessage(Slot);
+}
+
+/**
+ * Handle a message delivered by the network abstraction, its content having been copied into a message buffer of this
+ * application by the sender. The content is swapped into the buffer packets are read into, as handling it may prepare
+ * further messages, and the buffer released.
+ * @param Action Context of the message.
+ * @param Slot Index of the buffer holding the content.
+ * @param From Address of the sender.
+ */
+void VehicleApplication::DeliverMessage(Context Action, size_t Slot, Address From)
+{
+    this->receive_content.swap(this->messages[Slot]);
+    this->ReleaseMessage(Slot);
+    this->Handle(Action, this->receive_content, From);
 }
 
 /**
- * Read the packet to determine the Context and Content of it.
+ * Read the packet to determine the Context and Content of it. The packet is copied into a buffer kept by the
+ * application and its content appended directly from there.
  * @param Packet Network packet received by the network device.
  * @param Content Buffer which the content can be appended to.
  * @return Context of the packet.
  */
 Context VehicleApplication::Read(Ptr<Packet> Packet, std::string& Content)
 {
+    uint32_t size = Packet->GetSize();
+    if(this->receive_buffer.size() < size + 1)
+        this->receive_buffer.resize(size + 1);
+    Packet->CopyData(this->receive_buffer.data(), size);
+    this->receive_buffer[size] = 0;
+    const char* payload = (const char*)this->receive_buffer.data();
+    size_t length = std::strlen(payload);
     Context result = Get;
-    uint8_t buffer[Packet->GetSize()];
-    Packet->CopyData(buffer, Packet->GetSize());
-    std::string payload = std::string((char*)buffer);
-    if(payload.compare(0, 3, "Get") == 0)
+    size_t offset = 0;
+    if(std::strncmp(payload, "Get", 3) == 0)
     {
         result = Get;
-        Content.append(payload.substr(4, payload.back()));
+        offset = 4;
     }
-    else if(payload.compare(0, 8, "Response") == 0)
+    else if(std::strncmp(payload, "Response", 8) == 0)
     {
         result = Response;
-        Content.append(payload.substr(9, payload.size() - 9));
+        offset = 9;
     }
-    else if(payload.compare(0, 7, "Command") == 0)
+    else if(std::strncmp(payload, "Command", 7) == 0)
     {
         result = Command;
-        Content.append(payload.substr(8, payload.size() - 8));
+        offset = 8;
     }
+    if(offset > 0 && offset <= length)
+        Content.append(payload + offset, length - offset);
     return result;
 }
 
 /**
- * This is the function that is called upon every time the network device receives a packet.
+ * This is the function that is called upon every time the network device receives a packet. Each packet received is
+ * handed to Handle, its content read into a buffer kept by the application.
+ * @param Socket The socket which was targeted by the sender.
+ */
+void VehicleApplication::Receive(Ptr<Socket> Socket)
+{
+    Profiler::Scope scope(Profiler::Packet_Processing);
+    Context action;
+    std::string& content = this->receive_content;
+    Address from;
+    while(this->ReadNext(Socket, action, content, from))
+        this->Handle(action, content, from);
+}
+
+/**
+ * Read the next packet waiting upon the socket, tallying it and recording it to the animation trace.
  * @param Socket The socket which was targeted by the sender.
+ * @param Action Context of the packet.
+ * @param Content Buffer the content of the packet is written to.
+ * @param From Address of the sender.
+ * @return True if a packet was read, false if none remain.
  */
-void VehicleApplication::Receive(Ptr<Socket> Socket) { }
+bool VehicleApplication::ReadNext(Ptr<Socket> Socket, Context& Action, std::string& Content, Address& From)
+{
+    Ptr<Packet> packet = Socket->RecvFrom(From);
+    if(!packet)
+        return false;
+    Content.clear();
+    Action = this->Read(packet, Content);
+    Profiler::Instance().Increment(Action == Get ? Profiler::Get_Received :
+                                   Action == Response ? Profiler::Response_Received : Profiler::Command_Received);
+    EventDigest::Instance().Record(EventDigest::Packet_Received, Simulator::Now().GetMicroSeconds(),
+                                   this->GetVehicleID(), Action);
+    PacketTrace::Instance().Record(PacketTrace::Application_Received, Simulator::Now().GetNanoSeconds(),
+                                   this->GetNode()->GetId(), Action, packet->GetSize());
+    if(this->animation_writer)
+    {
+        this->animation_writer->RecordPacket(From, this->GetNode(), Action == Get ? "Get" :
+                                             Action == Response ? "Response" : "Command", Content);
+    }
+    return true;
+}
+
+/**
+ * Determine if a vehicle would respond to a request for information made by this vehicle.
+ * @param Lane_Index Index of the lane this vehicle desires to change to.
+ * @param Attributes Attributes of the vehicle receiving the request.
+ * @return True if the vehicle would respond.
+ */
+bool VehicleApplication::IsRespondent(int Lane_Index, const VehicleAttributes& Attributes)
+{
+    return false;
+}
+
+/**
+ * Request information from the vehicles within communication range that may be of assistance and run the algorithm
+ * once they have had time to respond. With the network abstraction the responses are gathered directly from the
+ * neighbours of the vehicle instead of being exchanged as packets.
+ * @param Content Content of the request.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ */
+void VehicleApplication::Request(const std::string& Content, int Lane_Index)
+{
+    this->responses.clear();
+    this->response_times.clear();
+    this->request_time = Simulator::Now();
+    this->vehicle->BeginRequest();
+    EventDigest::Instance().Record(EventDigest::Request, Simulator::Now().GetMicroSeconds(), this->GetVehicleID(),
+                                   Lane_Index);
+    if(this->network_abstraction && this->network_abstraction->IsEnabled())
+    {
+        Profiler::Instance().Increment(Profiler::Get_Sent);
+        EventDigest::Instance().Record(EventDigest::Packet_Sent, Simulator::Now().GetMicroSeconds(),
+                                       this->GetVehicleID(), Get);
+        for(const auto& neighbour : this->network_abstraction->GetNeighbours(this->GetNode()))
+        {
+            const VehicleAttributes& attributes = *neighbour.Application->GetVehicleAttributes();
+            if(this->IsRespondent(Lane_Index, attributes) && this->network_abstraction->IsDelivered(neighbour.Distance))
+                InsertAddress(this->responses, neighbour.Neighbour_Address, attributes);
+        }
+    }
+    else
+    {
+        size_t slot;
+        this->BeginMessage(slot).assign(Content);
+        this->ScheduleMessage(this->GetTransmissionDelay(), Get, slot, Ipv4Address::GetZero());
+    }
+    Simulator::Schedule(MilliSeconds(100), &VehicleApplication::EndRequest, this, Lane_Index);
+}
+
+/**
+ * Conclude a request for information by running the algorithm upon the responses received. When the network
+ * abstraction is observing, the outcome of the exchange with each vehicle that would have responded is recorded first.
+ * @param Lane_Index Index of the lane the vehicle desires to change to.
+ */
+void VehicleApplication::EndRequest(int Lane_Index)
+{
+    if(this->network_abstraction && this->network_abstraction->IsObserving())
+    {
+        for(const auto& neighbour : this->network_abstraction->GetNeighbours(this->GetNode()))
+        {
+            if(!this->IsRespondent(Lane_Index, *neighbour.Application->GetVehicleAttributes()))
+                continue;
+            auto response = FindAddress(this->response_times, neighbour.Neighbour_Address);
+            bool delivered = response != this->response_times.end() && !(neighbour.Neighbour_Address < response->first);
+            this->network_abstraction->Observe(neighbour.Distance, delivered,
+                                               delivered ? response->second - this->request_time : Seconds(0));
+        }
+    }
+    this->RunAlgorithm(Lane_Index);
+}
+
+/**
+ * Record a response to a request for information.
+ * @param From Address of the responding vehicle.
+ * @param Attributes Attributes of the responding vehicle.
+ */
+void VehicleApplication::AddResponse(const Address& From, const VehicleAttributes& Attributes)
+{
+    InsertAddress(this->responses, From, Attributes);
+    InsertAddress(this->response_times, From, Simulator::Now());
+}
 
 /**
  * Get the partner in the lane desired by this vehicle. Partner can be defined as the vehicle whose position and speed
@@ -103,30 +353,16 @@ void VehicleApplication::Receive(Ptr<Socket> Socket) { }
 bool VehicleApplication::GetPartner(std::pair<Address, VehicleAttributes>& Partner)
 {
     bool result = false;
-    if(!this->responses.empty())
+    double position_x = this->GetVehicleAttributes()->Position.x;
+    for(const auto& pair : this->responses)
     {
-        double position_x = this->GetVehicleAttributes()->Position.x;
-        std::map<Address, VehicleAttributes> nearby_or_behind;
-        for(const auto& pair : this->responses)
-        {
-            if((pair.second.Position.x + (2 * pair.second.Length)) < position_x)
-            {
-                nearby_or_behind.insert(std::pair<Address, VehicleAttributes>(pair.first, pair.second));
-            }
-        }
-        if(!nearby_or_behind.empty())
+        // Of the vehicles nearby or behind the nearest is the partner, ties going to the last in address order.
+        if((pair.second.Position.x + (2 * pair.second.Length)) >= position_x)
+            continue;
+        if(!result || abs((int)(pair.second.Position.x - position_x)) <=
+                      abs((int)(Partner.second.Position.x - position_x)))
         {
-            Partner.first = nearby_or_behind.begin()->first;
-            Partner.second = nearby_or_behind.begin()->second;
-            for(const auto& pair : nearby_or_behind)
-            {
-                if(abs((int)(pair.second.Position.x - position_x)) <=
-                   abs((int)(Partner.second.Position.x - position_x)))
-                {
-                    Partner.first = pair.first;
-                    Partner.second = pair.second;
-                }
-            }
+            Partner = pair;
             result = true;
         }
     }
@@ -140,7 +376,7 @@ bool VehicleApplication::GetPartner(std::pair<Address, VehicleAttributes>& Partn
  */
 bool VehicleApplication::IsPresent()
 {
-    std::vector<std::string> id_list = this->GetClient()->vehicle.getIDList();
+    std::vector<std::string> id_list = this->GetClient()->GetVehicleIDList();
     return std::find(id_list.begin(), id_list.end(), this->GetVehicleID()) != id_list.end();
 }
 
@@ -155,13 +391,22 @@ Ptr<Socket> VehicleApplication::GetSocket()
 
 /**
  * Get the responses obtained after sending a request to get information from vehicles that maybe of assistance.
- * @return Map of responses collected.
+ * @return Responses collected, in the order of the address of the responding vehicle.
  */
-std::map<Address, VehicleAttributes>& VehicleApplication::GetResponses()
+ResponseList& VehicleApplication::GetResponses()
 {
     return this->responses;
 }
 
+/**
+ * Get the buffer the content of each packet received is read into, kept so that reading does not allocate.
+ * @return Buffer the content of received packets is read into.
+ */
+std::string& VehicleApplication::GetReceiveContent()
+{
+    return this->receive_content;
+}
+
 /**
  * Get the vehicle associated with this application.
  * @return Vehicle associated with this application.
@@ -216,7 +461,38 @@ void VehicleApplication::Install(std::shared_ptr<Vehicle> Vehicle, std::shared_p
 {
     this->vehicle = Vehicle;
     this->client = Client;
+    if(this->network_abstraction)
+        this->local_address = this->network_abstraction->Register(this);
     this->SetStartTime(Seconds(0));
     this->vehicle->GetNode()->AddApplication(this);
+    this->vehicle->SetApplication(this);
 }
 
+
+/**
+ * Set the network abstraction used in place of, or to observe, the network. Must be set before the application is
+ * installed.
+ * @param Network_Abstraction Network abstraction shared by every application.
+ */
+void VehicleApplication::SetNetworkAbstraction(std::shared_ptr<NetworkAbstraction> Network_Abstraction)
+{
+    this->network_abstraction = Network_Abstraction;
+}
+
+/**
+ * Set the animation trace packets received by this application are recorded to.
+ * @param Animation_Writer Animation trace shared by every application.
+ */
+void VehicleApplication::SetAnimationWriter(std::shared_ptr<AnimationWriter> Animation_Writer)
+{
+    this->animation_writer = Animation_Writer;
+}
+
+/**
+ * Get the number of responses the application has room for, which is kept from one request to the next.
+ * @return Number of responses there is room for.
+ */
+size_t VehicleApplication::GetResponseCapacity()
+{
+    return this->responses.capacity();
+}
@@ -1,4 +1,8 @@
 #include "../Header Files/VehicleAttributes.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 
 /**
  * Construct a new struct that will hold all of the needed attributes to make this simulation function.
@@ -25,95 +29,106 @@ VehicleAttributes::VehicleAttributes(double Speed, libsumo::TraCIPosition Positi
 }
 
 /**
- * Update all attributes contained within this struct with results obtained via a subscription.
+ * Update the attributes contained within this struct with results obtained via a subscription, in a single pass over
+ * the results. Attributes that were not subscribed to keep their value.
  * @param Results Container of results requested in the subscription.
  */
-void VehicleAttributes::Update(TraCIAPI::TraCIValues Results)
+void VehicleAttributes::Update(const TraCIAPI::TraCIValues& Results)
 {
-    this->Speed = Results.at(this->Attribute_Names.at(0)).scalar;
-    this->Position = Results.at(this->Attribute_Names.at(1)).position;
-    this->Lane_Index = (int)Results.at(this->Attribute_Names.at(2)).scalar;
-    this->Length = Results.at(this->Attribute_Names.at(3)).scalar;
-    this->Max_Speed = Results.at(this->Attribute_Names.at(4)).scalar;
-    this->Acceleration = Results.at(this->Attribute_Names.at(5)).scalar;
-    this->Deceleration = Results.at(this->Attribute_Names.at(6)).scalar;
-    this->Max_Legal_Speed = Results.at(this->Attribute_Names.at(7)).scalar;
+    for(const auto& result : Results)
+    {
+        switch(result.first)
+        {
+            case VAR_SPEED: this->Speed = result.second.scalar; break;
+            case VAR_POSITION: this->Position = result.second.position; break;
+            case VAR_LANE_INDEX: this->Lane_Index = (int)result.second.scalar; break;
+            case VAR_LENGTH: this->Length = result.second.scalar; break;
+            case VAR_MAXSPEED: this->Max_Speed = result.second.scalar; break;
+            case VAR_ACCEL: this->Acceleration = result.second.scalar; break;
+            case VAR_DECEL: this->Deceleration = result.second.scalar; break;
+            case VAR_ALLOWED_SPEED: this->Max_Legal_Speed = result.second.scalar; break;
+            default: break;
+        }
+    }
 }
 
 /**
- * Serialise the attributes stored within the supplied instance of VehicleAttributes
+ * Get the TraCI variables to subscribe to for the given fields.
+ * @param Fields Fields to be subscribed to.
+ * @return Identifiers of the TraCI variables in the order of the fields.
+ */
+std::vector<int> VehicleAttributes::GetVariables(uint32_t Fields)
+{
+    const int variables[] = {VAR_SPEED, VAR_POSITION, VAR_LANE_INDEX, VAR_LENGTH, VAR_MAXSPEED, VAR_ACCEL, VAR_DECEL,
+                             VAR_ALLOWED_SPEED, VAR_ROAD_ID};
+    std::vector<int> result;
+    for(size_t i = 0; i < sizeof(variables) / sizeof(variables[0]); i++)
+    {
+        if(Fields & (1u << i))
+            result.push_back(variables[i]);
+    }
+    return result;
+}
+
+/**
+ * Serialise the attributes stored within the supplied instance of VehicleAttributes into a buffer kept by the caller,
+ * which once it has grown to hold them is reused without allocating.
  * @param Vehicle_Attributes Struct of attributes to be serialised.
- * @return String of serialised data.
+ * @param Data Buffer the serialised data replaces the content of.
  */
-std::string VehicleAttributes::Serialise(VehicleAttributes Vehicle_Attributes)
+void VehicleAttributes::Serialise(const VehicleAttributes& Vehicle_Attributes, std::string& Data)
 {
     char buffer[256];
-    std::sprintf(buffer, "Speed: %.2f\nX: %.2f\nY: %.2f\nLane Index: %d\n"
-                         "Length: %.2f\nMax Speed: %.2f\nAcceleration: %.2f\n"
-                         "Deceleration: %.2f\nMax Legal Speed: %.2f", Vehicle_Attributes.Speed,
-                 Vehicle_Attributes.Position.x, Vehicle_Attributes.Position.y,
-                 Vehicle_Attributes.Lane_Index, Vehicle_Attributes.Length,
-                 Vehicle_Attributes.Max_Speed, Vehicle_Attributes.Acceleration,
-                 Vehicle_Attributes.Deceleration, Vehicle_Attributes.Max_Legal_Speed);
-    return std::string(buffer);
+    int length = std::snprintf(buffer, sizeof(buffer), "Speed: %.2f\nX: %.2f\nY: %.2f\nLane Index: %d\n"
+                               "Length: %.2f\nMax Speed: %.2f\nAcceleration: %.2f\n"
+                               "Deceleration: %.2f\nMax Legal Speed: %.2f", Vehicle_Attributes.Speed,
+                               Vehicle_Attributes.Position.x, Vehicle_Attributes.Position.y,
+                               Vehicle_Attributes.Lane_Index, Vehicle_Attributes.Length,
+                               Vehicle_Attributes.Max_Speed, Vehicle_Attributes.Acceleration,
+                               Vehicle_Attributes.Deceleration, Vehicle_Attributes.Max_Legal_Speed);
+    Data.assign(buffer, length < 0 ? 0 : std::min((size_t)length, sizeof(buffer) - 1));
 }
 
 /**
- * Deserialise a string of attribute data into a VehicleAttributes instance.
+ * Deserialise a string of attribute data into a VehicleAttributes instance. The values are parsed in place, line by
+ * line, without copying the data.
  * @param Data Serialised string of attributes.
  * @return Instance of serialised data deserialised into a vehicle attributes instance.
  */
-VehicleAttributes VehicleAttributes::Deserialise(std::string Data)
+VehicleAttributes VehicleAttributes::Deserialise(const std::string& Data)
 {
-    std::stringstream stream(Data);
-    double speed = 0;
-    libsumo::TraCIPosition position = libsumo::TraCIPosition();
-    int lane_index = 0;
-    double length = 0;
-    double max_speed = 0;
-    double acceleration = 0;
-    double deceleration = 0;
-    double max_legal_speed = 0;
-    for(std::string line; std::getline(stream, line);)
+    VehicleAttributes attributes;
+    const char* line = Data.c_str();
+    const char* end = line + Data.size();
+    while(line < end)
     {
-        if(line.compare(0, 5, "Speed") == 0)
+        const char* line_end = std::find(line, end, '\n');
+        size_t length = (size_t)(line_end - line);
+        auto value = [line, length](size_t Offset)
         {
-            speed = std::stod(line.substr(7, line.back()));
-        }
-        else if(line.compare(0, 1, "X") == 0)
-        {
-            position.x = std::stod(line.substr(3, line.back()));
-        }
-        else if(line.compare(0, 1, "Y") == 0)
-        {
-            position.y = std::stod(line.substr(3, line.back()));
-        }
-        else if(line.compare(0, 10, "Lane Index") == 0)
-        {
-            lane_index = std::stoi(line.substr(12, line.back()));
-        }
-        else if(line.compare(0, 6, "Length") == 0)
-        {
-            length = std::stod(line.substr(8, line.back()));
-        }
-        else if(line.compare(0, 9, "Max Speed") == 0)
-        {
-            max_speed = std::stod(line.substr(11, line.back()));
-        }
-        else if(line.compare(0, 12, "Acceleration") == 0)
-        {
-            acceleration = std::stod(line.substr(14, line.back()));
-        }
-        else if(line.compare(0, 12, "Deceleration") == 0)
-        {
-            deceleration = std::stod(line.substr(14, line.back()));
-        }
-        else if(line.compare(0, 15, "Max Legal Speed") == 0)
-        {
-            max_legal_speed = std::stod(line.substr(17, line.back()));
-        }
+            return length > Offset ? std::strtod(line + Offset, nullptr) : 0.0;
+        };
+        if(std::strncmp(line, "Speed", 5) == 0)
+            attributes.Speed = value(7);
+        else if(line[0] == 'X')
+            attributes.Position.x = value(3);
+        else if(line[0] == 'Y')
+            attributes.Position.y = value(3);
+        else if(std::strncmp(line, "Lane Index", 10) == 0)
+            attributes.Lane_Index = length > 12 ? (int)std::strtol(line + 12, nullptr, 10) : 0;
+        else if(std::strncmp(line, "Length", 6) == 0)
+            attributes.Length = value(8);
+        else if(std::strncmp(line, "Max Speed", 9) == 0)
+            attributes.Max_Speed = value(11);
+        else if(std::strncmp(line, "Acceleration", 12) == 0)
+            attributes.Acceleration = value(14);
+        else if(std::strncmp(line, "Deceleration", 12) == 0)
+            attributes.Deceleration = value(14);
+        else if(std::strncmp(line, "Max Legal Speed", 15) == 0)
+            attributes.Max_Legal_Speed = value(17);
+        line = line_end + 1;
     }
-    return VehicleAttributes(speed, position, lane_index, length, max_speed, acceleration, deceleration, max_legal_speed);
+    return attributes;
 }
 
 /**
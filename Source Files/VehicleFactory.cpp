@@ -1,4 +1,7 @@
 #include "../Header Files/VehicleFactory.h"
+#include "../Header Files/MemoryReport.h"
+#include "../Header Files/PacketTrace.h"
+#include "../Header Files/CachedPropagationLossModel.h"
 
 using namespace ns3;
 
@@ -13,9 +16,8 @@ VehicleFactory::VehicleFactory(std::string Address_Base, std::string Subnet_Mask
     this->address_base = Address_Base;
     this->subnet_mask = Subnet_Mask;
     this->address_helper.SetBase(this->address_base.c_str(), this->subnet_mask.c_str());
-    this->channel_helper = YansWifiChannelHelper::Default();
     this->physical_helper = YansWavePhyHelper::Default();
-    this->physical_helper.SetChannel(this->channel_helper.Create());
+    this->SetLegacyPropagation(false);
     this->mac_helper = NqosWaveMacHelper::Default();
     this->wifi_helper = Wifi80211pHelper::Default();
     this->wifi_helper.SetRemoteStationManager("ns3::ConstantRateWifiManager",
@@ -25,18 +27,53 @@ VehicleFactory::VehicleFactory(std::string Address_Base, std::string Subnet_Mask
 }
 
 /**
- * Construct a new vehicle with the next available IP address and the provided unique identifier.
+ * Construct a new vehicle with the next available IP address and the provided unique identifier. The heap consumed by
+ * each component of the vehicle is attributed to it within the memory report, if enabled, and its devices are traced
+ * if it is sampled by the packet trace.
  * @param ID Unique identifier used to interact with SUMO/TraCI.
  * @return Newly constructed vehicle inside a unique ptr.
  */
 std::shared_ptr<Vehicle> VehicleFactory::CreateVehicle(std::string ID)
 {
+    MemoryReport& memory_report = MemoryReport::Instance();
+    uint64_t mark = memory_report.Mark();
     Ptr<Node> node = CreateObject<Node>();
+    mark = memory_report.Attribute(MemoryReport::Node, mark);
     this->mobility_helper.Install(node);
     node->GetObject<WaypointMobilityModel>()->AddWaypoint(Waypoint(Seconds(0), this->initial_position));
+    mark = memory_report.Attribute(MemoryReport::Mobility, mark);
     NetDeviceContainer devices = this->wifi_helper.Install(this->physical_helper, this->mac_helper, node);
+    PacketTrace::Instance().Attach(node, devices);
+    mark = memory_report.Attribute(MemoryReport::Devices, mark);
     std::shared_ptr<VehicleAttributes> attributes = std::make_shared<VehicleAttributes>();
+    mark = memory_report.Attribute(MemoryReport::Attributes, mark);
     this->stack_helper.Install(node);
+    mark = memory_report.Attribute(MemoryReport::Internet_Stack, mark);
     this->address_helper.Assign(devices);
-    return std::make_shared<Vehicle>(node, devices, attributes, ID);
+    mark = memory_report.Attribute(MemoryReport::Addresses, mark);
+    std::shared_ptr<Vehicle> vehicle = std::make_shared<Vehicle>(node, devices, attributes, ID);
+    memory_report.Attribute(MemoryReport::Vehicle_Object, mark);
+    memory_report.AddVehicle();
+    return vehicle;
+}
+
+/**
+ * Select the propagation loss model of the channel shared by every vehicle. By default the losses are computed by the
+ * CachedLogDistancePropagationLossModel, which gives the same received power as the stock log-distance model of
+ * YansWifiChannelHelper::Default. Must be called before the first vehicle is constructed.
+ * @param Legacy_Propagation True if the stock model should be used instead.
+ */
+void VehicleFactory::SetLegacyPropagation(bool Legacy_Propagation)
+{
+    if(Legacy_Propagation)
+    {
+        this->channel_helper = YansWifiChannelHelper::Default();
+    }
+    else
+    {
+        this->channel_helper = YansWifiChannelHelper();
+        this->channel_helper.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+        this->channel_helper.AddPropagationLoss(CachedLogDistancePropagationLossModel::GetTypeId().GetName());
+    }
+    this->physical_helper.SetChannel(this->channel_helper.Create());
 }
@@ -0,0 +1,109 @@
+#include "../Header Files/WorkerPool.h"
+#include <algorithm>
+
+namespace
+{
+    const size_t Minimum_Slice = 256;
+}
+
+/**
+ * Start the threads of the pool.
+ * @param Threads Number of threads work is spread across including the calling thread, 0 for one per core.
+ */
+WorkerPool::WorkerPool(unsigned int Threads)
+{
+    if(Threads == 0)
+        Threads = std::max(1u, std::thread::hardware_concurrency());
+    for(unsigned int i = 1; i < Threads; i++)
+        this->workers.emplace_back(&WorkerPool::Work, this, (size_t)i);
+}
+
+/**
+ * Stop the threads of the pool and wait for them to exit.
+ */
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->start_condition.notify_all();
+    for(auto& worker : this->workers)
+        worker.join();
+}
+
+/**
+ * Carry out the task for every index from 0 to Count and wait for it to complete.
+ * @param Count Number of indices.
+ * @param Task Task carried out for each index, possibly concurrently with the others.
+ */
+void WorkerPool::Run(size_t Count, const std::function<void(size_t)>& Task)
+{
+    size_t slices = std::min<size_t>(this->workers.size() + 1, Count / Minimum_Slice);
+    if(slices <= 1)
+    {
+        for(size_t i = 0; i < Count; i++)
+            Task(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &Task;
+        this->count = Count;
+        this->slices = slices;
+        this->remaining = this->workers.size();
+        this->generation++;
+    }
+    this->start_condition.notify_all();
+    this->RunSlice(0);
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->done_condition.wait(lock, [this]() { return this->remaining == 0; });
+    this->task = nullptr;
+}
+
+/**
+ * Get the number of threads work is spread across including the calling thread.
+ * @return Number of threads.
+ */
+unsigned int WorkerPool::GetSize()
+{
+    return (unsigned int)this->workers.size() + 1;
+}
+
+/**
+ * Wait for work and carry out this thread's slice of it until the pool is stopped.
+ * @param Slice Slice of the work carried out by this thread.
+ */
+void WorkerPool::Work(size_t Slice)
+{
+    uint64_t seen = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->start_condition.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+            if(this->stopping)
+                return;
+            seen = this->generation;
+        }
+        this->RunSlice(Slice);
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if(--this->remaining == 0)
+            this->done_condition.notify_one();
+    }
+}
+
+/**
+ * Carry out the task for every index within a slice of the work. Slices beyond those the work was divided into are
+ * empty.
+ * @param Slice Slice of the work.
+ */
+void WorkerPool::RunSlice(size_t Slice)
+{
+    if(Slice >= this->slices)
+        return;
+    size_t begin = this->count * Slice / this->slices;
+    size_t end = this->count * (Slice + 1) / this->slices;
+    for(size_t i = begin; i < end; i++)
+        (*this->task)(i);
+}